@@ -4,9 +4,11 @@
 #include "building/properties.h"
 #include "building/rotation.h"
 #include "building/storage.h"
+#include "building/storage_index.h"
 #include "city/buildings.h"
 #include "city/population.h"
 #include "city/warning.h"
+#include "core/slot_bitmap.h"
 #include "figure/formation_legion.h"
 #include "game/resource.h"
 #include "game/undo.h"
@@ -32,11 +34,89 @@ static struct {
     int unfixable_houses;
 } extra = {0, 0, 0, 0};
 
+static uint32_t used_slot_words[SLOT_BITMAP_WORDS(MAX_BUILDINGS)];
+static slot_bitmap used_slots = { used_slot_words, MAX_BUILDINGS, 0 };
+
+static uint32_t house_slot_words[SLOT_BITMAP_WORDS(MAX_BUILDINGS)];
+static slot_bitmap house_slots = { house_slot_words, MAX_BUILDINGS, 0 };
+
+static uint32_t storage_slot_words[SLOT_BITMAP_WORDS(MAX_BUILDINGS)];
+static slot_bitmap storage_slots = { storage_slot_words, MAX_BUILDINGS, 0 };
+
+static void mark_used(const building *b)
+{
+    slot_bitmap_set_used(&used_slots, b->id);
+    // A building never turns into a house or storage building after creation,
+    // so the sublists only need updating when the slot is taken or freed
+    if (b->house_size) {
+        slot_bitmap_set_used(&house_slots, b->id);
+    }
+    if (b->type == BUILDING_GRANARY || b->type == BUILDING_WAREHOUSE) {
+        slot_bitmap_set_used(&storage_slots, b->id);
+    }
+    if (b->type == BUILDING_GRANARY || b->type == BUILDING_WAREHOUSE_SPACE) {
+        building_storage_index_invalidate();
+    }
+}
+
+static void mark_free(int id)
+{
+    if (all_buildings[id].type == BUILDING_GRANARY || all_buildings[id].type == BUILDING_WAREHOUSE_SPACE) {
+        building_storage_index_invalidate();
+    }
+    slot_bitmap_set_free(&used_slots, id);
+    slot_bitmap_set_free(&house_slots, id);
+    slot_bitmap_set_free(&storage_slots, id);
+}
+
+static void clear_slots(void)
+{
+    slot_bitmap_clear(&used_slots);
+    slot_bitmap_clear(&house_slots);
+    slot_bitmap_clear(&storage_slots);
+    building_storage_index_invalidate();
+}
+
+static int get_first_available(void)
+{
+    int id = slot_bitmap_find_free(&used_slots, 1);
+    while (id > 0 && game_undo_contains_building(id)) {
+        id = slot_bitmap_find_free(&used_slots, id + 1);
+    }
+    return id > 0 ? id : 0;
+}
+
+static int next_id(const slot_bitmap *slots, int id)
+{
+    int next = slot_bitmap_find_used(slots, id + 1);
+    return next > 0 ? next : 0;
+}
+
 building *building_get(int id)
 {
     return &all_buildings[id];
 }
 
+int building_next_id(int id)
+{
+    return next_id(&used_slots, id);
+}
+
+int building_next_house_id(int id)
+{
+    return next_id(&house_slots, id);
+}
+
+int building_next_storage_id(int id)
+{
+    return next_id(&storage_slots, id);
+}
+
+void building_mark_restored(building *b)
+{
+    mark_used(b);
+}
+
 int building_find(building_type type)
 {
     for (int i = 1; i < MAX_BUILDINGS; ++i) {
@@ -66,17 +146,12 @@ building *building_next(building *b)
 
 building *building_create(building_type type, int x, int y)
 {
-    building *b = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
-        if (all_buildings[i].state == BUILDING_STATE_UNUSED && !game_undo_contains_building(i)) {
-            b = &all_buildings[i];
-            break;
-        }
-    }
-    if (!b) {
+    int id = get_first_available();
+    if (!id) {
         city_warning_show(WARNING_DATA_LIMIT_REACHED);
         return &all_buildings[0];
     }
+    building *b = &all_buildings[id];
 
     const building_properties *props = building_properties_for_type(type);
 
@@ -102,6 +177,7 @@ building *building_create(building_type type, int x, int y)
     } else if (type >= BUILDING_HOUSE_LARGE_PALACE && type <= BUILDING_HOUSE_LUXURY_PALACE) {
         b->house_size = 4;
     }
+    mark_used(b);
 
     // subtype
     if (building_is_house(type)) {
@@ -194,6 +270,7 @@ static void building_delete(building *b)
 {
     building_clear_related_data(b);
     int id = b->id;
+    mark_free(id);
     memset(b, 0, sizeof(building));
     b->id = id;
 }
@@ -233,7 +310,7 @@ void building_update_state(void)
     int wall_recalc = 0;
     int road_recalc = 0;
     int aqueduct_recalc = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
         building *b = &all_buildings[i];
         if (b->state == BUILDING_STATE_CREATED) {
             b->state = BUILDING_STATE_IN_USE;
@@ -282,7 +359,7 @@ void building_update_state(void)
 
 void building_update_desirability(void)
 {
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
         building *b = &all_buildings[i];
         if (b->state != BUILDING_STATE_IN_USE) {
             continue;
@@ -322,7 +399,7 @@ int building_get_highest_id(void)
 void building_update_highest_id(void)
 {
     extra.highest_id_in_use = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
         if (all_buildings[i].state != BUILDING_STATE_UNUSED) {
             extra.highest_id_in_use = i;
         }
@@ -373,6 +450,7 @@ void building_clear_all(void)
         memset(&all_buildings[i], 0, sizeof(building));
         all_buildings[i].id = i;
     }
+    clear_slots();
     extra.highest_id_in_use = 0;
     extra.highest_id_ever = 0;
     extra.created_sequence = 0;
@@ -398,9 +476,13 @@ void building_save_state(buffer *buf, buffer *highest_id, buffer *highest_id_eve
 void building_load_state(buffer *buf, buffer *highest_id, buffer *highest_id_ever,
                          buffer *sequence, buffer *corrupt_houses)
 {
+    clear_slots();
     for (int i = 0; i < MAX_BUILDINGS; i++) {
         building_state_load_from_buffer(buf, &all_buildings[i]);
         all_buildings[i].id = i;
+        if (all_buildings[i].state != BUILDING_STATE_UNUSED) {
+            mark_used(&all_buildings[i]);
+        }
     }
     extra.highest_id_in_use = buffer_read_i32(highest_id);
     extra.highest_id_ever = buffer_read_i32(highest_id_ever);
@@ -150,6 +150,35 @@ building *building_main(building *b);
 
 building *building_next(building *b);
 
+/**
+ * Returns the next building slot in use, in increasing id order. Loop over all buildings with:
+ * for (int i = building_next_id(0); i; i = building_next_id(i))
+ * The building states still need to be checked, only unused slots are skipped.
+ * @param id Building ID to continue after, 0 to start at the first building
+ * @return ID of the next building slot in use, or 0 if there are no more
+ */
+int building_next_id(int id);
+
+/**
+ * Same as building_next_id(), but only returns buildings that were created as a house
+ * @param id Building ID to continue after, 0 to start at the first house
+ * @return ID of the next house slot, or 0 if there are no more
+ */
+int building_next_house_id(int id);
+
+/**
+ * Same as building_next_id(), but only returns granaries and warehouses
+ * @param id Building ID to continue after, 0 to start at the first storage building
+ * @return ID of the next storage building slot, or 0 if there are no more
+ */
+int building_next_storage_id(int id);
+
+/**
+ * Marks the slot of a building as in use after its data has been copied back by undo
+ * @param b Restored building
+ */
+void building_mark_restored(building *b);
+
 building *building_create(building_type type, int x, int y);
 
 void building_clear_related_data(building *b);
@@ -414,6 +414,7 @@ void building_construction_cancel(void)
     } else {
         building_construction_set_type(BUILDING_NONE);
     }
+    game_undo_cancel_build();
     building_rotation_reset_rotation();
 }
 
@@ -548,21 +549,25 @@ void building_construction_place(void)
     building_type type = data.sub_type ? data.sub_type : data.type;
     building_construction_warning_reset();
     if (!type) {
+        game_undo_cancel_build();
         return;
     }
     if (city_finance_out_of_money()) {
         map_property_clear_constructing_and_deleted();
         city_warning_show(WARNING_OUT_OF_MONEY);
+        game_undo_cancel_build();
         return;
     }
     if (type >= BUILDING_LARGE_TEMPLE_CERES && type <= BUILDING_LARGE_TEMPLE_VENUS && city_resource_count(RESOURCE_MARBLE) < 2) {
         map_property_clear_constructing_and_deleted();
         city_warning_show(WARNING_MARBLE_NEEDED_LARGE_TEMPLE);
+        game_undo_cancel_build();
         return;
     }
     if (type == BUILDING_ORACLE && city_resource_count(RESOURCE_MARBLE) < 2) {
         map_property_clear_constructing_and_deleted();
         city_warning_show(WARNING_MARBLE_NEEDED_ORACLE);
+        game_undo_cancel_build();
         return;
     }
     if (type != BUILDING_CLEAR_LAND && has_nearby_enemy(x_start, y_start, x_end, y_end)) {
@@ -576,6 +581,7 @@ void building_construction_place(void)
             map_property_clear_constructing_and_deleted();
         }
         city_warning_show(WARNING_ENEMY_NEARBY);
+        game_undo_cancel_build();
         return;
     }
 
@@ -604,6 +610,7 @@ void building_construction_place(void)
         int length = map_bridge_add(x_end, y_end, 0);
         if (length <= 1) {
             city_warning_show(WARNING_SHORE_NEEDED);
+            game_undo_cancel_build();
             return;
         }
         placement_cost *= length;
@@ -611,6 +618,7 @@ void building_construction_place(void)
         int length = map_bridge_add(x_end, y_end, 1);
         if (length <= 1) {
             city_warning_show(WARNING_SHORE_NEEDED);
+            game_undo_cancel_build();
             return;
         }
         placement_cost *= length;
@@ -618,6 +626,7 @@ void building_construction_place(void)
         int cost;
         if (!building_construction_place_aqueduct(x_start, y_start, x_end, y_end, &cost)) {
             city_warning_show(WARNING_CLEAR_LAND_NEEDED);
+            game_undo_cancel_build();
             return;
         }
         placement_cost = cost;
@@ -628,6 +637,7 @@ void building_construction_place(void)
         if (!place_reservoir_and_aqueducts(0, x_start, y_start, x_end, y_end, &info)) {
             map_property_clear_constructing_and_deleted();
             city_warning_show(WARNING_CLEAR_LAND_NEEDED);
+            game_undo_cancel_build();
             return;
         }
         if (info.place_reservoir_at_start == PLACE_RESERVOIR_YES) {
@@ -651,6 +661,7 @@ void building_construction_place(void)
     } else if (type == BUILDING_HOUSE_VACANT_LOT) {
         placement_cost *= place_houses(0, x_start, y_start, x_end, y_end);
     } else if (!building_construction_place_building(type, x_end, y_end)) {
+        game_undo_cancel_build();
         return;
     }
     if ((type >= BUILDING_LARGE_TEMPLE_CERES && type <= BUILDING_LARGE_TEMPLE_VENUS) || type == BUILDING_ORACLE) {
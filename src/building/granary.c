@@ -3,6 +3,7 @@
 #include "building/destruction.h"
 #include "building/model.h"
 #include "building/storage.h"
+#include "building/storage_index.h"
 #include "building/warehouse.h"
 #include "city/message.h"
 #include "city/resource.h"
@@ -229,7 +230,7 @@ void building_granaries_calculate_stocks(void)
     non_getting_granaries.total_storage_fruit = 0;
     non_getting_granaries.total_storage_meat = 0;
 
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_storage_id(0); i; i = building_next_storage_id(i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || b->type != BUILDING_GRANARY) {
             continue;
@@ -278,7 +279,10 @@ int building_granary_for_storing(int x, int y, int resource, int distance_from_e
     }
     int min_dist = INFINITE;
     int min_building_id = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    const int *granary_ids;
+    int num_granaries = building_storage_index_get(STORAGE_INDEX_GRANARY, road_network_id, &granary_ids);
+    for (int n = 0; n < num_granaries; n++) {
+        int i = granary_ids[n];
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || b->type != BUILDING_GRANARY) {
             continue;
@@ -334,7 +338,10 @@ int building_getting_granary_for_storing(int x, int y, int resource, int distanc
     }
     int min_dist = INFINITE;
     int min_building_id = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    const int *granary_ids;
+    int num_granaries = building_storage_index_get(STORAGE_INDEX_GRANARY, road_network_id, &granary_ids);
+    for (int n = 0; n < num_granaries; n++) {
+        int i = granary_ids[n];
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || b->type != BUILDING_GRANARY) {
             continue;
@@ -434,7 +441,7 @@ void building_granary_bless(void)
 {
     int min_stored = INFINITE;
     building *min_building = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_storage_id(0); i; i = building_next_storage_id(i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || b->type != BUILDING_GRANARY) {
             continue;
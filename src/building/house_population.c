@@ -58,7 +58,7 @@ int house_population_remove_from_city(int num_people)
 static void fill_building_list_with_houses(void)
 {
     building_list_large_clear(0);
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_house_id(0); i; i = building_next_house_id(i)) {
         building *b = building_get(i);
         if (b->state == BUILDING_STATE_IN_USE && b->house_size) {
             building_list_large_add(i);
@@ -14,7 +14,7 @@ static void decay(unsigned char *value)
 
 void house_service_decay_culture(void)
 {
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_house_id(0); i; i = building_next_house_id(i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || !b->house_size) {
             continue;
@@ -42,7 +42,7 @@ void house_service_decay_culture(void)
 
 void house_service_decay_tax_collector(void)
 {
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
         building *b = building_get(i);
         if (b->state == BUILDING_STATE_IN_USE && b->house_tax_coverage) {
             b->house_tax_coverage--;
@@ -52,7 +52,7 @@ void house_service_decay_tax_collector(void)
 
 void house_service_decay_houses_covered(void)
 {
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_UNUSED && b->type != BUILDING_TOWER) {
             if (b->houses_covered <= 1) {
@@ -67,7 +67,7 @@ void house_service_decay_houses_covered(void)
 void house_service_calculate_culture_aggregates(void)
 {
     int base_entertainment = city_culture_coverage_average_entertainment() / 5;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_house_id(0); i; i = building_next_house_id(i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || !b->house_size) {
             continue;
@@ -3,6 +3,7 @@
 #include "building/building.h"
 #include "building/destruction.h"
 #include "building/list.h"
+#include "building/storage_index.h"
 #include "city/buildings.h"
 #include "city/map.h"
 #include "city/message.h"
@@ -304,6 +305,8 @@ void building_maintenance_check_rome_access(void)
             }
         }
     }
+    // Road networks of storage buildings may have changed
+    building_storage_index_invalidate();
     const map_tile *exit_point = city_map_exit_point();
     if (!map_routing_distance(exit_point->grid_offset)) {
         // no route through city
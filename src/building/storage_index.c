@@ -0,0 +1,70 @@
+#include "storage_index.h"
+
+#include "building/building.h"
+
+#define MAX_ROAD_NETWORKS 256
+
+static struct {
+    int needs_update;
+    int start[STORAGE_INDEX_MAX][MAX_ROAD_NETWORKS + 1];
+    int ids[STORAGE_INDEX_MAX][MAX_BUILDINGS];
+} data = { 1 };
+
+static int index_type(building_type type)
+{
+    switch (type) {
+        case BUILDING_GRANARY:
+            return STORAGE_INDEX_GRANARY;
+        case BUILDING_WAREHOUSE_SPACE:
+            return STORAGE_INDEX_WAREHOUSE_SPACE;
+        default:
+            return -1;
+    }
+}
+
+static void rebuild(void)
+{
+    int count[STORAGE_INDEX_MAX][MAX_ROAD_NETWORKS] = { { 0 } };
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
+        building *b = building_get(i);
+        int type = index_type(b->type);
+        if (type >= 0) {
+            count[type][b->road_network_id]++;
+        }
+    }
+    for (int type = 0; type < STORAGE_INDEX_MAX; type++) {
+        data.start[type][0] = 0;
+        for (int n = 0; n < MAX_ROAD_NETWORKS; n++) {
+            data.start[type][n + 1] = data.start[type][n] + count[type][n];
+            count[type][n] = data.start[type][n];
+        }
+    }
+    // Buildings are visited in increasing ID order, which keeps every bucket sorted
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
+        building *b = building_get(i);
+        int type = index_type(b->type);
+        if (type >= 0) {
+            data.ids[type][count[type][b->road_network_id]++] = i;
+        }
+    }
+    data.needs_update = 0;
+}
+
+void building_storage_index_invalidate(void)
+{
+    data.needs_update = 1;
+}
+
+int building_storage_index_get(storage_index_type type, int road_network_id, const int **ids)
+{
+    if (road_network_id < 0 || road_network_id >= MAX_ROAD_NETWORKS) {
+        *ids = 0;
+        return 0;
+    }
+    if (data.needs_update) {
+        rebuild();
+    }
+    int start = data.start[type][road_network_id];
+    *ids = &data.ids[type][start];
+    return data.start[type][road_network_id + 1] - start;
+}
@@ -0,0 +1,34 @@
+#ifndef BUILDING_STORAGE_INDEX_H
+#define BUILDING_STORAGE_INDEX_H
+
+/**
+ * @file
+ * Granaries and warehouse spaces grouped by road network, so destination lookups
+ * only look at the storage buildings the figure can reach.
+ * The index is rebuilt lazily after storage buildings are added or removed, or after
+ * the road networks of the buildings are reassigned.
+ */
+
+typedef enum {
+    STORAGE_INDEX_GRANARY = 0,
+    STORAGE_INDEX_WAREHOUSE_SPACE = 1,
+    STORAGE_INDEX_MAX = 2
+} storage_index_type;
+
+/**
+ * Marks the index as outdated
+ */
+void building_storage_index_invalidate(void);
+
+/**
+ * Gets the buildings of a type that were last seen on a road network.
+ * The list is in increasing ID order and can contain buildings that are no longer in use,
+ * so callers keep their own state checks.
+ * @param type Type of storage building
+ * @param road_network_id Road network
+ * @param ids Filled with the list of building IDs
+ * @return Number of building IDs in the list
+ */
+int building_storage_index_get(storage_index_type type, int road_network_id, const int **ids);
+
+#endif // BUILDING_STORAGE_INDEX_H
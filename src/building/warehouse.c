@@ -5,6 +5,7 @@
 #include "building/granary.h"
 #include "building/model.h"
 #include "building/storage.h"
+#include "building/storage_index.h"
 #include "city/buildings.h"
 #include "city/finance.h"
 #include "city/military.h"
@@ -337,7 +338,10 @@ int building_warehouse_for_storing(int src_building_id, int x, int y, int resour
 {
     int min_dist = 10000;
     int min_building_id = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    const int *space_ids;
+    int num_spaces = building_storage_index_get(STORAGE_INDEX_WAREHOUSE_SPACE, road_network_id, &space_ids);
+    for (int n = 0; n < num_spaces; n++) {
+        int i = space_ids[n];
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || b->type != BUILDING_WAREHOUSE_SPACE) {
             continue;
@@ -386,7 +390,7 @@ int building_warehouse_for_getting(building *src, int resource, map_point *dst)
 {
     int min_dist = 10000;
     building *min_building = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_storage_id(0); i; i = building_next_storage_id(i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || b->type != BUILDING_WAREHOUSE) {
             continue;
@@ -434,8 +438,10 @@ static int determine_granary_accept_foods(int resources[RESOURCE_MAX_FOOD], int
         resources[i] = 0;
     }
     int can_accept = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
-        building *b = building_get(i);
+    const int *granary_ids;
+    int num_granaries = building_storage_index_get(STORAGE_INDEX_GRANARY, road_network, &granary_ids);
+    for (int n = 0; n < num_granaries; n++) {
+        building *b = building_get(granary_ids[n]);
         if (b->state != BUILDING_STATE_IN_USE || b->type != BUILDING_GRANARY || !b->has_road_access) {
             continue;
         }
@@ -467,8 +473,10 @@ static int determine_granary_get_foods(int resources[RESOURCE_MAX_FOOD], int roa
         resources[i] = 0;
     }
     int can_get = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
-        building *b = building_get(i);
+    const int *granary_ids;
+    int num_granaries = building_storage_index_get(STORAGE_INDEX_GRANARY, road_network, &granary_ids);
+    for (int n = 0; n < num_granaries; n++) {
+        building *b = building_get(granary_ids[n]);
         if (b->state != BUILDING_STATE_IN_USE || b->type != BUILDING_GRANARY || !b->has_road_access) {
             continue;
         }
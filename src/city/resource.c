@@ -171,7 +171,7 @@ void city_resource_calculate_warehouse_stocks(void)
         city_data.resource.space_in_warehouses[i] = 0;
         city_data.resource.stored_in_warehouses[i] = 0;
     }
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_storage_id(0); i; i = building_next_storage_id(i)) {
         building *b = building_get(i);
         if (b->state == BUILDING_STATE_IN_USE && b->type == BUILDING_WAREHOUSE) {
             b->has_road_access = 0;
@@ -240,7 +240,7 @@ static void calculate_available_food(void)
     city_data.resource.granaries.understaffed = 0;
     city_data.resource.granaries.not_operating = 0;
     city_data.resource.granaries.not_operating_with_food = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_storage_id(0); i; i = building_next_storage_id(i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || b->type != BUILDING_GRANARY) {
             continue;
@@ -338,7 +338,7 @@ void city_resource_consume_food(void)
     city_data.resource.food_types_eaten = 0;
     city_data.unused.unknown_00c0 = 0;
     int total_consumed = 0;
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_house_id(0); i; i = building_next_house_id(i)) {
         building *b = building_get(i);
         if (b->state == BUILDING_STATE_IN_USE && b->house_size) {
             int num_types = model_get_house(b->subtype.house_level)->food_types;
@@ -6,8 +6,11 @@
 #include "graphics/menu.h"
 #include "map/grid.h"
 #include "map/image.h"
+#include "widget/city_without_overlay.h"
 #include "widget/minimap.h"
 
+#include <limits.h>
+
 #define TILE_WIDTH_PIXELS 60
 #define TILE_HEIGHT_PIXELS 30
 #define HALF_TILE_WIDTH_PIXELS 30
@@ -161,6 +164,15 @@ void city_view_init(void)
 {
     calculate_lookup();
     city_view_set_scale(100);
+    city_without_overlay_invalidate_cache();
+    widget_minimap_invalidate();
+}
+
+void city_view_refresh(void)
+{
+    calculate_lookup();
+    check_camera_boundaries();
+    city_without_overlay_invalidate_cache();
     widget_minimap_invalidate();
 }
 
@@ -414,6 +426,12 @@ void city_view_set_viewport(int screen_width, int screen_height)
     check_camera_boundaries();
 }
 
+void city_view_set_offscreen_viewport(int width, int height)
+{
+    set_viewport(0, 0, width, height);
+    check_camera_boundaries();
+}
+
 void city_view_get_scaled_viewport(int *x, int *y, int *width, int *height)
 {
     *x = data.viewport.x;
@@ -496,12 +514,17 @@ void city_view_load_scenario_state(buffer *camera)
 }
 
 void city_view_foreach_map_tile(map_callback *callback)
+{
+    city_view_foreach_map_tile_in_rows(INT_MIN, INT_MAX, callback);
+}
+
+void city_view_foreach_map_tile_in_rows(int y_min, int y_max, map_callback *callback)
 {
     int odd = 0;
     int y_view = data.camera.tile.y - 8;
     int y_graphic = data.viewport.y - 9 * HALF_TILE_HEIGHT_PIXELS - data.camera.pixel.y;
     for (int y = 0; y < data.viewport.height_tiles + 21; y++) {
-        if (y_view >= 0 && y_view < VIEW_Y_MAX) {
+        if (y_view >= 0 && y_view < VIEW_Y_MAX && y_graphic >= y_min && y_graphic <= y_max) {
             int x_graphic = -(4 * TILE_WIDTH_PIXELS) - data.camera.pixel.x;
             if (odd) {
                 x_graphic += data.viewport.x - HALF_TILE_WIDTH_PIXELS;
@@ -525,13 +548,19 @@ void city_view_foreach_map_tile(map_callback *callback)
 }
 
 void city_view_foreach_valid_map_tile(map_callback *callback1, map_callback *callback2, map_callback *callback3)
+{
+    city_view_foreach_valid_map_tile_in_rows(INT_MIN, INT_MAX, callback1, callback2, callback3);
+}
+
+void city_view_foreach_valid_map_tile_in_rows(int y_min, int y_max,
+    map_callback *callback1, map_callback *callback2, map_callback *callback3)
 {
     int odd = 0;
     int y_view = data.camera.tile.y - 8;
     int y_graphic = data.viewport.y - 9 * HALF_TILE_HEIGHT_PIXELS - data.camera.pixel.y;
     int x_graphic, x_view;
     for (int y = 0; y < data.viewport.height_tiles + 21; y++) {
-        if (y_view >= 0 && y_view < VIEW_Y_MAX) {
+        if (y_view >= 0 && y_view < VIEW_Y_MAX && y_graphic >= y_min && y_graphic <= y_max) {
             if (callback1) {
                 x_graphic = -(4 * TILE_WIDTH_PIXELS) - data.camera.pixel.x;
                 if (odd) {
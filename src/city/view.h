@@ -16,6 +16,11 @@ typedef void (map_callback)(int x, int y, int grid_offset);
 
 void city_view_init(void);
 
+/**
+ * Recalculates the view after the map changed, keeping the camera and zoom
+ */
+void city_view_refresh(void);
+
 int city_view_orientation(void);
 
 void city_view_reset_orientation(void);
@@ -53,6 +58,14 @@ void city_view_rotate_right(void);
 
 void city_view_set_viewport(int screen_width, int screen_height);
 
+/**
+ * Sets a viewport at the top left of the canvas that does not depend on the screen size,
+ * for drawing the city off-screen. Call city_view_set_viewport to go back to the screen.
+ * @param width Width of the viewport in pixels
+ * @param height Height of the viewport in pixels
+ */
+void city_view_set_offscreen_viewport(int width, int height);
+
 void city_view_get_scaled_viewport(int *x, int *y, int *width, int *height);
 void city_view_get_unscaled_viewport(int *x, int *y, int *width, int *height);
 void city_view_get_viewport_size_tiles(int *width, int *height);
@@ -73,8 +86,21 @@ void city_view_load_scenario_state(buffer *camera);
 
 void city_view_foreach_map_tile(map_callback *callback);
 
+/**
+ * Same as city_view_foreach_map_tile, but only for the rows of tiles
+ * that are drawn at a y position between y_min and y_max, inclusive
+ */
+void city_view_foreach_map_tile_in_rows(int y_min, int y_max, map_callback *callback);
+
 void city_view_foreach_valid_map_tile(map_callback *callback1, map_callback *callback2, map_callback *callback3);
 
+/**
+ * Same as city_view_foreach_valid_map_tile, but only for the rows of tiles
+ * that are drawn at a y position between y_min and y_max, inclusive
+ */
+void city_view_foreach_valid_map_tile_in_rows(int y_min, int y_max,
+    map_callback *callback1, map_callback *callback2, map_callback *callback3);
+
 void city_view_foreach_tile_in_range(int grid_offset, int size, int radius, map_callback *callback);
 
 void city_view_foreach_minimap_tile(int x_offset, int y_offset, int absolute_x, int absolute_y, int width_tiles, int height_tiles, map_callback *callback);
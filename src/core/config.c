@@ -26,6 +26,7 @@ static const char *ini_keys[] = {
     "ui_complete_ratings_columns",
     "ui_highlight_legions",
     "ui_rotate_manually",
+    "ui_city_render_threads",
     "gameplay_change_grandfestival",
     "gameplay_change_jealous_gods",
     "gameplay_change_global_labour",
@@ -48,6 +49,7 @@ static const char *ini_keys[] = {
     "gameplay_change_random_mine_or_pit_collapses_take_money",
     "gameplay_change_multiple_barracks",
     "gameplay_change_warehouses_dont_accept",
+    "gameplay_change_fast_routing",
 };
 
 static const char *ini_string_keys[] = {
@@ -18,6 +18,7 @@ typedef enum {
     CONFIG_UI_COMPLETE_RATING_COLUMNS,
     CONFIG_UI_HIGHLIGHT_LEGIONS,
     CONFIG_UI_ROTATE_MANUALLY,
+    CONFIG_UI_CITY_RENDER_THREADS,
     CONFIG_GP_CH_GRANDFESTIVAL,
     CONFIG_GP_CH_JEALOUS_GODS,
     CONFIG_GP_CH_GLOBAL_LABOUR,
@@ -40,6 +41,7 @@ typedef enum {
     CONFIG_GP_CH_RANDOM_COLLAPSES_TAKE_MONEY,
     CONFIG_GP_CH_MULTIPLE_BARRACKS,
     CONFIG_GP_CH_WAREHOUSES_DONT_ACCEPT,
+    CONFIG_GP_CH_FAST_ROUTING,
     CONFIG_MAX_ENTRIES
 } config_key;
 
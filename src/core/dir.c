@@ -5,15 +5,40 @@
 #include "core/string.h"
 #include "platform/file_manager.h"
 
+#include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
 
 #define BASE_MAX_FILES 100
+#define MAX_DIR_INDEXES 16
+
+/**
+ * Lowercase name hash of a directory, so correcting the case of a file
+ * does not need to read the whole directory every time
+ */
+typedef struct {
+    char *path;
+    int type;
+    long long modification_time;
+    char missing_name[FILE_NAME_MAX];
+    unsigned int last_used;
+    char *names;
+    int names_size;
+    int names_capacity;
+    int *offsets;
+    int num_entries;
+    int max_entries;
+    int *buckets;
+    int num_buckets;
+} dir_index;
 
 static struct {
     dir_listing listing;
     int max_files;
     char *cased_filename;
+    dir_index indexes[MAX_DIR_INDEXES];
+    dir_index *building_index;
+    unsigned int use_counter;
 } data;
 
 static void allocate_listing_files(int min, int max)
@@ -89,10 +114,168 @@ static int compare_case(const char *filename)
     return LIST_NO_MATCH;
 }
 
+static unsigned int hash_lower(const char *name)
+{
+    unsigned int hash = 2166136261u;
+    while (*name) {
+        hash ^= (unsigned int) tolower(*name);
+        hash *= 16777619u;
+        name++;
+    }
+    return hash;
+}
+
+static void clear_index(dir_index *index)
+{
+    free(index->path);
+    free(index->names);
+    free(index->offsets);
+    free(index->buckets);
+    memset(index, 0, sizeof(dir_index));
+}
+
+static int add_to_index(const char *filename)
+{
+    dir_index *index = data.building_index;
+    int length = (int) strlen(filename) + 1;
+    if (index->names_size + length > index->names_capacity) {
+        int capacity = index->names_capacity ? 2 * index->names_capacity : 4096;
+        while (capacity < index->names_size + length) {
+            capacity *= 2;
+        }
+        char *names = (char *) realloc(index->names, capacity);
+        if (!names) {
+            return LIST_MATCH;
+        }
+        index->names = names;
+        index->names_capacity = capacity;
+    }
+    if (index->num_entries == index->max_entries) {
+        int max_entries = index->max_entries ? 2 * index->max_entries : 256;
+        int *offsets = (int *) realloc(index->offsets, max_entries * sizeof(int));
+        if (!offsets) {
+            return LIST_MATCH;
+        }
+        index->offsets = offsets;
+        index->max_entries = max_entries;
+    }
+    memcpy(&index->names[index->names_size], filename, length);
+    index->offsets[index->num_entries++] = index->names_size;
+    index->names_size += length;
+    return LIST_CONTINUE;
+}
+
+static int fill_index(dir_index *index)
+{
+    index->names_size = 0;
+    index->num_entries = 0;
+    index->missing_name[0] = 0;
+    index->modification_time = platform_file_manager_get_modification_time(index->path);
+    data.building_index = index;
+    // the callback only stops early when it runs out of memory
+    if (platform_file_manager_list_directory_contents(index->path, index->type, 0, add_to_index) != LIST_NO_MATCH) {
+        return 0;
+    }
+    int num_buckets = 64;
+    while (num_buckets < 2 * index->num_entries) {
+        num_buckets *= 2;
+    }
+    if (num_buckets != index->num_buckets) {
+        int *buckets = (int *) realloc(index->buckets, num_buckets * sizeof(int));
+        if (!buckets) {
+            return 0;
+        }
+        index->buckets = buckets;
+        index->num_buckets = num_buckets;
+    }
+    memset(index->buckets, 0, num_buckets * sizeof(int));
+    for (int i = 0; i < index->num_entries; i++) {
+        unsigned int bucket = hash_lower(&index->names[index->offsets[i]]) & (num_buckets - 1);
+        while (index->buckets[bucket]) {
+            bucket = (bucket + 1) & (num_buckets - 1);
+        }
+        // zero marks an empty bucket, so entries are stored one-based
+        index->buckets[bucket] = i + 1;
+    }
+    return 1;
+}
+
+static dir_index *get_index(const char *dir, int type)
+{
+    dir_index *unused = &data.indexes[0];
+    for (int i = 0; i < MAX_DIR_INDEXES; i++) {
+        dir_index *index = &data.indexes[i];
+        if (index->path && index->type == type && strcmp(index->path, dir) == 0) {
+            index->last_used = ++data.use_counter;
+            return index;
+        }
+        if (index->last_used < unused->last_used) {
+            unused = index;
+        }
+    }
+    clear_index(unused);
+    unused->path = (char *) malloc(strlen(dir) + 1);
+    if (!unused->path) {
+        return 0;
+    }
+    strcpy(unused->path, dir);
+    unused->type = type;
+    if (!fill_index(unused)) {
+        clear_index(unused);
+        return 0;
+    }
+    unused->last_used = ++data.use_counter;
+    return unused;
+}
+
+static const char *find_in_index(const dir_index *index, const char *filename)
+{
+    unsigned int bucket = hash_lower(filename) & (index->num_buckets - 1);
+    // with several names that only differ in case, the first one listed is used, like before
+    while (index->buckets[bucket]) {
+        const char *name = &index->names[index->offsets[index->buckets[bucket] - 1]];
+        if (string_compare_case_insensitive(name, filename) == 0) {
+            return name;
+        }
+        bucket = (bucket + 1) & (index->num_buckets - 1);
+    }
+    return 0;
+}
+
+// Some file systems only store the time in whole seconds, so a name that was added in the same second
+// as the index was filled does not change the time. A missing name is therefore looked for once more,
+// unless it was already missing after the last scan.
+static int needs_rescan(const dir_index *index, const char *filename)
+{
+    if (platform_file_manager_get_modification_time(index->path) != index->modification_time) {
+        return 1;
+    }
+    return string_compare_case_insensitive(index->missing_name, filename) != 0;
+}
+
 static int correct_case(const char *dir, char *filename, int type)
 {
-    data.cased_filename = filename;
-    return platform_file_manager_list_directory_contents(dir, type, 0, compare_case) == LIST_MATCH;
+    dir_index *index = get_index(dir ? dir : ".", type);
+    if (!index) {
+        data.cased_filename = filename;
+        return platform_file_manager_list_directory_contents(dir, type, 0, compare_case) == LIST_MATCH;
+    }
+    const char *name = find_in_index(index, filename);
+    if (!name && needs_rescan(index, filename)) {
+        if (!fill_index(index)) {
+            clear_index(index);
+            return 0;
+        }
+        name = find_in_index(index, filename);
+        if (!name) {
+            strncpy(index->missing_name, filename, FILE_NAME_MAX - 1);
+        }
+    }
+    if (name) {
+        strcpy(filename, name);
+        return 1;
+    }
+    return 0;
 }
 
 static void move_left(char *str)
@@ -84,3 +84,18 @@ int file_remove(const char *filename)
 {
     return platform_file_manager_remove_file(filename);
 }
+
+int file_rename(const char *filename, const char *new_filename)
+{
+    return platform_file_manager_rename_file(filename, new_filename);
+}
+
+const void *file_map(const char *filename, size_t *size)
+{
+    return platform_file_manager_map_file(filename, size);
+}
+
+void file_unmap(const void *data, size_t size)
+{
+    platform_file_manager_unmap_file(data, size);
+}
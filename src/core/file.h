@@ -77,4 +77,27 @@ int file_exists(const char *filename, int localizable);
  */
 int file_remove(const char *filename);
 
+/**
+ * Rename a file, replacing the destination if it exists
+ * @param filename Filename to rename
+ * @param new_filename New filename
+ * @return boolean true if renaming was successful, false otherwise
+ */
+int file_rename(const char *filename, const char *new_filename);
+
+/**
+ * Maps a file into memory for reading
+ * @param filename Filename to map
+ * @param size Set to the size of the file
+ * @return Pointer to the contents of the file, or NULL if it could not be mapped
+ */
+const void *file_map(const char *filename, size_t *size);
+
+/**
+ * Releases a file mapped with file_map
+ * @param data Pointer returned by file_map
+ * @param size Size of the file
+ */
+void file_unmap(const void *data, size_t size);
+
 #endif // CORE_FILE_H
@@ -62,6 +62,11 @@ static const char *ini_keys[] = {
     "resize_to_1024",
     "save_screenshot",
     "save_city_screenshot",
+    "toggle_profiler",
+    "dump_profiler",
+    "toggle_turbo",
+    "undo",
+    "redo",
 };
 
 static struct {
@@ -162,6 +167,11 @@ void init_defaults(void)
     set_mapping(KEY_F12, KEY_MOD_NONE, HOTKEY_SAVE_SCREENSHOT);
     set_mapping(KEY_F12, KEY_MOD_ALT, HOTKEY_SAVE_SCREENSHOT); // mac specific
     set_mapping(KEY_F12, KEY_MOD_CTRL, HOTKEY_SAVE_CITY_SCREENSHOT);
+    set_mapping(KEY_F11, KEY_MOD_CTRL, HOTKEY_TOGGLE_PROFILER);
+    set_mapping(KEY_F11, KEY_MOD_SHIFT, HOTKEY_DUMP_PROFILER);
+    set_layout_mapping("]", KEY_RIGHTBRACKET, KEY_MOD_CTRL, HOTKEY_TOGGLE_TURBO);
+    set_layout_mapping("Z", KEY_Z, KEY_MOD_CTRL, HOTKEY_UNDO);
+    set_layout_mapping("Y", KEY_Y, KEY_MOD_CTRL, HOTKEY_REDO);
 }
 
 const hotkey_mapping *hotkey_for_action(hotkey_action action, int index)
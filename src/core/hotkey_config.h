@@ -51,6 +51,11 @@ typedef enum {
     HOTKEY_RESIZE_TO_1024,
     HOTKEY_SAVE_SCREENSHOT,
     HOTKEY_SAVE_CITY_SCREENSHOT,
+    HOTKEY_TOGGLE_PROFILER,
+    HOTKEY_DUMP_PROFILER,
+    HOTKEY_TOGGLE_TURBO,
+    HOTKEY_UNDO,
+    HOTKEY_REDO,
     HOTKEY_MAX_ITEMS
 } hotkey_action;
 
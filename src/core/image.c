@@ -4,6 +4,7 @@
 #include "core/file.h"
 #include "core/io.h"
 #include "core/log.h"
+#include "game/system.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -33,8 +34,29 @@
 
 #define CYRILLIC_FONT_BASE_OFFSET 201
 
+// Converted climate images are cached next to the game files as <name>.c32, in native byte order
+#define IMAGE_CACHE_EXTENSION "c32"
+#define IMAGE_CACHE_MAGIC 0x32334341
+#define IMAGE_CACHE_VERSION 2
+#define IMAGE_CACHE_TEMP_SUFFIX ".tmp"
+
+// Decoded external images, such as the advisor and mission backgrounds, are kept in memory
+#define EXTERNAL_CACHE_ENTRIES 16
+#define EXTERNAL_CACHE_MAX_SIZE (32 * 1024 * 1024)
+
 #define NAME_SIZE 32
 
+// The city sprites of the main images: terrain, buildings and figures. The interface images lie in between.
+static const struct {
+    int first_group;
+    int end_group;
+} CITY_SPRITE_GROUPS[] = {
+    {GROUP_TERRAIN_ELEVATION, GROUP_TOP_MENU_SIDEBAR},
+    {GROUP_BUILDING_HOUSE_TENT, GROUP_PANEL_WINDOWS},
+    {GROUP_BUILDING_HIPPODROME_1, GROUP_MINIMAP_EMPTY_LAND},
+    {GROUP_FIGURE_CHARIOTEER, GROUP_SELECT_MISSION_BACKGROUND}
+};
+
 enum {
     NO_EXTRA_FONT = 0,
     FULL_CHARSET_IN_FONT = 1,
@@ -115,6 +137,17 @@ static const char ENEMY_GRAPHICS_555[][NAME_SIZE] = {
 
 static const image DUMMY_IMAGE;
 
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t index_hash;
+    uint32_t source_size;
+    uint32_t num_images;
+    uint32_t data_length;
+    int32_t offsets[MAIN_ENTRIES];
+    int32_t lengths[MAIN_ENTRIES];
+} image_cache_header;
+
 static struct {
     int current_climate;
     int is_editor;
@@ -126,13 +159,35 @@ static struct {
     image main[MAIN_ENTRIES];
     image enemy[ENEMY_ENTRIES];
     image *font;
-    color_t *main_data;
+    const color_t *main_data;
+    color_t *main_buffer;
+    const void *main_cache;
+    size_t main_cache_size;
     color_t *empire_data;
     color_t *enemy_data;
     color_t *font_data;
     uint8_t *tmp_data;
+    int main_city_sprite_extent;
+    int enemy_city_sprite_extent;
 } data = {.current_climate = -1};
 
+static struct {
+    struct {
+        int image_id;
+        color_t *pixels;
+        int size;
+        unsigned int last_used;
+    } entries[EXTERNAL_CACHE_ENTRIES];
+    int total_size;
+    unsigned int clock;
+    int hits;
+    int misses;
+    // Images handed out after this point of the clock are being drawn by other threads and are not evicted
+    int parallel_users;
+    unsigned int pinned_after;
+    system_mutex *mutex;
+} external_cache;
+
 static const image roadblock_image = { 58,30,0,0,0,0,0,{30,0,0,0,10000,0,1800,900} };
 static color_t roadblock_data[900] = { 0xa4180f, 0xa71f15
             , 0xa3150c, 0xa4170d, 0xaf4936, 0xd5ddb5, 0xced3a4, 0xc05c44
@@ -169,11 +224,10 @@ static color_t roadblock_data[900] = { 0xa4180f, 0xa71f15
 int image_init(void)
 {
     data.enemy_data = (color_t *) malloc(ENEMY_DATA_SIZE);
-    data.main_data = (color_t *) malloc(MAIN_DATA_SIZE);
     data.empire_data = (color_t *) malloc(EMPIRE_DATA_SIZE);
     data.tmp_data = (uint8_t *) malloc(SCRATCH_DATA_SIZE);
-    if (!data.main_data || !data.empire_data || !data.enemy_data || !data.tmp_data) {
-        free(data.main_data);
+    external_cache.mutex = system_mutex_create();
+    if (!data.empire_data || !data.enemy_data || !data.tmp_data) {
         free(data.empire_data);
         free(data.enemy_data);
         free(data.tmp_data);
@@ -288,7 +342,7 @@ static int convert_compressed(buffer *buf, int buf_length, color_t *dst)
     return dst_length;
 }
 
-static void convert_images(image *images, int size, buffer *buf, color_t *dst)
+static int convert_images(image *images, int size, buffer *buf, color_t *dst)
 {
     color_t *start_dst = dst;
     dst++; // make sure img->offset > 0
@@ -310,6 +364,195 @@ static void convert_images(image *images, int size, buffer *buf, color_t *dst)
         img->draw.offset = img_offset;
         img->draw.uncompressed_length /= 2;
     }
+    return (int) (dst - start_dst);
+}
+
+static uint32_t hash_data(const uint8_t *bytes, int length)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void release_main_cache(void)
+{
+    if (data.main_cache) {
+        file_unmap(data.main_cache, data.main_cache_size);
+        data.main_cache = 0;
+        data.main_cache_size = 0;
+    }
+}
+
+static int load_main_cache(const char *filename, uint32_t index_hash, uint32_t source_size)
+{
+    size_t size;
+    const uint8_t *cache = (const uint8_t *) file_map(filename, &size);
+    if (!cache) {
+        return 0;
+    }
+    const image_cache_header *header = (const image_cache_header *) cache;
+    if (size < sizeof(image_cache_header) || header->magic != IMAGE_CACHE_MAGIC ||
+        header->version != IMAGE_CACHE_VERSION || header->index_hash != index_hash ||
+        header->source_size != source_size || header->num_images != MAIN_ENTRIES ||
+        size != sizeof(image_cache_header) + (size_t) header->data_length * sizeof(color_t)) {
+        log_info("Image cache is out of date", filename, 0);
+        file_unmap(cache, size);
+        return 0;
+    }
+    for (int i = 0; i < MAIN_ENTRIES; i++) {
+        if (!data.main[i].draw.is_external && (header->offsets[i] <= 0 || header->lengths[i] < 0 ||
+            (uint64_t) header->offsets[i] + (uint64_t) header->lengths[i] > header->data_length)) {
+            log_error("Image cache is corrupt", filename, i);
+            file_unmap(cache, size);
+            return 0;
+        }
+    }
+    for (int i = 0; i < MAIN_ENTRIES; i++) {
+        image *img = &data.main[i];
+        if (!img->draw.is_external) {
+            img->draw.offset = header->offsets[i];
+            img->draw.uncompressed_length /= 2;
+        }
+    }
+    data.main_cache = cache;
+    data.main_cache_size = size;
+    data.main_data = (const color_t *) &cache[sizeof(image_cache_header)];
+    // The converted images are no longer needed in memory
+    free(data.main_buffer);
+    data.main_buffer = 0;
+    return 1;
+}
+
+static void save_main_cache(const char *filename, uint32_t index_hash, uint32_t source_size, int data_length)
+{
+    image_cache_header *header = (image_cache_header *) malloc(sizeof(image_cache_header));
+    if (!header) {
+        return;
+    }
+    header->magic = IMAGE_CACHE_MAGIC;
+    header->version = IMAGE_CACHE_VERSION;
+    header->index_hash = index_hash;
+    header->source_size = source_size;
+    header->num_images = MAIN_ENTRIES;
+    header->data_length = data_length;
+    // The images were converted one after the other, so each one ends where the next one starts
+    int end = data_length;
+    for (int i = MAIN_ENTRIES - 1; i >= 0; i--) {
+        if (data.main[i].draw.is_external) {
+            header->offsets[i] = 0;
+            header->lengths[i] = 0;
+        } else {
+            header->offsets[i] = data.main[i].draw.offset;
+            header->lengths[i] = end - data.main[i].draw.offset;
+            end = data.main[i].draw.offset;
+        }
+    }
+    // Another instance may be reading the cache, so it is replaced as a whole once it is complete
+    char temp_filename[FILE_NAME_MAX];
+    snprintf(temp_filename, FILE_NAME_MAX, "%s%s", filename, IMAGE_CACHE_TEMP_SUFFIX);
+    FILE *fp = file_open(temp_filename, "wb");
+    if (fp) {
+        int written = fwrite(header, sizeof(image_cache_header), 1, fp) == 1 &&
+            fwrite(data.main_buffer, sizeof(color_t), data_length, fp) == (size_t) data_length;
+        if (file_close(fp) != 0) {
+            written = 0;
+        }
+        if (!written || !file_rename(temp_filename, filename)) {
+            log_error("Unable to write image cache", filename, 0);
+            file_remove(temp_filename);
+        }
+    }
+    free(header);
+}
+
+static void clear_external_cache(void)
+{
+    system_mutex_lock(external_cache.mutex);
+    for (int i = 0; i < EXTERNAL_CACHE_ENTRIES; i++) {
+        free(external_cache.entries[i].pixels);
+        external_cache.entries[i].pixels = 0;
+        external_cache.entries[i].size = 0;
+    }
+    external_cache.total_size = 0;
+    system_mutex_unlock(external_cache.mutex);
+}
+
+static int is_pinned_external(int index)
+{
+    return external_cache.parallel_users && external_cache.entries[index].last_used > external_cache.pinned_after;
+}
+
+static int evict_least_recently_used_external(void)
+{
+    int oldest = -1;
+    for (int i = 0; i < EXTERNAL_CACHE_ENTRIES; i++) {
+        if (external_cache.entries[i].pixels && !is_pinned_external(i) &&
+            (oldest < 0 || external_cache.entries[i].last_used < external_cache.entries[oldest].last_used)) {
+            oldest = i;
+        }
+    }
+    if (oldest < 0) {
+        return 0;
+    }
+    free(external_cache.entries[oldest].pixels);
+    external_cache.entries[oldest].pixels = 0;
+    external_cache.total_size -= external_cache.entries[oldest].size;
+    external_cache.entries[oldest].size = 0;
+    return 1;
+}
+
+static const color_t *get_cached_external_data(int image_id)
+{
+    for (int i = 0; i < EXTERNAL_CACHE_ENTRIES; i++) {
+        if (external_cache.entries[i].pixels && external_cache.entries[i].image_id == image_id) {
+            external_cache.entries[i].last_used = ++external_cache.clock;
+            external_cache.hits++;
+            return external_cache.entries[i].pixels;
+        }
+    }
+    external_cache.misses++;
+    return 0;
+}
+
+static int find_free_external_entry(void)
+{
+    for (int i = 0; i < EXTERNAL_CACHE_ENTRIES; i++) {
+        if (!external_cache.entries[i].pixels) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static const color_t *add_external_data_to_cache(int image_id, const color_t *pixels, int num_pixels)
+{
+    int size = num_pixels * sizeof(color_t);
+    while (external_cache.total_size && external_cache.total_size + size > EXTERNAL_CACHE_MAX_SIZE) {
+        if (!evict_least_recently_used_external()) {
+            // The other images are still being drawn: go over the limit until image_end_parallel_use()
+            break;
+        }
+    }
+    int free_entry = find_free_external_entry();
+    if (free_entry < 0 && evict_least_recently_used_external()) {
+        free_entry = find_free_external_entry();
+    }
+    color_t *cached = free_entry >= 0 ? (color_t *) malloc(size) : 0;
+    if (!cached) {
+        // The scratch buffer is overwritten by the next image, which may be loaded by another thread
+        return external_cache.parallel_users ? 0 : pixels;
+    }
+    memcpy(cached, pixels, size);
+    external_cache.entries[free_entry].image_id = image_id;
+    external_cache.entries[free_entry].pixels = cached;
+    external_cache.entries[free_entry].size = size;
+    external_cache.entries[free_entry].last_used = ++external_cache.clock;
+    external_cache.total_size += size;
+    return cached;
 }
 
 static void load_empire(void)
@@ -324,6 +567,32 @@ static void load_empire(void)
     convert_uncompressed(&buf, size, data.empire_data);
 }
 
+static int max_sprite_extent(const image *images, int first_id, int end_id)
+{
+    int max_extent = 0;
+    for (int i = first_id; i < end_id; i++) {
+        int extent = images[i].height + abs(images[i].sprite_offset_y);
+        if (extent > max_extent) {
+            max_extent = extent;
+        }
+    }
+    return max_extent;
+}
+
+static int main_city_sprite_extent(void)
+{
+    int max_extent = 0;
+    for (int i = 0; i < (int) (sizeof(CITY_SPRITE_GROUPS) / sizeof(CITY_SPRITE_GROUPS[0])); i++) {
+        int extent = max_sprite_extent(data.main,
+            data.group_image_ids[CITY_SPRITE_GROUPS[i].first_group],
+            data.group_image_ids[CITY_SPRITE_GROUPS[i].end_group]);
+        if (extent > max_extent) {
+            max_extent = extent;
+        }
+    }
+    return max_extent;
+}
+
 int image_load_climate(int climate_id, int is_editor, int force_reload)
 {
     if (climate_id == data.current_climate && is_editor == data.is_editor && !force_reload) {
@@ -337,20 +606,46 @@ int image_load_climate(int climate_id, int is_editor, int force_reload)
         return 0;
     }
 
+    // The index describes where every image is, so together with the size of the image file
+    // it identifies the source of the cached images
+    uint32_t index_hash = hash_data(data.tmp_data, MAIN_INDEX_SIZE);
+    uint32_t source_size = io_get_file_size(filename_bmp, MAY_BE_LOCALIZED);
+    char cache_filename[FILE_NAME_MAX];
+    strncpy(cache_filename, filename_bmp, FILE_NAME_MAX - 1);
+    cache_filename[FILE_NAME_MAX - 1] = 0;
+    file_change_extension(cache_filename, IMAGE_CACHE_EXTENSION);
+
     buffer buf;
     buffer_init(&buf, data.tmp_data, HEADER_SIZE);
     read_header(&buf);
     buffer_init(&buf, &data.tmp_data[HEADER_SIZE], ENTRY_SIZE * MAIN_ENTRIES);
     read_index(&buf, data.main, MAIN_ENTRIES);
+    // External images refer to the bitmaps of the climate
+    clear_external_cache();
 
-    int data_size = io_read_file_into_buffer(filename_bmp, MAY_BE_LOCALIZED, data.tmp_data, SCRATCH_DATA_SIZE);
-    if (!data_size) {
-        return 0;
+    // Switching climates releases the previous images, and the index no longer matches them
+    release_main_cache();
+    data.main_data = 0;
+    data.current_climate = -1;
+    if (!load_main_cache(cache_filename, index_hash, source_size)) {
+        if (!data.main_buffer) {
+            data.main_buffer = (color_t *) malloc(MAIN_DATA_SIZE);
+            if (!data.main_buffer) {
+                return 0;
+            }
+        }
+        int data_size = io_read_file_into_buffer(filename_bmp, MAY_BE_LOCALIZED, data.tmp_data, SCRATCH_DATA_SIZE);
+        if (!data_size) {
+            return 0;
+        }
+        buffer_init(&buf, data.tmp_data, data_size);
+        int data_length = convert_images(data.main, MAIN_ENTRIES, &buf, data.main_buffer);
+        data.main_data = data.main_buffer;
+        save_main_cache(cache_filename, index_hash, source_size, data_length);
     }
-    buffer_init(&buf, data.tmp_data, data_size);
-    convert_images(data.main, MAIN_ENTRIES, &buf, data.main_data);
     data.current_climate = climate_id;
     data.is_editor = is_editor;
+    data.main_city_sprite_extent = main_city_sprite_extent();
 
     load_empire();
     return 1;
@@ -560,10 +855,11 @@ int image_load_enemy(int enemy_id)
     }
     buffer_init(&buf, data.tmp_data, data_size);
     convert_images(data.enemy, ENEMY_ENTRIES, &buf, data.enemy_data);
+    data.enemy_city_sprite_extent = max_sprite_extent(data.enemy, 0, ENEMY_ENTRIES);
     return 1;
 }
 
-static const color_t *load_external_data(int image_id)
+static const color_t *decode_external_data(int image_id)
 {
     image *img = &data.main[image_id];
     char filename[FILE_NAME_MAX] = "555/";
@@ -588,13 +884,62 @@ static const color_t *load_external_data(int image_id)
     buffer buf;
     buffer_init(&buf, data.tmp_data, size);
     color_t *dst = (color_t*) &data.tmp_data[4000000];
+    int num_pixels;
     // NB: isometric images are never external
     if (img->draw.is_fully_compressed) {
-        convert_compressed(&buf, img->draw.data_length, dst);
+        num_pixels = convert_compressed(&buf, img->draw.data_length, dst);
     } else {
-        convert_uncompressed(&buf, img->draw.data_length, dst);
+        num_pixels = convert_uncompressed(&buf, img->draw.data_length, dst);
+    }
+    return add_external_data_to_cache(image_id, dst, num_pixels);
+}
+
+static const color_t *load_external_data(int image_id)
+{
+    // Parallel jobs may draw external images, and decoding uses the shared scratch buffer
+    system_mutex_lock(external_cache.mutex);
+    const color_t *pixels = get_cached_external_data(image_id);
+    if (!pixels) {
+        pixels = decode_external_data(image_id);
     }
-    return dst;
+    system_mutex_unlock(external_cache.mutex);
+    return pixels;
+}
+
+void image_begin_parallel_use(void)
+{
+    system_mutex_lock(external_cache.mutex);
+    if (!external_cache.parallel_users++) {
+        external_cache.pinned_after = external_cache.clock;
+    }
+    system_mutex_unlock(external_cache.mutex);
+}
+
+void image_end_parallel_use(void)
+{
+    system_mutex_lock(external_cache.mutex);
+    if (!--external_cache.parallel_users) {
+        while (external_cache.total_size > EXTERNAL_CACHE_MAX_SIZE) {
+            if (!evict_least_recently_used_external()) {
+                break;
+            }
+        }
+    }
+    system_mutex_unlock(external_cache.mutex);
+}
+
+void image_get_external_cache_stats(int *hits, int *misses)
+{
+    system_mutex_lock(external_cache.mutex);
+    *hits = external_cache.hits;
+    *misses = external_cache.misses;
+    system_mutex_unlock(external_cache.mutex);
+}
+
+int image_max_city_sprite_extent(void)
+{
+    return data.main_city_sprite_extent > data.enemy_city_sprite_extent ?
+        data.main_city_sprite_extent : data.enemy_city_sprite_extent;
 }
 
 int image_group(int group)
@@ -648,7 +993,7 @@ const color_t *image_data(int id)
         return NULL;
     }
     if (!data.main[id].draw.is_external) {
-        return &data.main_data[data.main[id].draw.offset];
+        return data.main_data ? &data.main_data[data.main[id].draw.offset] : NULL;
     } else if (id == image_group(GROUP_EMPIRE_MAP)) {
         return data.empire_data;
     } else {
@@ -664,7 +1009,7 @@ const color_t *image_data_letter(int letter_id)
         return &data.font_data[data.font[data.font_base_offset + letter_id - IMAGE_FONT_MULTIBYTE_OFFSET].draw.offset];
     } else if (letter_id < IMAGE_FONT_MULTIBYTE_OFFSET) {
         int image_id = data.group_image_ids[GROUP_FONT] + letter_id;
-        return &data.main_data[data.main[image_id].draw.offset];
+        return data.main_data ? &data.main_data[data.main[image_id].draw.offset] : NULL;
     } else {
         return NULL;
     }
@@ -101,9 +101,36 @@ const image *image_get_enemy(int id);
  * Gets image pixel data by id
  * @param id Image ID
  * @return Pointer to data or null, short term use only.
+ *         External images stay valid until enough other external images are loaded to evict them from the cache.
  */
 const color_t *image_data(int id);
 
+/**
+ * Keeps the external images that are handed out from now on in memory until image_end_parallel_use(),
+ * so that parallel jobs can draw them while other jobs load more images.
+ * Must be called from the main thread before starting the jobs.
+ */
+void image_begin_parallel_use(void);
+
+/**
+ * Lets the external images from image_begin_parallel_use() be evicted again
+ */
+void image_end_parallel_use(void);
+
+/**
+ * Gets how far the tallest city sprite (terrain, building or figure) reaches from the point it is drawn at.
+ * Only changes when the climate or the enemy images are loaded.
+ * @return Height of the sprite plus its vertical offset, in pixels
+ */
+int image_max_city_sprite_extent(void);
+
+/**
+ * Gets the statistics of the external image cache
+ * @param hits Number of times an external image was found in the cache
+ * @param misses Number of times an external image had to be read from disk
+ */
+void image_get_external_cache_stats(int *hits, int *misses);
+
 /**
  * Gets letter image pixel data by id
  * @param letter_id Letter ID
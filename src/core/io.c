@@ -43,6 +43,22 @@ int io_read_file_part_into_buffer(const char *filepath, int localizable, void *b
     return bytes_read;
 }
 
+int io_get_file_size(const char *filepath, int localizable)
+{
+    const char *cased_file = dir_get_file(filepath, localizable);
+    if (!cased_file) {
+        return 0;
+    }
+    FILE *fp = file_open(cased_file, "rb");
+    if (!fp) {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    file_close(fp);
+    return size > 0 ? (int) size : 0;
+}
+
 int io_write_buffer_to_file(const char *filepath, const void *buffer, int size)
 {
     // Find existing file to overwrite
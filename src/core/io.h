@@ -28,6 +28,14 @@ int io_read_file_into_buffer(const char *filepath, int localizable, void *buffer
  */
 int io_read_file_part_into_buffer(const char *filepath, int localizable, void *buffer, int size, int offset_in_file);
 
+/**
+ * Gets the size of a file
+ * @param filepath File to check
+ * @param localizable Whether the file may be localized (see core/dir.h)
+ * @return Size of the file in bytes, 0 if the file does not exist
+ */
+int io_get_file_size(const char *filepath, int localizable);
+
 /**
  * Writes the entire buffer to the file
  * @param filepath File to write
@@ -0,0 +1,101 @@
+#include "slot_bitmap.h"
+
+#include <string.h>
+
+#define FULL_WORD 0xffffffff
+
+static int lowest_bit(uint32_t value)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(value);
+#else
+    int bit = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+static int num_words(const slot_bitmap *bitmap)
+{
+    return SLOT_BITMAP_WORDS(bitmap->num_slots);
+}
+
+void slot_bitmap_clear(slot_bitmap *bitmap)
+{
+    memset(bitmap->words, 0, num_words(bitmap) * sizeof(uint32_t));
+    bitmap->first_free_word = 0;
+}
+
+void slot_bitmap_set_used(slot_bitmap *bitmap, int slot)
+{
+    int word = slot / 32;
+    bitmap->words[word] |= 1u << (slot % 32);
+    if (word == bitmap->first_free_word) {
+        while (bitmap->first_free_word < num_words(bitmap) &&
+            bitmap->words[bitmap->first_free_word] == FULL_WORD) {
+            bitmap->first_free_word++;
+        }
+    }
+}
+
+void slot_bitmap_set_free(slot_bitmap *bitmap, int slot)
+{
+    int word = slot / 32;
+    bitmap->words[word] &= ~(1u << (slot % 32));
+    if (word < bitmap->first_free_word) {
+        bitmap->first_free_word = word;
+    }
+}
+
+int slot_bitmap_is_used(const slot_bitmap *bitmap, int slot)
+{
+    return (bitmap->words[slot / 32] >> (slot % 32)) & 1;
+}
+
+int slot_bitmap_find_free(const slot_bitmap *bitmap, int first_slot)
+{
+    int word = first_slot / 32;
+    if (word < bitmap->first_free_word) {
+        word = bitmap->first_free_word;
+        first_slot = word * 32;
+    }
+    int words = num_words(bitmap);
+    if (word >= words) {
+        return -1;
+    }
+    // treat the slots before first_slot in the first word as used
+    uint32_t free_bits = ~(bitmap->words[word] | ((1u << (first_slot % 32)) - 1));
+    while (!free_bits) {
+        if (++word >= words) {
+            return -1;
+        }
+        free_bits = ~bitmap->words[word];
+    }
+    // the last word may have free bits past the end
+    int slot = word * 32 + lowest_bit(free_bits);
+    return slot < bitmap->num_slots ? slot : -1;
+}
+
+int slot_bitmap_find_used(const slot_bitmap *bitmap, int first_slot)
+{
+    if (first_slot < 0) {
+        first_slot = 0;
+    }
+    int word = first_slot / 32;
+    int words = num_words(bitmap);
+    if (word >= words) {
+        return -1;
+    }
+    // ignore the slots before first_slot in the first word
+    uint32_t used_bits = bitmap->words[word] & ~((1u << (first_slot % 32)) - 1);
+    while (!used_bits) {
+        if (++word >= words) {
+            return -1;
+        }
+        used_bits = bitmap->words[word];
+    }
+    return word * 32 + lowest_bit(used_bits);
+}
@@ -0,0 +1,73 @@
+#ifndef CORE_SLOT_BITMAP_H
+#define CORE_SLOT_BITMAP_H
+
+#include <stdint.h>
+
+/**
+ * @file
+ * Bitmap of used slots in a fixed-size array, to quickly find the lowest free slot
+ * and to visit the used slots in order without looking at the empty ones.
+ */
+
+/**
+ * Number of words needed to store a bitmap for the given number of slots
+ */
+#define SLOT_BITMAP_WORDS(num_slots) (((num_slots) + 31) / 32)
+
+/**
+ * Bitmap with all slots free. Example:
+ * static uint32_t used_words[SLOT_BITMAP_WORDS(MAX_ITEMS)];
+ * static slot_bitmap used_slots = { used_words, MAX_ITEMS, 0 };
+ */
+typedef struct {
+    uint32_t *words;
+    int num_slots;
+    int first_free_word;
+} slot_bitmap;
+
+/**
+ * Marks all slots as free
+ * @param bitmap Bitmap to act on
+ */
+void slot_bitmap_clear(slot_bitmap *bitmap);
+
+/**
+ * Marks a slot as used
+ * @param bitmap Bitmap to act on
+ * @param slot Slot to mark
+ */
+void slot_bitmap_set_used(slot_bitmap *bitmap, int slot);
+
+/**
+ * Marks a slot as free
+ * @param bitmap Bitmap to act on
+ * @param slot Slot to mark
+ */
+void slot_bitmap_set_free(slot_bitmap *bitmap, int slot);
+
+/**
+ * Checks whether a slot is used
+ * @param bitmap Bitmap to check
+ * @param slot Slot to check
+ * @return 1 if the slot is used, 0 otherwise
+ */
+int slot_bitmap_is_used(const slot_bitmap *bitmap, int slot);
+
+/**
+ * Finds the lowest free slot
+ * @param bitmap Bitmap to search
+ * @param first_slot Slot to start searching from
+ * @return The lowest free slot at or after first_slot, or -1 if there is none
+ */
+int slot_bitmap_find_free(const slot_bitmap *bitmap, int first_slot);
+
+/**
+ * Finds the lowest used slot. Visiting all used slots in order:
+ * for (int i = slot_bitmap_find_used(bitmap, 0); i >= 0; i = slot_bitmap_find_used(bitmap, i + 1))
+ * @param bitmap Bitmap to search
+ * @param first_slot Slot to start searching from
+ * @return The lowest used slot at or after first_slot, or -1 if there is none
+ */
+int slot_bitmap_find_used(const slot_bitmap *bitmap, int first_slot);
+
+#endif // CORE_SLOT_BITMAP_H
@@ -1,5 +1,13 @@
 #include "core/time.h"
 
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__vita__)
+#include <psp2/kernel/processmgr.h>
+#else
+#include <time.h>
+#endif
+
 static time_millis current_time;
 
 time_millis time_get_millis(void)
@@ -11,3 +19,29 @@ void time_set_millis(time_millis millis)
 {
     current_time = millis;
 }
+
+#if defined(_WIN32)
+time_micros time_get_micros(void)
+{
+    static LARGE_INTEGER frequency;
+    if (!frequency.QuadPart) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (time_micros) (counter.QuadPart / frequency.QuadPart * 1000000 +
+        counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart);
+}
+#elif defined(__vita__)
+time_micros time_get_micros(void)
+{
+    return sceKernelGetProcessTimeWide();
+}
+#else
+time_micros time_get_micros(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (time_micros) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+#endif
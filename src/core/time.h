@@ -1,6 +1,8 @@
 #ifndef CORE_TIME_H
 #define CORE_TIME_H
 
+#include <stdint.h>
+
 /**
  * @file
  * Time tracking functions.
@@ -11,6 +13,11 @@
  */
 typedef unsigned int time_millis;
 
+/**
+ * Time in microsecond-precision. Use only for time difference calculations.
+ */
+typedef uint64_t time_micros;
+
 /**
  * Gets the current time
  * @return Current time in milliseconds
@@ -23,4 +30,12 @@ time_millis time_get_millis(void);
  */
 void time_set_millis(time_millis millis);
 
+/**
+ * Gets the wall clock time from a monotonic high-resolution clock.
+ * Unlike time_get_millis(), this is not driven by the game loop,
+ * so it should only be used for performance measurements.
+ * @return Current wall clock time in microseconds
+ */
+time_micros time_get_micros(void);
+
 #endif // CORE_TIME_H
@@ -20,6 +20,7 @@
 #include "figuretype/trader.h"
 #include "figuretype/wall.h"
 #include "figuretype/water.h"
+#include "game/profiler.h"
 
 static void figure_nobody_action(figure *f)
 {
@@ -112,7 +113,7 @@ void figure_action_handle(void)
 {
     city_figures_reset();
     city_entertainment_set_hippodrome_has_race(0);
-    for (int i = 1; i < MAX_FIGURES; i++) {
+    for (int i = figure_next_id(0); i; i = figure_next_id(i)) {
         figure *f = figure_get(i);
         if (f->state) {
             if (f->targeted_by_figure_id) {
@@ -124,7 +125,14 @@ void figure_action_handle(void)
                     f->targeted_by_figure_id = 0;
                 }
             }
-            figure_action_callbacks[f->type](f);
+            if (profiler_is_enabled()) {
+                time_micros start = time_get_micros();
+                int type = f->type;
+                figure_action_callbacks[type](f);
+                profiler_record_figure(type, start);
+            } else {
+                figure_action_callbacks[f->type](f);
+            }
             if (f->state == FIGURE_STATE_DEAD) {
                 figure_delete(f);
             }
@@ -10,6 +10,17 @@
 #include "map/figure.h"
 #include "sound/effect.h"
 
+#define ENEMY_TARGET_MIN_SEARCH_RADIUS 8
+#define ENEMY_TARGET_MAX_SEARCH_RADIUS 32
+
+static struct {
+    int x;
+    int y;
+    int max_distance;
+    int min_distance;
+    int min_figure_id;
+} target_search;
+
 static int is_attacking_native(const figure *f)
 {
     return f->type == FIGURE_INDIGENOUS_NATIVE && f->action_state == FIGURE_ACTION_159_NATIVE_ATTACKING;
@@ -148,110 +159,142 @@ void figure_combat_handle_attack(figure *f)
     }
 }
 
-int figure_combat_get_target_for_soldier(int x, int y, int max_distance)
+static void start_target_search(int x, int y, int max_distance)
 {
-    int min_figure_id = 0;
-    int min_distance = 10000;
-    for (int i = 1; i < MAX_FIGURES; i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f)) {
-            continue;
-        }
-        if (figure_is_enemy(f) || f->type == FIGURE_RIOTER || is_attacking_native(f)) {
-            int distance = calc_maximum_distance(x, y, f->x, f->y);
-            if (distance <= max_distance) {
-                if (f->targeted_by_figure_id) {
-                    distance *= 2; // penalty
-                }
-                if (distance < min_distance) {
-                    min_distance = distance;
-                    min_figure_id = i;
-                }
-            }
+    target_search.x = x;
+    target_search.y = y;
+    target_search.max_distance = max_distance;
+    target_search.min_distance = 10000;
+    target_search.min_figure_id = 0;
+}
+
+static void update_closest_target(int figure_id, int distance)
+{
+    // figures are visited by location, so break ties on ID like a scan over all figures would
+    if (distance < target_search.min_distance ||
+        (distance == target_search.min_distance && figure_id < target_search.min_figure_id)) {
+        target_search.min_distance = distance;
+        target_search.min_figure_id = figure_id;
+    }
+}
+
+static void search_area(int radius, void (*callback)(figure *f))
+{
+    map_figure_foreach_in_area(target_search.x - radius, target_search.y - radius,
+        target_search.x + radius, target_search.y + radius, callback);
+}
+
+static int is_soldier_target(const figure *f)
+{
+    return figure_is_enemy(f) || f->type == FIGURE_RIOTER || is_attacking_native(f);
+}
+
+static void find_soldier_target(figure *f)
+{
+    if (figure_is_dead(f) || !is_soldier_target(f)) {
+        return;
+    }
+    int distance = calc_maximum_distance(target_search.x, target_search.y, f->x, f->y);
+    if (distance <= target_search.max_distance) {
+        if (f->targeted_by_figure_id) {
+            distance *= 2; // penalty
         }
+        update_closest_target(f->id, distance);
     }
-    if (min_figure_id) {
-        return min_figure_id;
+}
+
+int figure_combat_get_target_for_soldier(int x, int y, int max_distance)
+{
+    start_target_search(x, y, max_distance);
+    search_area(max_distance, find_soldier_target);
+    if (target_search.min_figure_id) {
+        return target_search.min_figure_id;
     }
     for (int i = 1; i < MAX_FIGURES; i++) {
         figure *f = figure_get(i);
         if (figure_is_dead(f)) {
             continue;
         }
-        if (figure_is_enemy(f) || f->type == FIGURE_RIOTER || is_attacking_native(f)) {
+        if (is_soldier_target(f)) {
             return i;
         }
     }
     return 0;
 }
 
-int figure_combat_get_target_for_wolf(int x, int y, int max_distance)
+static void find_wolf_target(figure *f)
 {
-    int min_figure_id = 0;
-    int min_distance = 10000;
-    for (int i = 1; i < MAX_FIGURES; i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f) || !f->type) {
-            continue;
-        }
-        switch (f->type) {
-            case FIGURE_EXPLOSION:
-            case FIGURE_FORT_STANDARD:
-            case FIGURE_TRADE_SHIP:
-            case FIGURE_FISHING_BOAT:
-            case FIGURE_MAP_FLAG:
-            case FIGURE_FLOTSAM:
-            case FIGURE_SHIPWRECK:
-            case FIGURE_INDIGENOUS_NATIVE:
-            case FIGURE_TOWER_SENTRY:
-            case FIGURE_NATIVE_TRADER:
-            case FIGURE_ARROW:
-            case FIGURE_JAVELIN:
-            case FIGURE_BOLT:
-            case FIGURE_BALLISTA:
-            case FIGURE_CREATURE:
-                continue;
-        }
-        if (figure_is_enemy(f) || figure_is_herd(f)) {
-            continue;
-        }
-        if (figure_is_legion(f) && f->action_state == FIGURE_ACTION_80_SOLDIER_AT_REST) {
-            continue;
-        }
-        int distance = calc_maximum_distance(x, y, f->x, f->y);
-        if (f->targeted_by_figure_id) {
-            distance *= 2;
-        }
-        if (distance < min_distance) {
-            min_distance = distance;
-            min_figure_id = i;
-        }
+    if (figure_is_dead(f) || !f->type) {
+        return;
+    }
+    switch (f->type) {
+        case FIGURE_EXPLOSION:
+        case FIGURE_FORT_STANDARD:
+        case FIGURE_TRADE_SHIP:
+        case FIGURE_FISHING_BOAT:
+        case FIGURE_MAP_FLAG:
+        case FIGURE_FLOTSAM:
+        case FIGURE_SHIPWRECK:
+        case FIGURE_INDIGENOUS_NATIVE:
+        case FIGURE_TOWER_SENTRY:
+        case FIGURE_NATIVE_TRADER:
+        case FIGURE_ARROW:
+        case FIGURE_JAVELIN:
+        case FIGURE_BOLT:
+        case FIGURE_BALLISTA:
+        case FIGURE_CREATURE:
+            return;
+    }
+    if (figure_is_enemy(f) || figure_is_herd(f)) {
+        return;
+    }
+    if (figure_is_legion(f) && f->action_state == FIGURE_ACTION_80_SOLDIER_AT_REST) {
+        return;
     }
-    if (min_distance <= max_distance && min_figure_id) {
-        return min_figure_id;
+    int distance = calc_maximum_distance(target_search.x, target_search.y, f->x, f->y);
+    if (f->targeted_by_figure_id) {
+        distance *= 2;
+    }
+    update_closest_target(f->id, distance);
+}
+
+int figure_combat_get_target_for_wolf(int x, int y, int max_distance)
+{
+    start_target_search(x, y, max_distance);
+    // the penalty only increases distances, so targets outside max_distance can never be picked
+    search_area(max_distance, find_wolf_target);
+    if (target_search.min_distance <= max_distance && target_search.min_figure_id) {
+        return target_search.min_figure_id;
     }
     return 0;
 }
 
+static void find_enemy_target(figure *f)
+{
+    if (figure_is_dead(f)) {
+        return;
+    }
+    if (!f->targeted_by_figure_id && figure_is_legion(f)) {
+        update_closest_target(f->id, calc_maximum_distance(target_search.x, target_search.y, f->x, f->y));
+    }
+}
+
 int figure_combat_get_target_for_enemy(int x, int y)
 {
-    int min_figure_id = 0;
-    int min_distance = 10000;
-    for (int i = 1; i < MAX_FIGURES; i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f)) {
-            continue;
-        }
-        if (!f->targeted_by_figure_id && figure_is_legion(f)) {
-            int distance = calc_maximum_distance(x, y, f->x, f->y);
-            if (distance < min_distance) {
-                min_distance = distance;
-                min_figure_id = i;
-            }
+    start_target_search(x, y, 0);
+    for (int radius = ENEMY_TARGET_MIN_SEARCH_RADIUS; radius <= ENEMY_TARGET_MAX_SEARCH_RADIUS; radius *= 2) {
+        search_area(radius, find_enemy_target);
+        if (target_search.min_distance <= radius) {
+            // every legionary at least as close as this one has been seen
+            return target_search.min_figure_id;
         }
     }
-    if (min_figure_id) {
-        return min_figure_id;
+    // far away: scan everyone
+    for (int i = 1; i < MAX_FIGURES; i++) {
+        find_enemy_target(figure_get(i));
+    }
+    if (target_search.min_figure_id) {
+        return target_search.min_figure_id;
     }
     // no 'free' soldier found, take first one
     for (int i = 1; i < MAX_FIGURES; i++) {
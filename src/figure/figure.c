@@ -3,6 +3,7 @@
 #include "building/building.h"
 #include "city/emperor.h"
 #include "core/random.h"
+#include "core/slot_bitmap.h"
 #include "empire/city.h"
 #include "figure/name.h"
 #include "figure/route.h"
@@ -17,23 +18,27 @@ static struct {
     figure figures[MAX_FIGURES];
 } data = {0};
 
+static uint32_t used_slot_words[SLOT_BITMAP_WORDS(MAX_FIGURES)];
+static slot_bitmap used_slots = { used_slot_words, MAX_FIGURES, 0 };
+
 figure *figure_get(int id)
 {
     return &data.figures[id];
 }
 
+int figure_next_id(int id)
+{
+    int next = slot_bitmap_find_used(&used_slots, id + 1);
+    return next > 0 ? next : 0;
+}
+
 figure *figure_create(figure_type type, int x, int y, direction_type dir)
 {
-    int id = 0;
-    for (int i = 1; i < MAX_FIGURES; i++) {
-        if (!data.figures[i].state) {
-            id = i;
-            break;
-        }
-    }
-    if (!id) {
+    int id = slot_bitmap_find_free(&used_slots, 1);
+    if (id <= 0) {
         return &data.figures[0];
     }
+    slot_bitmap_set_used(&used_slots, id);
     figure *f = &data.figures[id];
     f->state = FIGURE_STATE_ALIVE;
     f->faction_id = 1;
@@ -112,6 +117,7 @@ void figure_delete(figure *f)
     int figure_id = f->id;
     memset(f, 0, sizeof(figure));
     f->id = figure_id;
+    slot_bitmap_set_free(&used_slots, figure_id);
 }
 
 int figure_is_dead(const figure *f)
@@ -140,6 +146,7 @@ void figure_init_scenario(void)
         memset(&data.figures[i], 0, sizeof(figure));
         data.figures[i].id = i;
     }
+    slot_bitmap_clear(&used_slots);
     data.created_sequence = 0;
 }
 
@@ -356,8 +363,12 @@ void figure_load_state(buffer *list, buffer *seq)
 {
     data.created_sequence = buffer_read_i32(seq);
 
+    slot_bitmap_clear(&used_slots);
     for (int i = 0; i < MAX_FIGURES; i++) {
         figure_load(list, &data.figures[i]);
         data.figures[i].id = i;
+        if (data.figures[i].state) {
+            slot_bitmap_set_used(&used_slots, i);
+        }
     }
 }
@@ -118,6 +118,15 @@ typedef struct {
 
 figure *figure_get(int id);
 
+/**
+ * Returns the next figure slot in use, in increasing id order. Loop over all figures with:
+ * for (int i = figure_next_id(0); i; i = figure_next_id(i))
+ * Figures created or deleted during the loop are handled like in a loop over all ids.
+ * @param id Figure ID to continue after, 0 to start at the first figure
+ * @return ID of the next figure in use, or 0 if there are no more
+ */
+int figure_next_id(int id);
+
 /**
  * Creates a figure
  * @param type Figure type
@@ -1,24 +1,40 @@
 #include "route.h"
 
+#include "core/slot_bitmap.h"
 #include "map/routing.h"
 #include "map/routing_path.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #define MAX_PATH_LENGTH 500
 #define MAX_ROUTES 3000
+#define PATH_ALLOC_STEP 32
+
+// Directions fit in four bits, so two of them are packed into a byte. Each path only takes as much
+// memory as it needs and keeps its buffer for the next route that uses the slot.
+typedef struct {
+    uint8_t *packed;
+    uint16_t length;
+    uint16_t capacity;
+} packed_path;
 
 static struct {
     int figure_ids[MAX_ROUTES];
-    uint8_t direction_paths[MAX_ROUTES][MAX_PATH_LENGTH];
+    packed_path paths[MAX_ROUTES];
+    uint8_t scratch[MAX_PATH_LENGTH];
 } data;
 
+static uint32_t used_slot_words[SLOT_BITMAP_WORDS(MAX_ROUTES)];
+static slot_bitmap used_slots = { used_slot_words, MAX_ROUTES, 0 };
+
 void figure_route_clear_all(void)
 {
     for (int i = 0; i < MAX_ROUTES; i++) {
         data.figure_ids[i] = 0;
-        for (int j = 0; j < MAX_PATH_LENGTH; j++) {
-            data.direction_paths[i][j] = 0;
-        }
+        data.paths[i].length = 0;
     }
+    slot_bitmap_clear(&used_slots);
 }
 
 void figure_route_clean(void)
@@ -29,19 +45,50 @@ void figure_route_clean(void)
             const figure *f = figure_get(figure_id);
             if (f->state != FIGURE_STATE_ALIVE || f->routing_path_id != i) {
                 data.figure_ids[i] = 0;
+                data.paths[i].length = 0;
+                slot_bitmap_set_free(&used_slots, i);
             }
         }
     }
 }
 
-static int get_first_available(void)
+static int store_path(int path_id, const uint8_t *directions, int length)
 {
-    for (int i = 1; i < MAX_ROUTES; i++) {
-        if (data.figure_ids[i] == 0) {
-            return i;
+    packed_path *path = &data.paths[path_id];
+    int bytes = (length + 1) / 2;
+    if (bytes > path->capacity) {
+        int capacity = (bytes + PATH_ALLOC_STEP - 1) / PATH_ALLOC_STEP * PATH_ALLOC_STEP;
+        uint8_t *packed = (uint8_t *) realloc(path->packed, capacity);
+        if (!packed) {
+            path->length = 0;
+            return 0;
         }
+        path->packed = packed;
+        path->capacity = (uint16_t) capacity;
+    }
+    for (int i = 0; i < bytes; i++) {
+        int low = directions[2 * i] & 0xf;
+        int high = 2 * i + 1 < length ? directions[2 * i + 1] & 0xf : 0;
+        path->packed[i] = (uint8_t) (low | (high << 4));
+    }
+    path->length = (uint16_t) length;
+    return 1;
+}
+
+static void unpack_path(int path_id, uint8_t *directions)
+{
+    const packed_path *path = &data.paths[path_id];
+    for (int i = 0; i < path->length; i++) {
+        uint8_t value = path->packed[i / 2];
+        directions[i] = (i & 1) ? value >> 4 : value & 0xf;
     }
-    return 0;
+    memset(&directions[path->length], 0, MAX_PATH_LENGTH - path->length);
+}
+
+static int get_first_available(void)
+{
+    int path_id = slot_bitmap_find_free(&used_slots, 1);
+    return path_id > 0 ? path_id : 0;
 }
 
 void figure_route_add(figure *f)
@@ -57,11 +104,11 @@ void figure_route_add(figure *f)
     if (f->is_boat) {
         if (f->is_boat == 2) { // flotsam
             map_routing_calculate_distances_water_flotsam(f->x, f->y);
-            path_length = map_routing_get_path_on_water(data.direction_paths[path_id],
+            path_length = map_routing_get_path_on_water(data.scratch,
                 f->destination_x, f->destination_y, 1);
         } else {
             map_routing_calculate_distances_water_boat(f->x, f->y);
-            path_length = map_routing_get_path_on_water(data.direction_paths[path_id],
+            path_length = map_routing_get_path_on_water(data.scratch,
                 f->destination_x, f->destination_y, 0);
         }
     } else {
@@ -107,22 +154,23 @@ void figure_route_add(figure *f)
         }
         if (can_travel) {
             if (f->terrain_usage == TERRAIN_USAGE_WALLS) {
-                path_length = map_routing_get_path(data.direction_paths[path_id], f->x, f->y,
+                path_length = map_routing_get_path(data.scratch, f->x, f->y,
                     f->destination_x, f->destination_y, 4);
                 if (path_length <= 0) {
-                    path_length = map_routing_get_path(data.direction_paths[path_id], f->x, f->y,
+                    path_length = map_routing_get_path(data.scratch, f->x, f->y,
                         f->destination_x, f->destination_y, 8);
                 }
             } else {
-                path_length = map_routing_get_path(data.direction_paths[path_id], f->x, f->y,
+                path_length = map_routing_get_path(data.scratch, f->x, f->y,
                     f->destination_x, f->destination_y, 8);
             }
         } else { // cannot travel
             path_length = 0;
         }
     }
-    if (path_length) {
+    if (path_length > 0 && store_path(path_id, data.scratch, path_length)) {
         data.figure_ids[path_id] = f->id;
+        slot_bitmap_set_used(&used_slots, path_id);
         f->routing_path_id = path_id;
         f->routing_path_length = path_length;
     }
@@ -133,6 +181,8 @@ void figure_route_remove(figure *f)
     if (f->routing_path_id > 0) {
         if (data.figure_ids[f->routing_path_id] == f->id) {
             data.figure_ids[f->routing_path_id] = 0;
+            data.paths[f->routing_path_id].length = 0;
+            slot_bitmap_set_free(&used_slots, f->routing_path_id);
         }
         f->routing_path_id = 0;
     }
@@ -140,21 +190,43 @@ void figure_route_remove(figure *f)
 
 int figure_route_get_direction(int path_id, int index)
 {
-    return data.direction_paths[path_id][index];
+    const packed_path *path = &data.paths[path_id];
+    if (index < 0 || index >= path->length) {
+        return 0;
+    }
+    uint8_t value = path->packed[index / 2];
+    return (index & 1) ? value >> 4 : value & 0xf;
 }
 
 void figure_route_save_state(buffer *figures, buffer *paths)
 {
     for (int i = 0; i < MAX_ROUTES; i++) {
         buffer_write_i16(figures, data.figure_ids[i]);
-        buffer_write_raw(paths, data.direction_paths[i], MAX_PATH_LENGTH);
+        unpack_path(i, data.scratch);
+        buffer_write_raw(paths, data.scratch, MAX_PATH_LENGTH);
     }
 }
 
 void figure_route_load_state(buffer *figures, buffer *paths)
 {
+    slot_bitmap_clear(&used_slots);
     for (int i = 0; i < MAX_ROUTES; i++) {
         data.figure_ids[i] = buffer_read_i16(figures);
-        buffer_read_raw(paths, data.direction_paths[i], MAX_PATH_LENGTH);
+        buffer_read_raw(paths, data.scratch, MAX_PATH_LENGTH);
+        data.paths[i].length = 0;
+        if (data.figure_ids[i]) {
+            slot_bitmap_set_used(&used_slots, i);
+            // Figures are loaded first: only the owner's current path is ever read
+            if (data.figure_ids[i] > 0 && data.figure_ids[i] < MAX_FIGURES) {
+                const figure *f = figure_get(data.figure_ids[i]);
+                int length = f->routing_path_id == i ? f->routing_path_length : 0;
+                if (length > MAX_PATH_LENGTH) {
+                    length = MAX_PATH_LENGTH;
+                }
+                if (length > 0) {
+                    store_path(i, data.scratch, length);
+                }
+            }
+        }
     }
 }
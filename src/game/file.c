@@ -31,7 +31,9 @@
 #include "game/animation.h"
 #include "game/difficulty.h"
 #include "game/file_io.h"
+#include "game/save_index.h"
 #include "game/settings.h"
+#include "game/snapshot.h"
 #include "game/state.h"
 #include "game/time.h"
 #include "game/tutorial.h"
@@ -50,11 +52,13 @@
 #include "map/property.h"
 #include "map/random.h"
 #include "map/road_network.h"
+#include "map/routing.h"
 #include "map/routing_terrain.h"
 #include "map/soldier_strength.h"
 #include "map/sprite.h"
 #include "map/terrain.h"
 #include "map/tiles.h"
+#include "map/water_supply.h"
 #include "scenario/criteria.h"
 #include "scenario/demand_change.h"
 #include "scenario/distant_battle.h"
@@ -124,6 +128,7 @@ static void clear_scenario_data(void)
     map_elevation_clear();
     map_soldier_strength_clear();
     map_road_network_clear();
+    map_water_supply_clear();
 
     map_image_context_init();
     map_random_init();
@@ -131,6 +136,7 @@ static void clear_scenario_data(void)
 
 static void initialize_scenario_data(const uint8_t *scenario_name)
 {
+    game_snapshot_clear();
     scenario_set_name(scenario_name);
     scenario_map_init();
 
@@ -233,23 +239,31 @@ static void check_backward_compatibility(void){
     }
 }
 
-static void initialize_saved_game(void)
+// Rebuilds the parts of the city that are not in the saved game
+static void initialize_unsaved_state(void)
 {
-    load_empire_data(scenario_is_custom(), scenario_empire_id());
-
-    scenario_map_init();
-
-    city_view_init();
-
     map_routing_update_all();
 
     map_orientation_update_buildings();
     figure_route_clean();
     map_road_network_update();
+    map_water_supply_clear();
     building_maintenance_check_rome_access();
     building_granaries_calculate_stocks();
     building_menu_update();
     city_message_init_problem_areas();
+}
+
+static void initialize_saved_game(void)
+{
+    game_snapshot_clear();
+
+    load_empire_data(scenario_is_custom(), scenario_empire_id());
+
+    scenario_map_init();
+
+    city_view_init();
+    initialize_unsaved_state();
 
     sound_city_init();
 
@@ -388,6 +402,7 @@ int game_file_load_saved_game(const char *filename)
 
 int game_file_write_saved_game(const char *filename)
 {
+    game_save_index_invalidate(filename);
     return game_file_io_write_saved_game(filename);
 }
 
@@ -396,6 +411,56 @@ int game_file_delete_saved_game(const char *filename)
     return game_file_io_delete_saved_game(filename);
 }
 
+int game_file_snapshot_size(void)
+{
+    return game_file_io_snapshot_size() + map_image_context_state_size();
+}
+
+static void image_context_state_buffer(buffer *buf, uint8_t *data)
+{
+    int size = map_image_context_state_size();
+    buffer_init(buf, &data[game_file_io_snapshot_size()], size);
+}
+
+void game_file_write_snapshot(uint8_t *data)
+{
+    game_file_io_write_snapshot(data);
+    buffer buf;
+    image_context_state_buffer(&buf, data);
+    map_image_context_save_state(&buf);
+}
+
+void game_file_load_snapshot(const uint8_t *data)
+{
+    // The snapshot is of the same game, so the empire, climate images and scenario stay as they are.
+    // The player keeps looking at the same place, unless the snapshot has another orientation.
+    int orientation = city_view_orientation();
+    int camera_x, camera_y;
+    city_view_get_camera(&camera_x, &camera_y);
+    game_file_io_read_snapshot(data);
+    if (city_view_orientation() == orientation) {
+        city_view_set_camera(camera_x, camera_y);
+    }
+    city_view_refresh();
+
+    // The routes calculated while rebuilding were already counted when the snapshot was taken
+    uint8_t routing_state[ROUTING_STATE_SIZE];
+    buffer routing_buf;
+    buffer_init(&routing_buf, routing_state, ROUTING_STATE_SIZE);
+    map_routing_save_state(&routing_buf);
+    initialize_unsaved_state();
+    city_military_determine_distant_battle_city();
+    map_tiles_determine_gardens();
+    building_storage_reset_building_ids();
+    buffer_reset(&routing_buf);
+    map_routing_load_state(&routing_buf);
+
+    buffer buf;
+    image_context_state_buffer(&buf, (uint8_t *) data);
+    map_image_context_load_state(&buf);
+    game_undo_disable();
+}
+
 void game_file_write_mission_saved_game(void)
 {
     int rank = scenario_campaign_rank();
@@ -45,6 +45,24 @@ int game_file_write_saved_game(const char *filename);
  */
 int game_file_delete_saved_game(const char *filename);
 
+/**
+ * Gets the size of an in-memory snapshot of the game
+ * @return Size in bytes
+ */
+int game_file_snapshot_size(void);
+
+/**
+ * Writes the state of the game to memory, without compression
+ * @param data Memory of at least game_file_snapshot_size() bytes
+ */
+void game_file_write_snapshot(uint8_t *data);
+
+/**
+ * Restores the state of the game from a snapshot of the same game
+ * @param data Snapshot written by game_file_write_snapshot
+ */
+void game_file_load_snapshot(const uint8_t *data);
+
 /**
  * Write starting save for the current campaign mission
  */
@@ -6,6 +6,8 @@
 #include "building/storage.h"
 #include "city/culture.h"
 #include "city/data.h"
+#include "city/finance.h"
+#include "city/population.h"
 #include "core/file.h"
 #include "core/log.h"
 #include "city/message.h"
@@ -22,6 +24,7 @@
 #include "figure/name.h"
 #include "figure/route.h"
 #include "figure/trader.h"
+#include "game/system.h"
 #include "game/time.h"
 #include "game/tutorial.h"
 #include "map/aqueduct.h"
@@ -29,6 +32,7 @@
 #include "map/building.h"
 #include "map/desirability.h"
 #include "map/elevation.h"
+#include "map/grid.h"
 #include "map/figure.h"
 #include "map/image.h"
 #include "map/property.h"
@@ -41,6 +45,7 @@
 #include "scenario/emperor_change.h"
 #include "scenario/gladiator_revolt.h"
 #include "scenario/invasion.h"
+#include "scenario/property.h"
 #include "scenario/scenario.h"
 #include "sound/city.h"
 
@@ -50,9 +55,15 @@
 
 #define COMPRESS_BUFFER_SIZE 3000000
 #define UNCOMPRESSED 0x80000000
+#define MAX_PIECES 100
 
 static const int SAVE_GAME_VERSION = 0x76;
 
+// The summary block is followed by its size and this marker, so it can be found from the end of the file
+#define SAVED_GAME_INFO_MARKER 0x4f464e49
+#define SAVED_GAME_INFO_VERSION 1
+#define SAVED_GAME_INFO_SIZE (5 * 4 + SAVED_GAME_INFO_NAME_LENGTH + SAVED_GAME_THUMBNAIL_SIZE * SAVED_GAME_THUMBNAIL_SIZE)
+
 static char compress_buffer[COMPRESS_BUFFER_SIZE];
 
 static int savegame_version;
@@ -169,7 +180,8 @@ typedef struct {
 
 static struct {
     int num_pieces;
-    file_piece pieces[100];
+    int is_expanded;
+    file_piece pieces[MAX_PIECES];
     savegame_state state;
 } savegame_data = {0};
 
@@ -228,6 +240,7 @@ static void init_savegame_data(void)
         //return;
         savegame_data.num_pieces = 0;
     }
+    savegame_data.is_expanded = 0;
     savegame_state *state = &savegame_data.state;
     state->scenario_campaign_mission = create_savegame_piece(4, 0);
     state->file_version = create_savegame_piece(4, 0);
@@ -317,13 +330,21 @@ static void init_savegame_data(void)
 static void init_savegame_data_expanded(void)
 {
     if (savegame_data.num_pieces > 0) {
+        // Snapshots use this layout many times in a row, so the pieces are kept when possible
+        if (savegame_data.is_expanded) {
+            for (int i = 0; i < savegame_data.num_pieces; i++) {
+                buffer_reset(&savegame_data.pieces[i].buf);
+                memset(savegame_data.pieces[i].buf.data, 0, savegame_data.pieces[i].buf.size);
+            }
+            return;
+        }
         for (int i = 0; i < savegame_data.num_pieces; i++) {
             buffer_reset(&savegame_data.pieces[i].buf);
             free(savegame_data.pieces[i].buf.data);
         }
-        //return;
         savegame_data.num_pieces = 0;
     }
+    savegame_data.is_expanded = 1;
     savegame_state *state = &savegame_data.state;
     state->scenario_campaign_mission = create_savegame_piece(4, 0);
     state->file_version = create_savegame_piece(4, 0);
@@ -663,24 +684,6 @@ static void write_int32(FILE *fp, int value)
     fwrite(&data, 1, 4, fp);
 }
 
-static int read_compressed_chunk(FILE *fp, void *buffer, int bytes_to_read)
-{
-    if (bytes_to_read > COMPRESS_BUFFER_SIZE) {
-        return 0;
-    }
-    int input_size = read_int32(fp);
-    if ((unsigned int) input_size == UNCOMPRESSED) {
-        if (fread(buffer, 1, bytes_to_read, fp) != bytes_to_read) {
-            return 0;
-        }
-    } else {
-        if (fread(compress_buffer, 1, input_size, fp) != input_size || !zip_decompress(compress_buffer, input_size, buffer, &bytes_to_read)) {
-            return 0;
-        }
-    }
-    return 1;
-}
-
 static int write_compressed_chunk(FILE *fp, const void *buffer, int bytes_to_write)
 {
     if (bytes_to_write > COMPRESS_BUFFER_SIZE) {
@@ -698,13 +701,112 @@ static int write_compressed_chunk(FILE *fp, const void *buffer, int bytes_to_wri
     return 1;
 }
 
+// Compressed pieces are encoded and decoded in parallel; the file itself is always
+// read and written sequentially in piece order, so the bytes on disk do not change.
+typedef enum {
+    CHUNK_PENDING = 0,
+    CHUNK_COMPRESSED = 1,
+    CHUNK_UNCOMPRESSED = 2,
+    CHUNK_FAILED = 3
+} chunk_state;
+
+typedef struct {
+    chunk_state state;
+    uint8_t *data;
+    int size;
+} compressed_chunk;
+
+static struct {
+    compressed_chunk chunks[MAX_PIECES];
+    char **scratch;
+} chunk_data;
+
+static void free_chunks(void)
+{
+    for (int i = 0; i < MAX_PIECES; i++) {
+        free(chunk_data.chunks[i].data);
+        chunk_data.chunks[i].data = 0;
+        chunk_data.chunks[i].state = CHUNK_PENDING;
+    }
+}
+
+static void compress_piece(void *userdata, int index, int worker)
+{
+    const file_piece *piece = &savegame_data.pieces[index];
+    compressed_chunk *chunk = &chunk_data.chunks[index];
+    if (!piece->compressed || piece->buf.size > COMPRESS_BUFFER_SIZE) {
+        return;
+    }
+    // Worker 0 is the main thread, which owns the static buffer
+    char *scratch = compress_buffer;
+    if (worker > 0) {
+        if (!chunk_data.scratch[worker]) {
+            chunk_data.scratch[worker] = (char *) malloc(COMPRESS_BUFFER_SIZE);
+            if (!chunk_data.scratch[worker]) {
+                return;
+            }
+        }
+        scratch = chunk_data.scratch[worker];
+    }
+    int output_size = COMPRESS_BUFFER_SIZE;
+    if (!zip_compress(piece->buf.data, piece->buf.size, scratch, &output_size)) {
+        chunk->state = CHUNK_UNCOMPRESSED;
+        return;
+    }
+    chunk->data = (uint8_t *) malloc(output_size);
+    if (chunk->data) {
+        memcpy(chunk->data, scratch, output_size);
+        chunk->size = output_size;
+        chunk->state = CHUNK_COMPRESSED;
+    }
+}
+
+static void decompress_piece(void *userdata, int index, int worker)
+{
+    file_piece *piece = &savegame_data.pieces[index];
+    compressed_chunk *chunk = &chunk_data.chunks[index];
+    if (chunk->state != CHUNK_COMPRESSED) {
+        return;
+    }
+    int bytes_to_read = piece->buf.size;
+    if (!zip_decompress(chunk->data, chunk->size, piece->buf.data, &bytes_to_read)) {
+        chunk->state = CHUNK_FAILED;
+    }
+}
+
+static int read_compressed_chunk(FILE *fp, compressed_chunk *chunk, void *buffer, int bytes_to_read)
+{
+    if (bytes_to_read > COMPRESS_BUFFER_SIZE) {
+        return 0;
+    }
+    int input_size = read_int32(fp);
+    if ((unsigned int) input_size == UNCOMPRESSED) {
+        if (fread(buffer, 1, bytes_to_read, fp) != bytes_to_read) {
+            return 0;
+        }
+        chunk->state = CHUNK_UNCOMPRESSED;
+    } else {
+        if (input_size <= 0 || input_size > COMPRESS_BUFFER_SIZE) {
+            return 0;
+        }
+        chunk->data = (uint8_t *) malloc(input_size);
+        if (!chunk->data || fread(chunk->data, 1, input_size, fp) != input_size) {
+            return 0;
+        }
+        chunk->size = input_size;
+        chunk->state = CHUNK_COMPRESSED;
+    }
+    return 1;
+}
+
 static int savegame_read_from_file(FILE *fp)
 {
+    int num_read = 0;
     for (int i = 0; i < savegame_data.num_pieces; i++) {
         file_piece *piece = &savegame_data.pieces[i];
         int result = 0;
         if (piece->compressed) {
-            result = read_compressed_chunk(fp, piece->buf.data, piece->buf.size);
+            result = read_compressed_chunk(fp, &chunk_data.chunks[i], piece->buf.data, piece->buf.size);
         } else {
             result = fread(piece->buf.data, 1, piece->buf.size, fp) == piece->buf.size;
         }
@@ -712,23 +814,58 @@ static int savegame_read_from_file(FILE *fp)
         if (!result && i != (savegame_data.num_pieces - 1)) {
             log_info("Incorrect buffer size, got.", 0, result);
             log_info("Incorrect buffer size, expected." , 0,piece->buf.size);
+            free_chunks();
             return 0;
         }
+        num_read++;
     }
-    return 1;
+    system_run_parallel(decompress_piece, 0, num_read);
+
+    int ok = 1;
+    for (int i = 0; i < num_read - 1; i++) {
+        if (chunk_data.chunks[i].state == CHUNK_FAILED) {
+            log_info("Unable to decompress piece", 0, i);
+            ok = 0;
+            break;
+        }
+    }
+    free_chunks();
+    return ok;
 }
 
 static void savegame_write_to_file(FILE *fp)
 {
+    int num_workers = system_parallel_worker_count();
+    chunk_data.scratch = (char **) calloc(num_workers, sizeof(char *));
+    if (chunk_data.scratch) {
+        system_run_parallel(compress_piece, 0, savegame_data.num_pieces);
+    }
     for (int i = 0; i < savegame_data.num_pieces; i++) {
         file_piece *piece = &savegame_data.pieces[i];
-        if (piece->compressed) {
-            write_compressed_chunk(fp, piece->buf.data, piece->buf.size);
-        } else {
+        compressed_chunk *chunk = &chunk_data.chunks[i];
+        if (!piece->compressed) {
+            fwrite(piece->buf.data, 1, piece->buf.size, fp);
+        } else if (chunk->state == CHUNK_COMPRESSED) {
+            write_int32(fp, chunk->size);
+            fwrite(chunk->data, 1, chunk->size, fp);
+        } else if (chunk->state == CHUNK_UNCOMPRESSED) {
+            write_int32(fp, UNCOMPRESSED);
             fwrite(piece->buf.data, 1, piece->buf.size, fp);
+        } else {
+            // not compressed in parallel, for example when out of memory
+            write_compressed_chunk(fp, piece->buf.data, piece->buf.size);
         }
     }
+    free_chunks();
+    if (chunk_data.scratch) {
+        for (int i = 0; i < num_workers; i++) {
+            free(chunk_data.scratch[i]);
+        }
+        free(chunk_data.scratch);
+        chunk_data.scratch = 0;
+    }
 }
+
 int game_file_io_read_saved_game(const char *filename, int offset)
 {
     if (file_has_extension(filename,"svx")) {
@@ -759,6 +896,89 @@ int game_file_io_read_saved_game(const char *filename, int offset)
     return 1;
 }
 
+static uint8_t thumbnail_tile(int grid_offset)
+{
+    int terrain = map_terrain_get(grid_offset);
+    if (terrain & TERRAIN_WALL_OR_GATEHOUSE) {
+        return SAVED_GAME_THUMBNAIL_WALL;
+    } else if (terrain & (TERRAIN_BUILDING | TERRAIN_AQUEDUCT)) {
+        return SAVED_GAME_THUMBNAIL_BUILDING;
+    } else if (terrain & TERRAIN_ROAD) {
+        return SAVED_GAME_THUMBNAIL_ROAD;
+    } else if (terrain & TERRAIN_WATER) {
+        return SAVED_GAME_THUMBNAIL_WATER;
+    } else if (terrain & (TERRAIN_TREE | TERRAIN_SHRUB)) {
+        return SAVED_GAME_THUMBNAIL_TREE;
+    } else if (terrain & (TERRAIN_ROCK | TERRAIN_ELEVATION)) {
+        return SAVED_GAME_THUMBNAIL_ROCK;
+    } else {
+        return SAVED_GAME_THUMBNAIL_LAND;
+    }
+}
+
+static void write_saved_game_info(FILE *fp)
+{
+    static uint8_t data[SAVED_GAME_INFO_SIZE];
+    buffer buf;
+    buffer_init(&buf, data, SAVED_GAME_INFO_SIZE);
+    buffer_write_i32(&buf, SAVED_GAME_INFO_VERSION);
+    buffer_write_i32(&buf, game_time_year());
+    buffer_write_i32(&buf, game_time_month());
+    buffer_write_i32(&buf, city_population());
+    buffer_write_i32(&buf, city_finance_treasury());
+    buffer_write_raw(&buf, scenario_name(), SAVED_GAME_INFO_NAME_LENGTH);
+
+    int width, height;
+    map_grid_size(&width, &height);
+    int map_size = width > height ? width : height;
+    for (int y = 0; y < SAVED_GAME_THUMBNAIL_SIZE; y++) {
+        int map_y = y * map_size / SAVED_GAME_THUMBNAIL_SIZE;
+        for (int x = 0; x < SAVED_GAME_THUMBNAIL_SIZE; x++) {
+            int map_x = x * map_size / SAVED_GAME_THUMBNAIL_SIZE;
+            if (map_x < width && map_y < height) {
+                buffer_write_u8(&buf, thumbnail_tile(map_grid_offset(map_x, map_y)));
+            } else {
+                buffer_write_u8(&buf, SAVED_GAME_THUMBNAIL_OUTSIDE);
+            }
+        }
+    }
+    fwrite(data, 1, SAVED_GAME_INFO_SIZE, fp);
+    write_int32(fp, SAVED_GAME_INFO_SIZE);
+    write_int32(fp, SAVED_GAME_INFO_MARKER);
+}
+
+int game_file_io_read_saved_game_info(const char *path, saved_game_info *info)
+{
+    FILE *fp = file_open(path, "rb");
+    if (!fp) {
+        return 0;
+    }
+    uint8_t data[SAVED_GAME_INFO_SIZE];
+    int result = 0;
+    if (fseek(fp, -8, SEEK_END) == 0) {
+        int size = read_int32(fp);
+        int marker = read_int32(fp);
+        // Later versions may add fields at the end of the block
+        if (marker == SAVED_GAME_INFO_MARKER && size >= SAVED_GAME_INFO_SIZE &&
+            fseek(fp, -8 - size, SEEK_END) == 0 && fread(data, 1, SAVED_GAME_INFO_SIZE, fp) == SAVED_GAME_INFO_SIZE) {
+            buffer buf;
+            buffer_init(&buf, data, SAVED_GAME_INFO_SIZE);
+            if (buffer_read_i32(&buf) >= SAVED_GAME_INFO_VERSION) {
+                info->year = buffer_read_i32(&buf);
+                info->month = buffer_read_i32(&buf);
+                info->population = buffer_read_i32(&buf);
+                info->treasury = buffer_read_i32(&buf);
+                buffer_read_raw(&buf, info->scenario_name, SAVED_GAME_INFO_NAME_LENGTH);
+                info->scenario_name[SAVED_GAME_INFO_NAME_LENGTH - 1] = 0;
+                buffer_read_raw(&buf, info->thumbnail, SAVED_GAME_THUMBNAIL_SIZE * SAVED_GAME_THUMBNAIL_SIZE);
+                result = 1;
+            }
+        }
+    }
+    file_close(fp);
+    return result;
+}
+
 int game_file_io_write_saved_game(const char *filename)
 {
     init_savegame_data_expanded();
@@ -773,6 +993,7 @@ int game_file_io_write_saved_game(const char *filename)
         return 0;
     }
     savegame_write_to_file(fp);
+    write_saved_game_info(fp);
     file_close(fp);
     return 1;
 }
@@ -781,3 +1002,36 @@ int game_file_io_delete_saved_game(const char *filename)
 {
     return file_remove(filename);
 }
+
+int game_file_io_snapshot_size(void)
+{
+    init_savegame_data_expanded();
+    int size = 0;
+    for (int i = 0; i < savegame_data.num_pieces; i++) {
+        size += savegame_data.pieces[i].buf.size;
+    }
+    return size;
+}
+
+void game_file_io_write_snapshot(uint8_t *data)
+{
+    init_savegame_data_expanded();
+    savegame_version = SAVE_GAME_VERSION;
+    savegame_save_to_state(&savegame_data.state);
+    for (int i = 0; i < savegame_data.num_pieces; i++) {
+        const buffer *buf = &savegame_data.pieces[i].buf;
+        memcpy(data, buf->data, buf->size);
+        data += buf->size;
+    }
+}
+
+void game_file_io_read_snapshot(const uint8_t *data)
+{
+    init_savegame_data_expanded();
+    for (int i = 0; i < savegame_data.num_pieces; i++) {
+        buffer *buf = &savegame_data.pieces[i].buf;
+        memcpy(buf->data, data, buf->size);
+        data += buf->size;
+    }
+    savegame_load_from_state(&savegame_data.state);
+}
@@ -1,6 +1,39 @@
 #ifndef GAME_FILE_IO_H
 #define GAME_FILE_IO_H
 
+#include "scenario/data.h"
+
+#include <stdint.h>
+
+#define SAVED_GAME_INFO_NAME_LENGTH MAX_SCENARIO_NAME
+#define SAVED_GAME_THUMBNAIL_SIZE 64
+
+typedef enum {
+    SAVED_GAME_THUMBNAIL_OUTSIDE = 0,
+    SAVED_GAME_THUMBNAIL_LAND = 1,
+    SAVED_GAME_THUMBNAIL_WATER = 2,
+    SAVED_GAME_THUMBNAIL_TREE = 3,
+    SAVED_GAME_THUMBNAIL_ROCK = 4,
+    SAVED_GAME_THUMBNAIL_ROAD = 5,
+    SAVED_GAME_THUMBNAIL_BUILDING = 6,
+    SAVED_GAME_THUMBNAIL_WALL = 7,
+    SAVED_GAME_THUMBNAIL_MAX = 8
+} saved_game_thumbnail_tile;
+
+/**
+ * Summary of a saved game, stored uncompressed at the end of the file
+ * so it can be read without loading the game
+ */
+typedef struct {
+    int year;
+    int month;
+    int population;
+    int treasury;
+    uint8_t scenario_name[SAVED_GAME_INFO_NAME_LENGTH];
+    /** Top-down overview of the map, one saved_game_thumbnail_tile per pixel */
+    uint8_t thumbnail[SAVED_GAME_THUMBNAIL_SIZE * SAVED_GAME_THUMBNAIL_SIZE];
+} saved_game_info;
+
 int game_file_io_read_scenario(const char *filename);
 
 int game_file_io_write_scenario(const char *filename);
@@ -11,4 +44,30 @@ int game_file_io_write_saved_game(const char *filename);
 
 int game_file_io_delete_saved_game(const char *filename);
 
+/**
+ * Reads only the summary of a saved game. Does not touch any game state, so it can run on a worker thread.
+ * @param path Path of the file to read, as returned by dir_get_file()
+ * @param info Summary to fill
+ * @return Boolean true on success, false if the file does not exist or was saved without a summary
+ */
+int game_file_io_read_saved_game_info(const char *path, saved_game_info *info);
+
+/**
+ * Gets the size of a snapshot: the saved game state without compression
+ * @return Size in bytes
+ */
+int game_file_io_snapshot_size(void);
+
+/**
+ * Writes the saved game state to memory
+ * @param data Memory of at least game_file_io_snapshot_size() bytes
+ */
+void game_file_io_write_snapshot(uint8_t *data);
+
+/**
+ * Reads the saved game state from memory
+ * @param data Snapshot written by game_file_io_write_snapshot
+ */
+void game_file_io_read_snapshot(const uint8_t *data);
+
 #endif // GAME_FILE_IO_H
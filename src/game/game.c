@@ -26,6 +26,7 @@
 #include "scenario/property.h"
 #include "scenario/scenario.h"
 #include "sound/city.h"
+#include "sound/effect.h"
 #include "sound/system.h"
 #include "translation/translation.h"
 #include "window/editor/map.h"
@@ -36,6 +37,10 @@ static const time_millis MILLIS_PER_TICK_PER_SPEED[] = {
     0, 20, 35, 55, 80, 110, 160, 240, 350, 500, 700
 };
 
+// In fast forward, ticks are run until this much time has passed in the frame
+#define TURBO_MILLIS_PER_FRAME 14
+#define TURBO_MAX_TICKS_PER_FRAME 1000
+
 static time_millis last_update;
 
 static void errlog(const char *msg)
@@ -191,6 +196,9 @@ static int get_elapsed_ticks(void)
             game_speed_index = (100 - setting_game_speed()) / 10;
             if (game_speed_index >= 10) {
                 return 0;
+            } else if (game_state_is_turbo()) {
+                ticks_per_frame = TURBO_MAX_TICKS_PER_FRAME;
+                game_speed_index = 0;
             } else if (game_speed_index < 0) {
                 ticks_per_frame = setting_game_speed() / 100;
                 game_speed_index = 0;
@@ -220,6 +228,10 @@ void game_run(void)
 {
     game_animation_update();
     int num_ticks = get_elapsed_ticks();
+    time_millis start = time_get_millis();
+    // In fast forward the ticks are not drawn one by one, so their sound effects are skipped
+    int turbo = game_state_is_turbo() && num_ticks > 1;
+    sound_effect_set_muted(turbo);
     for (int i = 0; i < num_ticks; i++) {
         game_tick_run();
         game_file_write_mission_saved_game();
@@ -227,7 +239,11 @@ void game_run(void)
         if (window_is_invalid()) {
             break;
         }
+        if (turbo && time_get_millis() - start >= TURBO_MILLIS_PER_FRAME) {
+            break;
+        }
     }
+    sound_effect_set_muted(0);
 }
 
 void game_draw(void)
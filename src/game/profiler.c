@@ -0,0 +1,161 @@
+#include "profiler.h"
+
+#include "core/file.h"
+#include "figure/type.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_FIGURE_TYPES (FIGURE_HIPPODROME_HORSES + 1)
+
+static struct {
+    int enabled;
+    profiler_stats sections[PROFILER_MAX_SECTIONS];
+    profiler_stats figures[MAX_FIGURE_TYPES];
+    profiler_tick_sample current_tick;
+    struct {
+        profiler_tick_sample items[PROFILER_HISTORY_SIZE];
+        int head;
+        int size;
+    } ticks;
+    struct {
+        time_micros items[PROFILER_HISTORY_SIZE];
+        int head;
+        int size;
+    } draws;
+} data;
+
+void profiler_set_enabled(int enabled)
+{
+    if (enabled && !data.enabled) {
+        profiler_reset();
+    }
+    data.enabled = enabled;
+}
+
+int profiler_is_enabled(void)
+{
+    return data.enabled;
+}
+
+void profiler_reset(void)
+{
+    int enabled = data.enabled;
+    memset(&data, 0, sizeof(data));
+    data.enabled = enabled;
+}
+
+static void add_to_stats(profiler_stats *stats, time_micros elapsed)
+{
+    stats->total_micros += elapsed;
+    if (elapsed > stats->max_micros) {
+        stats->max_micros = elapsed;
+    }
+    stats->calls++;
+}
+
+void profiler_record(profiler_section section, time_micros start)
+{
+    time_micros elapsed = time_get_micros() - start;
+    add_to_stats(&data.sections[section], elapsed);
+    if (section < PROFILER_TICK_SLOTS) {
+        data.current_tick.slot = section;
+        data.current_tick.slot_micros = elapsed;
+    } else if (section == PROFILER_FIGURES) {
+        data.current_tick.figures_micros = elapsed;
+    } else if (section == PROFILER_DAY) {
+        data.current_tick.day_micros = elapsed;
+    } else if (section == PROFILER_CITY_DRAW) {
+        data.draws.items[data.draws.head] = elapsed;
+        data.draws.head = (data.draws.head + 1) % PROFILER_HISTORY_SIZE;
+        if (data.draws.size < PROFILER_HISTORY_SIZE) {
+            data.draws.size++;
+        }
+    }
+}
+
+void profiler_record_figure(int figure_type, time_micros start)
+{
+    if (figure_type >= 0 && figure_type < MAX_FIGURE_TYPES) {
+        add_to_stats(&data.figures[figure_type], time_get_micros() - start);
+    }
+}
+
+void profiler_end_tick(void)
+{
+    data.ticks.items[data.ticks.head] = data.current_tick;
+    data.ticks.head = (data.ticks.head + 1) % PROFILER_HISTORY_SIZE;
+    if (data.ticks.size < PROFILER_HISTORY_SIZE) {
+        data.ticks.size++;
+    }
+    memset(&data.current_tick, 0, sizeof(profiler_tick_sample));
+}
+
+const profiler_stats *profiler_get_stats(profiler_section section)
+{
+    return &data.sections[section];
+}
+
+const profiler_stats *profiler_get_figure_stats(int figure_type)
+{
+    return &data.figures[figure_type];
+}
+
+const profiler_tick_sample *profiler_get_tick_sample(int age)
+{
+    if (age < 0 || age >= data.ticks.size) {
+        return 0;
+    }
+    int index = (data.ticks.head - 1 - age + PROFILER_HISTORY_SIZE) % PROFILER_HISTORY_SIZE;
+    return &data.ticks.items[index];
+}
+
+time_micros profiler_get_draw_sample(int age)
+{
+    if (age < 0 || age >= data.draws.size) {
+        return 0;
+    }
+    int index = (data.draws.head - 1 - age + PROFILER_HISTORY_SIZE) % PROFILER_HISTORY_SIZE;
+    return data.draws.items[index];
+}
+
+static void write_stats(FILE *fp, const char *name, int id, const profiler_stats *stats)
+{
+    fprintf(fp, "%s,%d,%d,%llu,%llu\n", name, id, stats->calls,
+        (unsigned long long) stats->total_micros, (unsigned long long) stats->max_micros);
+}
+
+int profiler_dump(const char *filename)
+{
+    FILE *fp = file_open(filename, "w");
+    if (!fp) {
+        return 0;
+    }
+    fprintf(fp, "section,id,calls,total_us,max_us\n");
+    for (int i = 0; i < PROFILER_TICK_SLOTS; i++) {
+        write_stats(fp, "tick", i, &data.sections[i]);
+    }
+    write_stats(fp, "figures", 0, &data.sections[PROFILER_FIGURES]);
+    write_stats(fp, "day", 0, &data.sections[PROFILER_DAY]);
+    write_stats(fp, "city_draw", 0, &data.sections[PROFILER_CITY_DRAW]);
+    for (int i = 0; i < MAX_FIGURE_TYPES; i++) {
+        if (data.figures[i].calls) {
+            write_stats(fp, "figure_type", i, &data.figures[i]);
+        }
+    }
+
+    fprintf(fp, "\nage,slot,slot_us,figures_us,day_us\n");
+    for (int i = 0; i < data.ticks.size; i++) {
+        const profiler_tick_sample *sample = profiler_get_tick_sample(i);
+        fprintf(fp, "%d,%d,%llu,%llu,%llu\n", i, sample->slot,
+            (unsigned long long) sample->slot_micros, (unsigned long long) sample->figures_micros,
+            (unsigned long long) sample->day_micros);
+    }
+
+    fprintf(fp, "\nage,city_draw_us\n");
+    for (int i = 0; i < data.draws.size; i++) {
+        fprintf(fp, "%d,%llu\n", i, (unsigned long long) profiler_get_draw_sample(i));
+    }
+    file_close(fp);
+    return 1;
+}
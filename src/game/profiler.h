@@ -0,0 +1,110 @@
+#ifndef GAME_PROFILER_H
+#define GAME_PROFILER_H
+
+#include "core/time.h"
+
+/**
+ * @file
+ * Wall time instrumentation of the simulation and the city view.
+ */
+
+#define PROFILER_HISTORY_SIZE 256
+
+/**
+ * Profiler sections: 0-49 are the tick slots of advance_tick()
+ */
+typedef enum {
+    PROFILER_TICK_SLOTS = 50,
+    PROFILER_FIGURES = 50, /**< figure_action_handle() */
+    PROFILER_DAY = 51, /**< Day, month and year changes */
+    PROFILER_CITY_DRAW = 52, /**< widget_city_draw() */
+    PROFILER_MAX_SECTIONS = 53
+} profiler_section;
+
+typedef struct {
+    time_micros total_micros;
+    time_micros max_micros;
+    int calls;
+} profiler_stats;
+
+/**
+ * Wall time spent in a single game tick
+ */
+typedef struct {
+    int slot; /**< Tick slot 0-49 that was run */
+    time_micros slot_micros;
+    time_micros figures_micros;
+    time_micros day_micros;
+} profiler_tick_sample;
+
+/**
+ * Enables or disables profiling. The counters and history are reset when profiling gets enabled.
+ * @param enabled Whether profiling should be enabled
+ */
+void profiler_set_enabled(int enabled);
+
+/**
+ * @return Whether profiling is enabled
+ */
+int profiler_is_enabled(void);
+
+/**
+ * Resets all counters and the history
+ */
+void profiler_reset(void);
+
+/**
+ * Records the wall time of a section
+ * @param section Section to record
+ * @param start Time returned by time_get_micros() when the section started
+ */
+void profiler_record(profiler_section section, time_micros start);
+
+/**
+ * Records the wall time of a single figure action
+ * @param figure_type Type of the figure
+ * @param start Time returned by time_get_micros() when the action started
+ */
+void profiler_record_figure(int figure_type, time_micros start);
+
+/**
+ * Closes the current tick and stores it in the tick history
+ */
+void profiler_end_tick(void);
+
+/**
+ * Gets the accumulated wall time of a section
+ * @param section Section
+ * @return Counters for the section
+ */
+const profiler_stats *profiler_get_stats(profiler_section section);
+
+/**
+ * Gets the accumulated wall time of a figure type
+ * @param figure_type Figure type
+ * @return Counters for the figure type
+ */
+const profiler_stats *profiler_get_figure_stats(int figure_type);
+
+/**
+ * Gets a tick from the history
+ * @param age 0 for the most recent tick, up to PROFILER_HISTORY_SIZE - 1
+ * @return Tick sample, or NULL if there are not that many ticks recorded
+ */
+const profiler_tick_sample *profiler_get_tick_sample(int age);
+
+/**
+ * Gets the wall time of a city view draw from the history
+ * @param age 0 for the most recent frame, up to PROFILER_HISTORY_SIZE - 1
+ * @return Draw time in microseconds, 0 if there are not that many frames recorded
+ */
+time_micros profiler_get_draw_sample(int age);
+
+/**
+ * Writes all counters and the history to a CSV file
+ * @param filename File to write to
+ * @return True on success
+ */
+int profiler_dump(const char *filename);
+
+#endif // GAME_PROFILER_H
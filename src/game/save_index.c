@@ -0,0 +1,247 @@
+#include "save_index.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "game/system.h"
+#include "platform/file_manager.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SCAN_BATCH_SIZE 8
+
+typedef struct {
+    char filename[FILE_NAME_MAX];
+    long long modification_time;
+    save_index_status status;
+    int needs_check;
+    int wanted;
+    int listed;
+    int is_scanning;
+    int version; /**< Changes whenever the file must be checked again, so older scans are discarded */
+    saved_game_info info;
+} index_entry;
+
+/**
+ * A file read on a worker thread. It holds copies of everything the worker needs,
+ * since the entry may be removed from the index while the file is being read.
+ */
+typedef struct {
+    char filename[FILE_NAME_MAX];
+    char path[2 * FILE_NAME_MAX];
+    int version;
+    int read_always;
+    long long modification_time;
+    int info_changed;
+    save_index_status status;
+    saved_game_info info;
+} scan_item;
+
+static struct {
+    index_entry **entries; /**< Sorted by filename */
+    int num_entries;
+    int next_scan;
+    struct {
+        scan_item items[SCAN_BATCH_SIZE];
+        int num_items;
+        int job;
+    } scan;
+} data;
+
+static int compare_entries(const void *va, const void *vb)
+{
+    return strcmp((*(index_entry * const *) va)->filename, (*(index_entry * const *) vb)->filename);
+}
+
+static index_entry *find_entry(const char *filename)
+{
+    int low = 0;
+    int high = data.num_entries - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        int result = strcmp(data.entries[middle]->filename, filename);
+        if (result == 0) {
+            return data.entries[middle];
+        } else if (result < 0) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return 0;
+}
+
+static index_entry *create_entry(const char *filename)
+{
+    index_entry *entry = (index_entry *) malloc(sizeof(index_entry));
+    if (!entry) {
+        return 0;
+    }
+    memset(entry, 0, sizeof(index_entry));
+    strncpy(entry->filename, filename, FILE_NAME_MAX - 1);
+    entry->status = SAVE_INDEX_PENDING;
+    return entry;
+}
+
+void game_save_index_set_files(const dir_listing *listing)
+{
+    index_entry **entries = 0;
+    if (listing->num_files > 0) {
+        entries = (index_entry **) malloc(listing->num_files * sizeof(index_entry *));
+        if (!entries) {
+            log_error("Unable to allocate memory for the saved game index", 0, listing->num_files);
+            return;
+        }
+    }
+    for (int i = 0; i < data.num_entries; i++) {
+        data.entries[i]->listed = 0;
+    }
+    int num_entries = 0;
+    for (int i = 0; i < listing->num_files; i++) {
+        index_entry *entry = find_entry(listing->files[i]);
+        if (entry && entry->listed) {
+            continue;
+        }
+        if (entry) {
+            entry->needs_check = 1;
+            entry->version++;
+        } else {
+            entry = create_entry(listing->files[i]);
+            if (!entry) {
+                continue;
+            }
+        }
+        entry->listed = 1;
+        entry->wanted = 0;
+        entries[num_entries++] = entry;
+    }
+    for (int i = 0; i < data.num_entries; i++) {
+        if (!data.entries[i]->listed) {
+            free(data.entries[i]);
+        }
+    }
+    free(data.entries);
+    if (num_entries > 1) {
+        qsort(entries, num_entries, sizeof(index_entry *), compare_entries);
+    }
+    data.entries = entries;
+    data.num_entries = num_entries;
+    data.next_scan = 0;
+}
+
+static int needs_scan(const index_entry *entry)
+{
+    return entry->status == SAVE_INDEX_PENDING || entry->needs_check;
+}
+
+save_index_status game_save_index_get(const char *filename, const saved_game_info **info)
+{
+    index_entry *entry = find_entry(filename);
+    if (!entry) {
+        return SAVE_INDEX_NO_INFO;
+    }
+    if (needs_scan(entry)) {
+        entry->wanted = 1;
+    }
+    if (entry->status == SAVE_INDEX_OK) {
+        *info = &entry->info;
+    }
+    return entry->status;
+}
+
+static index_entry *next_entry_to_scan(void)
+{
+    for (int i = 0; i < data.num_entries; i++) {
+        if (data.entries[i]->wanted && !data.entries[i]->is_scanning) {
+            return data.entries[i];
+        }
+    }
+    while (data.next_scan < data.num_entries) {
+        index_entry *entry = data.entries[data.next_scan];
+        if (needs_scan(entry) && !entry->is_scanning) {
+            return entry;
+        }
+        data.next_scan++;
+    }
+    return 0;
+}
+
+static void scan_items(void *userdata)
+{
+    for (int i = 0; i < data.scan.num_items; i++) {
+        scan_item *item = &data.scan.items[i];
+        long long modification_time = *item->path ? platform_file_manager_get_modification_time(item->path) : 0;
+        item->info_changed = item->read_always || modification_time != item->modification_time;
+        if (item->info_changed) {
+            item->status = *item->path && game_file_io_read_saved_game_info(item->path, &item->info) ?
+                SAVE_INDEX_OK : SAVE_INDEX_NO_INFO;
+            item->modification_time = modification_time;
+        }
+    }
+}
+
+static void add_scan_item(index_entry *entry)
+{
+    scan_item *item = &data.scan.items[data.scan.num_items++];
+    // Finding the path uses the directory index of the main thread
+    const char *path = dir_get_file(entry->filename, NOT_LOCALIZED);
+    strncpy(item->filename, entry->filename, FILE_NAME_MAX - 1);
+    item->filename[FILE_NAME_MAX - 1] = 0;
+    strncpy(item->path, path ? path : "", 2 * FILE_NAME_MAX - 1);
+    item->path[2 * FILE_NAME_MAX - 1] = 0;
+    item->version = entry->version;
+    item->read_always = entry->status == SAVE_INDEX_PENDING;
+    item->modification_time = entry->modification_time;
+    entry->is_scanning = 1;
+}
+
+static void apply_scan_items(void)
+{
+    for (int i = 0; i < data.scan.num_items; i++) {
+        const scan_item *item = &data.scan.items[i];
+        index_entry *entry = find_entry(item->filename);
+        if (!entry) {
+            continue;
+        }
+        entry->is_scanning = 0;
+        if (entry->version != item->version) {
+            continue;
+        }
+        if (item->info_changed) {
+            entry->status = item->status;
+            entry->info = item->info;
+            entry->modification_time = item->modification_time;
+        }
+        entry->needs_check = 0;
+        entry->wanted = 0;
+    }
+    data.scan.num_items = 0;
+}
+
+void game_save_index_update(void)
+{
+    if (!system_background_job_done(data.scan.job)) {
+        return;
+    }
+    data.scan.job = 0;
+    apply_scan_items();
+    index_entry *entry;
+    while (data.scan.num_items < SCAN_BATCH_SIZE && (entry = next_entry_to_scan()) != 0) {
+        add_scan_item(entry);
+    }
+    if (data.scan.num_items) {
+        data.scan.job = system_start_background_job(scan_items, 0);
+    }
+}
+
+void game_save_index_invalidate(const char *filename)
+{
+    index_entry *entry = find_entry(filename);
+    if (entry) {
+        entry->needs_check = 1;
+        entry->version++;
+        // Saving twice within the resolution of the modification time must still be noticed
+        entry->modification_time = -1;
+        data.next_scan = 0;
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef GAME_SAVE_INDEX_H
+#define GAME_SAVE_INDEX_H
+
+#include "core/dir.h"
+#include "game/file_io.h"
+
+/**
+ * @file
+ * Cached summaries of the saved games in a directory listing.
+ * The summaries are read a few at a time on a worker thread,
+ * so listing hundreds of saved games never stalls the game.
+ */
+
+typedef enum {
+    SAVE_INDEX_PENDING = 0,
+    SAVE_INDEX_NO_INFO = 1,
+    SAVE_INDEX_OK = 2
+} save_index_status;
+
+/**
+ * Sets the files to index. Summaries of files that are still listed are kept,
+ * but their modification time is checked again.
+ * @param listing Directory listing with the saved games
+ */
+void game_save_index_set_files(const dir_listing *listing);
+
+/**
+ * Gets the summary of a saved game. A pending file is read before the other pending files.
+ * @param filename File to get the summary of
+ * @param info Set to the summary if the status is SAVE_INDEX_OK
+ * @return Status of the summary, SAVE_INDEX_NO_INFO for files that are not indexed
+ */
+save_index_status game_save_index_get(const char *filename, const saved_game_info **info);
+
+/**
+ * Stores the summaries read by the worker thread and starts reading the next pending files.
+ * Must be called regularly, for example once per frame, from the main thread.
+ */
+void game_save_index_update(void);
+
+/**
+ * Forces the summary of a file to be read again, for example after overwriting it
+ * @param filename File that changed
+ */
+void game_save_index_invalidate(const char *filename);
+
+#endif // GAME_SAVE_INDEX_H
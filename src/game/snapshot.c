@@ -0,0 +1,68 @@
+#include "snapshot.h"
+
+#include "core/log.h"
+#include "game/file.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+static struct {
+    uint8_t *memory;
+    int size;
+    int first;
+    int count;
+} data;
+
+static uint8_t *snapshot_at(int index)
+{
+    return &data.memory[(size_t) ((data.first + index) % MAX_SNAPSHOTS) * data.size];
+}
+
+static int init_memory(void)
+{
+    if (data.memory) {
+        return 1;
+    }
+    data.size = game_file_snapshot_size();
+    data.memory = (uint8_t *) malloc((size_t) data.size * MAX_SNAPSHOTS);
+    if (!data.memory) {
+        log_error("Not enough memory for snapshots", 0, 0);
+        return 0;
+    }
+    return 1;
+}
+
+int game_snapshot_take(void)
+{
+    if (!init_memory()) {
+        return 0;
+    }
+    if (data.count == MAX_SNAPSHOTS) {
+        data.first = (data.first + 1) % MAX_SNAPSHOTS;
+        data.count--;
+    }
+    game_file_write_snapshot(snapshot_at(data.count));
+    data.count++;
+    return 1;
+}
+
+int game_snapshot_count(void)
+{
+    return data.count;
+}
+
+int game_snapshot_restore(int age)
+{
+    if (age < 0 || age >= data.count) {
+        return 0;
+    }
+    data.count -= age;
+    game_file_load_snapshot(snapshot_at(data.count - 1));
+    return 1;
+}
+
+void game_snapshot_clear(void)
+{
+    data.first = 0;
+    data.count = 0;
+}
@@ -0,0 +1,37 @@
+#ifndef GAME_SNAPSHOT_H
+#define GAME_SNAPSHOT_H
+
+/**
+ * @file
+ * In-memory snapshots of the game for rewinding.
+ * The most recent snapshots are kept in a ring, the oldest one is dropped when it is full.
+ */
+
+#define MAX_SNAPSHOTS 8
+
+/**
+ * Takes a snapshot of the current game
+ * @return Boolean true on success, false when there is not enough memory
+ */
+int game_snapshot_take(void);
+
+/**
+ * Gets the number of snapshots that can be restored
+ * @return Number of snapshots
+ */
+int game_snapshot_count(void);
+
+/**
+ * Restores a snapshot. The snapshots taken after it are dropped,
+ * so new snapshots branch off from the restored one.
+ * @param age Age of the snapshot: 0 for the most recent one
+ * @return Boolean true on success, false when there is no such snapshot
+ */
+int game_snapshot_restore(int age);
+
+/**
+ * Drops all snapshots, for example when another game is loaded
+ */
+void game_snapshot_clear(void);
+
+#endif // GAME_SNAPSHOT_H
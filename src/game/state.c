@@ -9,12 +9,15 @@
 
 static struct {
     int paused;
+    int turbo;
     int current_overlay;
     int previous_overlay;
-} data = {0, OVERLAY_NONE, OVERLAY_NONE};
+} data = {0, 0, OVERLAY_NONE, OVERLAY_NONE};
 
 void game_state_init(void)
 {
+    data.turbo = 0;
+
     city_victory_reset();
     map_ring_init();
 
@@ -41,6 +44,16 @@ void game_state_toggle_paused(void)
     data.paused = data.paused ? 0 : 1;
 }
 
+int game_state_is_turbo(void)
+{
+    return data.turbo;
+}
+
+void game_state_toggle_turbo(void)
+{
+    data.turbo = data.turbo ? 0 : 1;
+}
+
 int game_state_overlay(void)
 {
     return data.current_overlay;
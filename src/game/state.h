@@ -37,6 +37,14 @@ void game_state_toggle_paused(void);
 
 void game_state_unpause(void);
 
+/**
+ * Checks whether fast forward is on: as many ticks as fit in a frame are run before drawing
+ * @return Boolean true if fast forward is on
+ */
+int game_state_is_turbo(void);
+
+void game_state_toggle_turbo(void);
+
 int game_state_overlay(void);
 
 void game_state_reset_overlay(void);
@@ -131,4 +131,74 @@ void system_set_mouse_position(int *x, int *y);
  */
 void system_exit(void);
 
+/**
+ * Job callback for @link system_run_parallel @endlink
+ * @param userdata User data passed to system_run_parallel
+ * @param index Index of the job, from 0 to num_jobs - 1
+ * @param worker Index of the worker running the job, from 0 to system_parallel_worker_count() - 1.
+ *               No two jobs run on the same worker at the same time, so it can be used to pick scratch memory
+ */
+typedef void (*system_parallel_job)(void *userdata, int index, int worker);
+
+/**
+ * Gets the number of workers that run parallel jobs, including the calling thread
+ * @return Number of workers, at least 1
+ */
+int system_parallel_worker_count(void);
+
+/**
+ * Runs a number of independent jobs on the system's worker threads and waits until all of them are done.
+ * Must only be called from the main thread, and jobs may not call it themselves.
+ * @param job Job to run for every index
+ * @param userdata User data to pass to the job
+ * @param num_jobs Number of jobs to run
+ */
+void system_run_parallel(system_parallel_job job, void *userdata, int num_jobs);
+
+/**
+ * Job callback for @link system_start_background_job @endlink
+ * @param userdata User data passed to system_start_background_job
+ */
+typedef void (*system_background_job)(void *userdata);
+
+/**
+ * Starts a job on one of the system's worker threads without waiting for it.
+ * If there are no worker threads, the job runs right away on the calling thread.
+ * Must only be called from the main thread.
+ * @param job Job to run
+ * @param userdata User data to pass to the job
+ * @return Id to pass to @link system_background_job_done @endlink, or 0 if the job has already run
+ */
+int system_start_background_job(system_background_job job, void *userdata);
+
+/**
+ * Checks whether a background job has finished
+ * @param id Id returned by system_start_background_job
+ * @return 1 if the job has finished, 0 if it is still queued or running
+ */
+int system_background_job_done(int id);
+
+/**
+ * Mutex for state that parallel jobs share
+ */
+typedef struct system_mutex system_mutex;
+
+/**
+ * Creates a mutex
+ * @return The mutex, or 0 if it could not be created, in which case locking it does nothing
+ */
+system_mutex *system_mutex_create(void);
+
+/**
+ * Locks a mutex, waiting until no other thread holds it
+ * @param mutex Mutex to lock
+ */
+void system_mutex_lock(system_mutex *mutex);
+
+/**
+ * Unlocks a mutex
+ * @param mutex Mutex to unlock
+ */
+void system_mutex_unlock(system_mutex *mutex);
+
 #endif // GAME_SYSTEM_H
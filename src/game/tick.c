@@ -32,6 +32,7 @@
 #include "figure/formation.h"
 #include "figuretype/crime.h"
 #include "game/file.h"
+#include "game/profiler.h"
 #include "game/settings.h"
 #include "game/time.h"
 #include "game/tutorial.h"
@@ -53,7 +54,6 @@
 #include "scenario/random_event.h"
 #include "scenario/request.h"
 #include "sound/music.h"
-#include "widget/minimap.h"
 
 static void advance_year(void)
 {
@@ -117,11 +117,12 @@ static void advance_day(void)
 static void advance_tick(void)
 {
     // NB: these ticks are noop:
-    // 0, 9, 11, 13, 14, 15, 26, 41, 42, 47
-    switch (game_time_tick()) {
+    // 0, 3, 9, 11, 13, 14, 15, 26, 30, 41, 42, 47
+    int tick = game_time_tick();
+    time_micros start = profiler_is_enabled() ? time_get_micros() : 0;
+    switch (tick) {
         case 1: city_gods_calculate_moods(1); break;
         case 2: sound_music_update(0); break;
-        case 3: widget_minimap_invalidate(); break;
         case 4: city_emperor_update(); break;
         case 5: formation_update_all(0); break;
         case 6: map_natives_check_land(); break;
@@ -142,7 +143,6 @@ static void advance_tick(void)
         case 27: map_water_supply_update_reservoir_fountain(); break;
         case 28: map_water_supply_update_houses(); break;
         case 29: formation_update_all(1); break;
-        case 30: widget_minimap_invalidate(); break;
         case 31: building_figure_generate(); break;
         case 32: city_trade_update(); break;
         case 33: building_count_update(); city_culture_update_coverage(); break;
@@ -160,8 +160,15 @@ static void advance_tick(void)
         case 48: house_service_decay_tax_collector(); break;
         case 49: city_culture_calculate(); break;
     }
+    if (profiler_is_enabled()) {
+        profiler_record(tick, start);
+        start = time_get_micros();
+    }
     if (game_time_advance_tick()) {
         advance_day();
+        if (profiler_is_enabled()) {
+            profiler_record(PROFILER_DAY, start);
+        }
     }
 }
 
@@ -175,7 +182,14 @@ void game_tick_run(void)
     random_generate_next();
     game_undo_reduce_time_available();
     advance_tick();
-    figure_action_handle();
+    if (profiler_is_enabled()) {
+        time_micros start = time_get_micros();
+        figure_action_handle();
+        profiler_record(PROFILER_FIGURES, start);
+        profiler_end_tick();
+    } else {
+        figure_action_handle();
+    }
     scenario_earthquake_process();
     scenario_gladiator_revolt_process();
     scenario_emperor_change_process();
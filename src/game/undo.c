@@ -9,170 +9,277 @@
 #include "core/image.h"
 #include "game/resource.h"
 #include "graphics/window.h"
-#include "map/aqueduct.h"
-#include "map/building.h"
 #include "map/building_tiles.h"
-#include "map/grid.h"
-#include "map/image.h"
+#include "map/journal.h"
 #include "map/property.h"
 #include "map/routing_terrain.h"
-#include "map/sprite.h"
-#include "map/terrain.h"
 #include "scenario/earthquake.h"
 
 #include <string.h>
 
-#define MAX_UNDO_BUILDINGS 50
+#define MAX_UNDO_ACTIONS 8
+#define MAX_UNDO_BUILDINGS 1000
+#define UNDO_TIMEOUT_TICKS 500
 
+typedef struct {
+    building_type type;
+    int building_cost;
+    int timeout_ticks;
+    int first_change;
+    int first_building;
+    int num_buildings;
+} undo_action;
+
+/**
+ * Actions are kept in the order of their changes in the map journal: the actions that can be undone
+ * oldest first, followed by the actions that can be redone, the next one to redo first.
+ * Undoing or redoing an action replaces its changes in the journal by the changes that undid or redid it.
+ * The build in progress is stored after the actions that can be undone, there are no actions to redo then.
+ * The buildings of all actions share one array.
+ */
 static struct {
+    int in_progress;
     int available;
-    int ready;
-    int timeout_ticks;
-    int building_cost;
+    int num_actions;
+    int num_redo_actions;
+    undo_action actions[MAX_UNDO_ACTIONS + 1];
     int num_buildings;
-    building_type type;
     building buildings[MAX_UNDO_BUILDINGS];
 } data;
 
+static undo_action *current_action(void)
+{
+    return data.in_progress ? &data.actions[data.num_actions] : 0;
+}
+
+static int num_stored_actions(void)
+{
+    return data.num_actions + data.num_redo_actions + data.in_progress;
+}
+
+static int action_end(int index)
+{
+    return index + 1 < num_stored_actions() ? data.actions[index + 1].first_change : map_journal_position();
+}
+
+static void drop_oldest_actions(int count)
+{
+    if (count <= 0) {
+        return;
+    }
+    if (count > data.num_actions) {
+        count = data.num_actions;
+    }
+    int num_stored = num_stored_actions();
+    int first_building = data.num_buildings;
+    int first_change = map_journal_position();
+    if (count < num_stored) {
+        first_building = data.actions[count].first_building;
+        first_change = data.actions[count].first_change;
+    }
+    data.num_buildings -= first_building;
+    memmove(data.buildings, &data.buildings[first_building], data.num_buildings * sizeof(building));
+    for (int i = count; i < num_stored; i++) {
+        data.actions[i - count] = data.actions[i];
+        data.actions[i - count].first_building -= first_building;
+    }
+    data.num_actions -= count;
+    map_journal_forget_before(first_change);
+}
+
+static void drop_redo_actions_from(int index)
+{
+    if (index >= num_stored_actions() || index < data.num_actions) {
+        return;
+    }
+    map_journal_truncate(data.actions[index].first_change);
+    data.num_buildings = data.actions[index].first_building;
+    data.num_redo_actions = index - data.num_actions;
+}
+
+static void drop_forgotten_actions(void)
+{
+    int oldest_change = map_journal_oldest();
+    int count = 0;
+    while (count < data.num_actions && data.actions[count].first_change < oldest_change) {
+        count++;
+    }
+    drop_oldest_actions(count);
+}
+
 int game_can_undo(void)
 {
-    return data.ready && data.available;
+    return !data.in_progress && data.num_actions > 0;
+}
+
+int game_can_redo(void)
+{
+    return !data.in_progress && data.num_redo_actions > 0;
 }
 
 void game_undo_disable(void)
 {
     data.available = 0;
+    drop_redo_actions_from(data.num_actions);
+    drop_oldest_actions(data.num_actions);
+    if (!data.in_progress) {
+        data.num_buildings = 0;
+        map_journal_clear();
+    }
+}
+
+static building *find_building(const undo_action *action, int building_id)
+{
+    for (int i = 0; i < action->num_buildings; i++) {
+        building *b = &data.buildings[action->first_building + i];
+        if (b->id == building_id) {
+            return b;
+        }
+    }
+    return 0;
 }
 
 void game_undo_add_building(building *b)
 {
-    if (b->id <= 0) {
+    undo_action *action = current_action();
+    if (b->id <= 0 || !action || find_building(action, b->id)) {
         return;
     }
-    data.num_buildings = 0;
-    int is_on_list = 0;
-    for (int i = 0; i < MAX_UNDO_BUILDINGS; i++) {
-        if (data.buildings[i].id) {
-            data.num_buildings++;
-        }
-        if (data.buildings[i].id == b->id) {
-            is_on_list = 1;
-        }
+    if (data.num_buildings == MAX_UNDO_BUILDINGS) {
+        drop_oldest_actions(data.num_actions);
+        action = current_action();
     }
-    if (!is_on_list) {
-        for (int i = 0; i < MAX_UNDO_BUILDINGS; i++) {
-            if (!data.buildings[i].id) {
-                data.num_buildings++;
-                memcpy(&data.buildings[i], b, sizeof(building));
-                return;
-            }
-        }
+    if (data.num_buildings == MAX_UNDO_BUILDINGS) {
         data.available = 0;
+        return;
     }
+    memcpy(&data.buildings[data.num_buildings++], b, sizeof(building));
+    action->num_buildings++;
 }
 
-void game_undo_adjust_building(building * b){
-    for (int i = 0; i < MAX_UNDO_BUILDINGS; i++) {
-        if(data.buildings[i].id == b->id){
-            // found! update the building now
-            memcpy(&data.buildings[i], b, sizeof(building));
-        }
+void game_undo_adjust_building(building *b)
+{
+    undo_action *action = current_action();
+    building *copy = action ? find_building(action, b->id) : 0;
+    if (copy) {
+        memcpy(copy, b, sizeof(building));
     }
 }
 
 int game_undo_contains_building(int building_id)
 {
-    if (building_id <= 0 || !game_can_undo()) {
-        return 0;
-    }
-    if (data.num_buildings <= 0) {
+    if (building_id <= 0) {
         return 0;
     }
-    for (int i = 0; i < MAX_UNDO_BUILDINGS; i++) {
-        if (data.buildings[i].id == building_id) {
+    for (int i = 0; i < data.num_actions + data.num_redo_actions; i++) {
+        if (find_building(&data.actions[i], building_id)) {
             return 1;
         }
     }
     return 0;
 }
 
-static void clear_buildings(void)
+static void clear_current_buildings(void)
 {
-    data.num_buildings = 0;
-    memset(data.buildings, 0, MAX_UNDO_BUILDINGS * sizeof(building));
+    undo_action *action = current_action();
+    if (action) {
+        data.num_buildings = action->first_building;
+        action->num_buildings = 0;
+    }
 }
 
 int game_undo_start_build(building_type type)
 {
-    data.ready = 0;
+    game_undo_cancel_build();
+    // a new build replaces the actions that were undone
+    drop_redo_actions_from(data.num_actions);
     data.available = 1;
-    data.timeout_ticks = 0;
-    data.building_cost = 0;
-    data.type = type;
-    clear_buildings();
     for (int i = 1; i < MAX_BUILDINGS; i++) {
         building *b = building_get(i);
         if (b->state == BUILDING_STATE_UNDO) {
-            data.available = 0;
+            game_undo_disable();
             return 0;
         }
         if (b->state == BUILDING_STATE_DELETED_BY_PLAYER) {
             data.available = 0;
         }
     }
-
-    map_image_backup();
-    map_terrain_backup();
-    map_aqueduct_backup();
-    map_property_backup();
-    map_sprite_backup();
+    if (data.num_actions == MAX_UNDO_ACTIONS) {
+        drop_oldest_actions(1);
+    }
+    undo_action *action = &data.actions[data.num_actions];
+    action->type = type;
+    action->building_cost = 0;
+    action->timeout_ticks = 0;
+    action->first_change = map_journal_position();
+    action->first_building = data.num_buildings;
+    action->num_buildings = 0;
+    data.in_progress = 1;
+    map_journal_start();
 
     return 1;
 }
 
 void game_undo_restore_building_state(void)
 {
-    for (int i = 0; i < data.num_buildings; i++) {
-        if (data.buildings[i].id) {
-            building *b = building_get(data.buildings[i].id);
-            if (b->state == BUILDING_STATE_DELETED_BY_PLAYER) {
-                b->state = BUILDING_STATE_IN_USE;
-            }
-            b->is_deleted = 0;
+    undo_action *action = current_action();
+    if (!action) {
+        return;
+    }
+    for (int i = 0; i < action->num_buildings; i++) {
+        building *b = building_get(data.buildings[action->first_building + i].id);
+        if (b->state == BUILDING_STATE_DELETED_BY_PLAYER) {
+            b->state = BUILDING_STATE_IN_USE;
         }
+        b->is_deleted = 0;
     }
-    clear_buildings();
+    clear_current_buildings();
 }
 
-static void restore_map_images(void)
+void game_undo_restore_map(int include_properties)
 {
-    int map_width, map_height;
-    map_grid_size(&map_width, &map_height);
-    for (int y = 0; y < map_height; y++) {
-        for (int x = 0; x < map_width; x++) {
-            int grid_offset = map_grid_offset(x, y);
-            if (!map_building_at(grid_offset)) {
-                map_image_restore_at(grid_offset);
-            }
-        }
+    undo_action *action = current_action();
+    if (!action) {
+        return;
+    }
+    int layers = JOURNAL_TERRAIN | JOURNAL_AQUEDUCT | JOURNAL_IMAGE_WITHOUT_BUILDING;
+    if (include_properties) {
+        layers |= JOURNAL_PROPERTIES;
     }
+    map_journal_restore(action->first_change, layers);
 }
 
-void game_undo_restore_map(int include_properties)
+void game_undo_cancel_build(void)
 {
-    map_terrain_restore();
-    map_aqueduct_restore();
-    if (include_properties) {
-        map_property_restore();
+    undo_action *action = current_action();
+    if (!action) {
+        return;
     }
-    restore_map_images();
+    // the build was never finished, so its changes do not need to be undone
+    map_journal_stop();
+    map_journal_truncate(action->first_change);
+    data.num_buildings = action->first_building;
+    action->num_buildings = 0;
+    data.in_progress = 0;
 }
 
 void game_undo_finish_build(int cost)
 {
-    data.ready = 1;
-    data.timeout_ticks = 500;
-    data.building_cost = cost;
+    undo_action *action = current_action();
+    if (!action) {
+        return;
+    }
+    map_journal_stop();
+    data.in_progress = 0;
+    if (data.available) {
+        action->building_cost = cost;
+        action->timeout_ticks = UNDO_TIMEOUT_TICKS;
+        data.num_actions++;
+        drop_forgotten_actions();
+    } else {
+        // older actions cannot be undone without undoing this one first
+        game_undo_disable();
+    }
     window_invalidate();
 }
 
@@ -204,80 +311,154 @@ static void add_building_to_terrain(building *b)
     b->state = BUILDING_STATE_IN_USE;
 }
 
+static void restore_buildings(const undo_action *action)
+{
+    const building *buildings = &data.buildings[action->first_building];
+    for (int i = 0; i < action->num_buildings; i++) {
+        building *b = building_get(buildings[i].id);
+        memcpy(b, &buildings[i], sizeof(building));
+        building_mark_restored(b);
+        if (b->type == BUILDING_WAREHOUSE || b->type == BUILDING_GRANARY) {
+            if (!building_storage_restore(b->storage_id)) {
+                building_storage_reset_building_ids();
+            }
+        }
+    }
+}
+
+static int uses_marble(building_type type)
+{
+    return type == BUILDING_ORACLE || (type >= BUILDING_LARGE_TEMPLE_CERES && type <= BUILDING_LARGE_TEMPLE_VENUS);
+}
+
+static void move_actions_after(int index, int offset)
+{
+    for (int i = index + 1; i < num_stored_actions(); i++) {
+        data.actions[i].first_change += offset;
+    }
+}
+
 void game_undo_perform(void)
 {
     if (!game_can_undo()) {
         return;
     }
-    data.available = 0;
-    city_finance_process_construction(-data.building_cost);
-    if (data.type == BUILDING_CLEAR_LAND) {
-        for (int i = 0; i < data.num_buildings; i++) {
-            if (data.buildings[i].id) {
-                building *b = building_get(data.buildings[i].id);
-                memcpy(b, &data.buildings[i], sizeof(building));
-                if (b->type == BUILDING_WAREHOUSE || b->type == BUILDING_GRANARY) {
-                    if (!building_storage_restore(b->storage_id)) {
-                        building_storage_reset_building_ids();
-                    }
-                }
-                add_building_to_terrain(b);
-            }
+    int index = data.num_actions - 1;
+    undo_action *action = &data.actions[index];
+    int end = action_end(index);
+    // the changes that undo the action are recorded in its place, so they can be restored to redo it
+    map_journal_start_replacing(action->first_change, end);
+    city_finance_process_construction(-action->building_cost);
+    if (action->type == BUILDING_CLEAR_LAND) {
+        restore_buildings(action);
+        for (int i = 0; i < action->num_buildings; i++) {
+            add_building_to_terrain(building_get(data.buildings[action->first_building + i].id));
         }
-        map_terrain_restore();
-        map_aqueduct_restore();
-        map_sprite_restore();
-        map_image_restore();
-        map_property_restore();
+        map_journal_restore_range(action->first_change, end, JOURNAL_ALL_LAYERS);
         map_property_clear_constructing_and_deleted();
-    } else if (data.type == BUILDING_AQUEDUCT || data.type == BUILDING_ROAD ||
-            data.type == BUILDING_WALL) {
-        map_terrain_restore();
-        map_aqueduct_restore();
-        restore_map_images();
-    } else if (data.type == BUILDING_LOW_BRIDGE || data.type == BUILDING_SHIP_BRIDGE) {
-        map_terrain_restore();
-        map_sprite_restore();
-        restore_map_images();
-    } else if (data.type == BUILDING_PLAZA || data.type == BUILDING_GARDENS) {
-        map_terrain_restore();
-        map_aqueduct_restore();
-        map_property_restore();
-        restore_map_images();
-    } else if (data.num_buildings) {
-        if (data.type == BUILDING_DRAGGABLE_RESERVOIR) {
-            map_terrain_restore();
-            map_aqueduct_restore();
-            restore_map_images();
-        }
-        for (int i = 0; i < data.num_buildings; i++) {
-            if (data.buildings[i].id) {
-                building *b = building_get(data.buildings[i].id);
-                if (b->type == BUILDING_ORACLE || (b->type >= BUILDING_LARGE_TEMPLE_CERES && b->type <= BUILDING_LARGE_TEMPLE_VENUS)) {
-                    building_warehouses_add_resource(RESOURCE_MARBLE, 2);
-                }
-                b->state = BUILDING_STATE_UNDO;
+    } else if (action->type == BUILDING_AQUEDUCT || action->type == BUILDING_ROAD ||
+            action->type == BUILDING_WALL) {
+        map_journal_restore_range(action->first_change, end,
+            JOURNAL_TERRAIN | JOURNAL_AQUEDUCT | JOURNAL_IMAGE_WITHOUT_BUILDING);
+    } else if (action->type == BUILDING_LOW_BRIDGE || action->type == BUILDING_SHIP_BRIDGE) {
+        map_journal_restore_range(action->first_change, end,
+            JOURNAL_TERRAIN | JOURNAL_SPRITE | JOURNAL_IMAGE_WITHOUT_BUILDING);
+    } else if (action->type == BUILDING_PLAZA || action->type == BUILDING_GARDENS) {
+        map_journal_restore_range(action->first_change, end,
+            JOURNAL_TERRAIN | JOURNAL_AQUEDUCT | JOURNAL_PROPERTIES | JOURNAL_IMAGE_WITHOUT_BUILDING);
+    } else if (action->num_buildings) {
+        // the tiles are given back here, the buildings themselves are removed on the next tick
+        map_journal_restore_range(action->first_change, end, JOURNAL_ALL_LAYERS);
+        for (int i = 0; i < action->num_buildings; i++) {
+            building *b = building_get(data.buildings[action->first_building + i].id);
+            if (uses_marble(b->type)) {
+                building_warehouses_add_resource(RESOURCE_MARBLE, 2);
             }
+            b->state = BUILDING_STATE_UNDO;
         }
     }
     map_routing_update_land();
     map_routing_update_walls();
-    data.num_buildings = 0;
+    int new_end = map_journal_finish_replacing();
+    action->timeout_ticks = UNDO_TIMEOUT_TICKS;
+    data.num_actions--;
+    data.num_redo_actions++;
+    if (new_end < 0) {
+        drop_redo_actions_from(index);
+    } else {
+        move_actions_after(index, new_end - end);
+        drop_forgotten_actions();
+    }
+    window_invalidate();
 }
 
-void game_undo_reduce_time_available(void)
+static int can_redo_buildings(const undo_action *action)
 {
-    if (!game_can_undo()) {
+    const building *buildings = &data.buildings[action->first_building];
+    for (int i = 0; i < action->num_buildings; i++) {
+        const building *b = building_get(buildings[i].id);
+        if (action->type == BUILDING_CLEAR_LAND) {
+            if (b->state != BUILDING_STATE_IN_USE || b->type != buildings[i].type ||
+                b->grid_offset != buildings[i].grid_offset) {
+                return 0;
+            }
+        } else if (b->state != BUILDING_STATE_UNUSED && b->state != BUILDING_STATE_UNDO) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void game_redo_perform(void)
+{
+    if (!game_can_redo()) {
         return;
     }
-    if (data.timeout_ticks <= 0 || scenario_earthquake_is_in_progress()) {
-        data.available = 0;
-        clear_buildings();
+    int index = data.num_actions;
+    undo_action *action = &data.actions[index];
+    if (!can_redo_buildings(action)) {
+        drop_redo_actions_from(index);
         window_invalidate();
         return;
     }
-    data.timeout_ticks--;
-    switch (data.type) {
+    int end = action_end(index);
+    map_journal_start_replacing(action->first_change, end);
+    city_finance_process_construction(action->building_cost);
+    if (action->type != BUILDING_CLEAR_LAND) {
+        restore_buildings(action);
+    }
+    map_journal_restore_range(action->first_change, end, JOURNAL_ALL_LAYERS);
+    for (int i = 0; i < action->num_buildings; i++) {
+        building *b = building_get(data.buildings[action->first_building + i].id);
+        if (action->type == BUILDING_CLEAR_LAND) {
+            b->state = BUILDING_STATE_DELETED_BY_PLAYER;
+        } else if (uses_marble(b->type)) {
+            building_warehouses_remove_resource(RESOURCE_MARBLE, 2);
+        }
+    }
+    map_routing_update_land();
+    map_routing_update_walls();
+    int new_end = map_journal_finish_replacing();
+    action->timeout_ticks = UNDO_TIMEOUT_TICKS;
+    data.num_actions++;
+    data.num_redo_actions--;
+    if (new_end < 0) {
+        // the journal was full, so this action cannot be undone again
+        game_undo_disable();
+    } else {
+        move_actions_after(index, new_end - end);
+        drop_forgotten_actions();
+    }
+    window_invalidate();
+}
+
+static int is_action_still_valid(undo_action *action)
+{
+    if (action->timeout_ticks <= 0) {
+        return 0;
+    }
+    action->timeout_ticks--;
+    switch (action->type) {
         case BUILDING_CLEAR_LAND:
         case BUILDING_AQUEDUCT:
         case BUILDING_ROAD:
@@ -286,39 +467,55 @@ void game_undo_reduce_time_available(void)
         case BUILDING_SHIP_BRIDGE:
         case BUILDING_PLAZA:
         case BUILDING_GARDENS:
-            return;
+            return 1;
         default: break;
     }
-    if (data.num_buildings <= 0) {
-        data.available = 0;
+    if (action->num_buildings <= 0) {
+        return 0;
+    }
+    const building *buildings = &data.buildings[action->first_building];
+    for (int i = 0; i < action->num_buildings; i++) {
+        building *b = building_get(buildings[i].id);
+        if (action->type == BUILDING_HOUSE_VACANT_LOT && b->house_population) {
+            // no undo on a new house where people moved in
+            return 0;
+        }
+        if (b->state == BUILDING_STATE_UNDO ||
+            b->state == BUILDING_STATE_RUBBLE ||
+            b->state == BUILDING_STATE_DELETED_BY_GAME) {
+            return 0;
+        }
+        if (b->type != buildings[i].type || b->grid_offset != buildings[i].grid_offset) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void game_undo_reduce_time_available(void)
+{
+    if (!game_can_undo() && !game_can_redo()) {
+        return;
+    }
+    if (scenario_earthquake_is_in_progress()) {
+        game_undo_disable();
         window_invalidate();
         return;
     }
-    if (data.type == BUILDING_HOUSE_VACANT_LOT) {
-        for (int i = 0; i < data.num_buildings; i++) {
-            if (data.buildings[i].id && building_get(data.buildings[i].id)->house_population) {
-                // no undo on a new house where people moved in
-                data.available = 0;
-                window_invalidate();
-                return;
-            }
+    // actions undone earlier are further down the redo stack, so they time out first
+    for (int i = data.num_actions; i < data.num_actions + data.num_redo_actions; i++) {
+        if (data.actions[i].timeout_ticks-- <= 0) {
+            drop_redo_actions_from(i);
+            window_invalidate();
+            break;
         }
     }
-    for (int i = 0; i < data.num_buildings; i++) {
-        if (data.buildings[i].id) {
-            building *b = building_get(data.buildings[i].id);
-            if (b->state == BUILDING_STATE_UNDO ||
-                b->state == BUILDING_STATE_RUBBLE ||
-                b->state == BUILDING_STATE_DELETED_BY_GAME) {
-                data.available = 0;
-                window_invalidate();
-                return;
-            }
-            if (b->type != data.buildings[i].type || b->grid_offset != data.buildings[i].grid_offset) {
-                data.available = 0;
-                window_invalidate();
-                return;
-            }
+    // an action that can no longer be undone also blocks all actions before it
+    for (int i = data.num_actions - 1; i >= 0; i--) {
+        if (!is_action_still_valid(&data.actions[i])) {
+            drop_oldest_actions(i + 1);
+            window_invalidate();
+            return;
         }
     }
 }
@@ -5,6 +5,8 @@
 
 int game_can_undo(void);
 
+int game_can_redo(void);
+
 void game_undo_disable(void);
 
 void game_undo_add_building(building *b);
@@ -21,8 +23,12 @@ int game_undo_start_build(building_type type);
 
 void game_undo_finish_build(int cost);
 
+void game_undo_cancel_build(void);
+
 void game_undo_perform(void);
 
+void game_redo_perform(void);
+
 void game_undo_reduce_time_available(void);
 
 #endif // GAME_UNDO_H
@@ -0,0 +1,710 @@
+#include "blit.h"
+
+#include <stddef.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLIT_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(BLIT_HAS_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BLIT_HAS_AVX2
+#include <immintrin.h>
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+// The NEON kernels have not been verified on an ARM device yet, so they are only built on request
+#if defined(USE_NEON_BLIT) && (defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64))
+#define BLIT_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+#define ALPHA_MASK 0xff000000
+#define RGB_MASK 0x00ffffff
+
+// Every blend in this file computes (src * alpha + dst * (256 - alpha)) >> 8 per color channel
+// and leaves the alpha channel at zero, which is what the original 32-bit expressions do.
+// The intermediate values never exceed 0xff00, so 16-bit vector lanes give identical results.
+#define MIX_RB(src, dst, alpha) ((((src & 0xff00ff) * alpha + (dst & 0xff00ff) * (256 - alpha)) >> 8) & 0xff00ff)
+#define MIX_G(src, dst, alpha) ((((src & 0x00ff00) * alpha + (dst & 0x00ff00) * (256 - alpha)) >> 8) & 0x00ff00)
+
+typedef struct {
+    void (*copy_transparent)(color_t *dst, const color_t *src, int num_pixels);
+    void (*set_transparent)(color_t *dst, const color_t *src, int num_pixels, color_t color);
+    void (*and_transparent)(color_t *dst, const color_t *src, int num_pixels, color_t color);
+    void (*blend_transparent)(color_t *dst, const color_t *src, int num_pixels, color_t color);
+    void (*blend_alpha_transparent)(color_t *dst, const color_t *src, int num_pixels, color_t color);
+    void (*fill)(color_t *dst, int num_pixels, color_t color);
+    void (*and_src)(color_t *dst, const color_t *src, int num_pixels, color_t color);
+    void (*blend)(color_t *dst, int num_pixels, color_t color);
+    void (*blend_alpha)(color_t *dst, int num_pixels, color_t color);
+} blit_kernels;
+
+static void scalar_copy_transparent(color_t *dst, const color_t *src, int num_pixels)
+{
+    for (int i = 0; i < num_pixels; i++) {
+        if (src[i] != COLOR_SG2_TRANSPARENT) {
+            dst[i] = src[i];
+        }
+    }
+}
+
+static void scalar_set_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    for (int i = 0; i < num_pixels; i++) {
+        if (src[i] != COLOR_SG2_TRANSPARENT) {
+            dst[i] = color;
+        }
+    }
+}
+
+static void scalar_and_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    for (int i = 0; i < num_pixels; i++) {
+        if (src[i] != COLOR_SG2_TRANSPARENT) {
+            dst[i] = src[i] & color;
+        }
+    }
+}
+
+static void scalar_blend_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    for (int i = 0; i < num_pixels; i++) {
+        if (src[i] != COLOR_SG2_TRANSPARENT) {
+            dst[i] &= color;
+        }
+    }
+}
+
+static void scalar_blend_alpha_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    for (int i = 0; i < num_pixels; i++) {
+        if (src[i] != COLOR_SG2_TRANSPARENT) {
+            color_t alpha = src[i] >> 24;
+            if (alpha == 255) {
+                dst[i] = color;
+            } else {
+                color_t d = dst[i];
+                dst[i] = MIX_RB(color, d, alpha) | MIX_G(color, d, alpha);
+            }
+        }
+    }
+}
+
+static void scalar_fill(color_t *dst, int num_pixels, color_t color)
+{
+    for (int i = 0; i < num_pixels; i++) {
+        dst[i] = color;
+    }
+}
+
+static void scalar_and(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    for (int i = 0; i < num_pixels; i++) {
+        dst[i] = src[i] & color;
+    }
+}
+
+static void scalar_blend(color_t *dst, int num_pixels, color_t color)
+{
+    for (int i = 0; i < num_pixels; i++) {
+        dst[i] &= color;
+    }
+}
+
+static void scalar_blend_alpha(color_t *dst, int num_pixels, color_t color)
+{
+    color_t alpha = color >> 24;
+    for (int i = 0; i < num_pixels; i++) {
+        color_t d = dst[i];
+        dst[i] = MIX_RB(color, d, alpha) | MIX_G(color, d, alpha);
+    }
+}
+
+static const blit_kernels scalar_kernels = {
+    scalar_copy_transparent,
+    scalar_set_transparent,
+    scalar_and_transparent,
+    scalar_blend_transparent,
+    scalar_blend_alpha_transparent,
+    scalar_fill,
+    scalar_and,
+    scalar_blend,
+    scalar_blend_alpha
+};
+
+#ifdef BLIT_HAS_SSE2
+
+static void sse2_copy_transparent(color_t *dst, const color_t *src, int num_pixels)
+{
+    const __m128i transparent = _mm_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *) &src[i]);
+        __m128i d = _mm_loadu_si128((const __m128i *) &dst[i]);
+        __m128i keep = _mm_cmpeq_epi32(s, transparent);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, s)));
+    }
+    scalar_copy_transparent(&dst[i], &src[i], num_pixels - i);
+}
+
+static void sse2_set_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const __m128i transparent = _mm_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    const __m128i c = _mm_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *) &src[i]);
+        __m128i d = _mm_loadu_si128((const __m128i *) &dst[i]);
+        __m128i keep = _mm_cmpeq_epi32(s, transparent);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, c)));
+    }
+    scalar_set_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+static void sse2_and_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const __m128i transparent = _mm_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    const __m128i c = _mm_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *) &src[i]);
+        __m128i d = _mm_loadu_si128((const __m128i *) &dst[i]);
+        __m128i keep = _mm_cmpeq_epi32(s, transparent);
+        __m128i value = _mm_and_si128(s, c);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, value)));
+    }
+    scalar_and_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+static void sse2_blend_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const __m128i transparent = _mm_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    const __m128i c = _mm_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *) &src[i]);
+        __m128i d = _mm_loadu_si128((const __m128i *) &dst[i]);
+        // transparent pixels are and-ed with all ones
+        __m128i mask = _mm_or_si128(_mm_cmpeq_epi32(s, transparent), c);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_and_si128(d, mask));
+    }
+    scalar_blend_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+// Blends two pixels that were unpacked to 16-bit lanes
+static __m128i sse2_mix(__m128i src_times_alpha, __m128i dst, __m128i inverse_alpha)
+{
+    return _mm_srli_epi16(_mm_add_epi16(src_times_alpha, _mm_mullo_epi16(dst, inverse_alpha)), 8);
+}
+
+static void sse2_blend_alpha_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const __m128i transparent = _mm_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    const __m128i opaque = _mm_set1_epi32((int) ALPHA_MASK);
+    const __m128i rgb = _mm_set1_epi32(RGB_MASK);
+    const __m128i c = _mm_set1_epi32((int) color);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c16 = _mm_unpacklo_epi8(c, zero);
+    const __m128i full = _mm_set1_epi16(256);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *) &src[i]);
+        __m128i d = _mm_loadu_si128((const __m128i *) &dst[i]);
+        __m128i alpha32 = _mm_srli_epi32(s, 24);
+        __m128i alpha16 = _mm_or_si128(alpha32, _mm_slli_epi32(alpha32, 16));
+        __m128i alpha_lo = _mm_unpacklo_epi32(alpha16, alpha16);
+        __m128i alpha_hi = _mm_unpackhi_epi32(alpha16, alpha16);
+        __m128i mixed_lo = sse2_mix(_mm_mullo_epi16(c16, alpha_lo), _mm_unpacklo_epi8(d, zero),
+            _mm_sub_epi16(full, alpha_lo));
+        __m128i mixed_hi = sse2_mix(_mm_mullo_epi16(c16, alpha_hi), _mm_unpackhi_epi8(d, zero),
+            _mm_sub_epi16(full, alpha_hi));
+        __m128i mixed = _mm_and_si128(_mm_packus_epi16(mixed_lo, mixed_hi), rgb);
+
+        __m128i is_opaque = _mm_cmpeq_epi32(_mm_and_si128(s, opaque), opaque);
+        __m128i value = _mm_or_si128(_mm_and_si128(is_opaque, c), _mm_andnot_si128(is_opaque, mixed));
+        __m128i keep = _mm_cmpeq_epi32(s, transparent);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, value)));
+    }
+    scalar_blend_alpha_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+static void sse2_fill(color_t *dst, int num_pixels, color_t color)
+{
+    const __m128i c = _mm_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        _mm_storeu_si128((__m128i *) &dst[i], c);
+    }
+    scalar_fill(&dst[i], num_pixels - i, color);
+}
+
+static void sse2_and(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const __m128i c = _mm_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *) &src[i]);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_and_si128(s, c));
+    }
+    scalar_and(&dst[i], &src[i], num_pixels - i, color);
+}
+
+static void sse2_blend(color_t *dst, int num_pixels, color_t color)
+{
+    const __m128i c = _mm_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *) &dst[i]);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_and_si128(d, c));
+    }
+    scalar_blend(&dst[i], num_pixels - i, color);
+}
+
+static void sse2_blend_alpha(color_t *dst, int num_pixels, color_t color)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rgb = _mm_set1_epi32(RGB_MASK);
+    const __m128i alpha = _mm_set1_epi16((short) (color >> 24));
+    const __m128i inverse_alpha = _mm_set1_epi16((short) (256 - (color >> 24)));
+    const __m128i c_alpha = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32((int) color), zero), alpha);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *) &dst[i]);
+        __m128i mixed_lo = sse2_mix(c_alpha, _mm_unpacklo_epi8(d, zero), inverse_alpha);
+        __m128i mixed_hi = sse2_mix(c_alpha, _mm_unpackhi_epi8(d, zero), inverse_alpha);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_and_si128(_mm_packus_epi16(mixed_lo, mixed_hi), rgb));
+    }
+    scalar_blend_alpha(&dst[i], num_pixels - i, color);
+}
+
+static const blit_kernels sse2_kernels = {
+    sse2_copy_transparent,
+    sse2_set_transparent,
+    sse2_and_transparent,
+    sse2_blend_transparent,
+    sse2_blend_alpha_transparent,
+    sse2_fill,
+    sse2_and,
+    sse2_blend,
+    sse2_blend_alpha
+};
+
+#endif // BLIT_HAS_SSE2
+
+#ifdef BLIT_HAS_AVX2
+
+// The 256-bit unpack and pack instructions work within each 128-bit half,
+// so unpacking and packing again keeps the pixels in order.
+
+AVX2_FUNCTION static void avx2_copy_transparent(color_t *dst, const color_t *src, int num_pixels)
+{
+    const __m256i transparent = _mm256_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) &src[i]);
+        __m256i d = _mm256_loadu_si256((const __m256i *) &dst[i]);
+        __m256i keep = _mm256_cmpeq_epi32(s, transparent);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_blendv_epi8(s, d, keep));
+    }
+    sse2_copy_transparent(&dst[i], &src[i], num_pixels - i);
+}
+
+AVX2_FUNCTION static void avx2_set_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const __m256i transparent = _mm256_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    const __m256i c = _mm256_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) &src[i]);
+        __m256i d = _mm256_loadu_si256((const __m256i *) &dst[i]);
+        __m256i keep = _mm256_cmpeq_epi32(s, transparent);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_blendv_epi8(c, d, keep));
+    }
+    sse2_set_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+AVX2_FUNCTION static void avx2_and_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const __m256i transparent = _mm256_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    const __m256i c = _mm256_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) &src[i]);
+        __m256i d = _mm256_loadu_si256((const __m256i *) &dst[i]);
+        __m256i keep = _mm256_cmpeq_epi32(s, transparent);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_blendv_epi8(_mm256_and_si256(s, c), d, keep));
+    }
+    sse2_and_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+AVX2_FUNCTION static void avx2_blend_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const __m256i transparent = _mm256_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    const __m256i c = _mm256_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) &src[i]);
+        __m256i d = _mm256_loadu_si256((const __m256i *) &dst[i]);
+        __m256i mask = _mm256_or_si256(_mm256_cmpeq_epi32(s, transparent), c);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_and_si256(d, mask));
+    }
+    sse2_blend_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+AVX2_FUNCTION static __m256i avx2_mix(__m256i src_times_alpha, __m256i dst, __m256i inverse_alpha)
+{
+    return _mm256_srli_epi16(_mm256_add_epi16(src_times_alpha, _mm256_mullo_epi16(dst, inverse_alpha)), 8);
+}
+
+AVX2_FUNCTION static void avx2_blend_alpha_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const __m256i transparent = _mm256_set1_epi32((int) COLOR_SG2_TRANSPARENT);
+    const __m256i opaque = _mm256_set1_epi32((int) ALPHA_MASK);
+    const __m256i rgb = _mm256_set1_epi32(RGB_MASK);
+    const __m256i c = _mm256_set1_epi32((int) color);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i c16 = _mm256_unpacklo_epi8(c, zero);
+    const __m256i full = _mm256_set1_epi16(256);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) &src[i]);
+        __m256i d = _mm256_loadu_si256((const __m256i *) &dst[i]);
+        __m256i alpha32 = _mm256_srli_epi32(s, 24);
+        __m256i alpha16 = _mm256_or_si256(alpha32, _mm256_slli_epi32(alpha32, 16));
+        __m256i alpha_lo = _mm256_unpacklo_epi32(alpha16, alpha16);
+        __m256i alpha_hi = _mm256_unpackhi_epi32(alpha16, alpha16);
+        __m256i mixed_lo = avx2_mix(_mm256_mullo_epi16(c16, alpha_lo), _mm256_unpacklo_epi8(d, zero),
+            _mm256_sub_epi16(full, alpha_lo));
+        __m256i mixed_hi = avx2_mix(_mm256_mullo_epi16(c16, alpha_hi), _mm256_unpackhi_epi8(d, zero),
+            _mm256_sub_epi16(full, alpha_hi));
+        __m256i mixed = _mm256_and_si256(_mm256_packus_epi16(mixed_lo, mixed_hi), rgb);
+
+        __m256i is_opaque = _mm256_cmpeq_epi32(_mm256_and_si256(s, opaque), opaque);
+        __m256i value = _mm256_blendv_epi8(mixed, c, is_opaque);
+        __m256i keep = _mm256_cmpeq_epi32(s, transparent);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_blendv_epi8(value, d, keep));
+    }
+    sse2_blend_alpha_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+AVX2_FUNCTION static void avx2_fill(color_t *dst, int num_pixels, color_t color)
+{
+    const __m256i c = _mm256_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        _mm256_storeu_si256((__m256i *) &dst[i], c);
+    }
+    sse2_fill(&dst[i], num_pixels - i, color);
+}
+
+AVX2_FUNCTION static void avx2_and(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const __m256i c = _mm256_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) &src[i]);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_and_si256(s, c));
+    }
+    sse2_and(&dst[i], &src[i], num_pixels - i, color);
+}
+
+AVX2_FUNCTION static void avx2_blend(color_t *dst, int num_pixels, color_t color)
+{
+    const __m256i c = _mm256_set1_epi32((int) color);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i *) &dst[i]);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_and_si256(d, c));
+    }
+    sse2_blend(&dst[i], num_pixels - i, color);
+}
+
+AVX2_FUNCTION static void avx2_blend_alpha(color_t *dst, int num_pixels, color_t color)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i rgb = _mm256_set1_epi32(RGB_MASK);
+    const __m256i alpha = _mm256_set1_epi16((short) (color >> 24));
+    const __m256i inverse_alpha = _mm256_set1_epi16((short) (256 - (color >> 24)));
+    const __m256i c_alpha = _mm256_mullo_epi16(_mm256_unpacklo_epi8(_mm256_set1_epi32((int) color), zero), alpha);
+    int i = 0;
+    for (; i + 8 <= num_pixels; i += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i *) &dst[i]);
+        __m256i mixed_lo = avx2_mix(c_alpha, _mm256_unpacklo_epi8(d, zero), inverse_alpha);
+        __m256i mixed_hi = avx2_mix(c_alpha, _mm256_unpackhi_epi8(d, zero), inverse_alpha);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_and_si256(_mm256_packus_epi16(mixed_lo, mixed_hi), rgb));
+    }
+    sse2_blend_alpha(&dst[i], num_pixels - i, color);
+}
+
+static const blit_kernels avx2_kernels = {
+    avx2_copy_transparent,
+    avx2_set_transparent,
+    avx2_and_transparent,
+    avx2_blend_transparent,
+    avx2_blend_alpha_transparent,
+    avx2_fill,
+    avx2_and,
+    avx2_blend,
+    avx2_blend_alpha
+};
+
+#endif // BLIT_HAS_AVX2
+
+#ifdef BLIT_HAS_NEON
+
+static void neon_copy_transparent(color_t *dst, const color_t *src, int num_pixels)
+{
+    const uint32x4_t transparent = vdupq_n_u32(COLOR_SG2_TRANSPARENT);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        uint32x4_t s = vld1q_u32(&src[i]);
+        uint32x4_t d = vld1q_u32(&dst[i]);
+        vst1q_u32(&dst[i], vbslq_u32(vceqq_u32(s, transparent), d, s));
+    }
+    scalar_copy_transparent(&dst[i], &src[i], num_pixels - i);
+}
+
+static void neon_set_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const uint32x4_t transparent = vdupq_n_u32(COLOR_SG2_TRANSPARENT);
+    const uint32x4_t c = vdupq_n_u32(color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        uint32x4_t s = vld1q_u32(&src[i]);
+        uint32x4_t d = vld1q_u32(&dst[i]);
+        vst1q_u32(&dst[i], vbslq_u32(vceqq_u32(s, transparent), d, c));
+    }
+    scalar_set_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+static void neon_and_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const uint32x4_t transparent = vdupq_n_u32(COLOR_SG2_TRANSPARENT);
+    const uint32x4_t c = vdupq_n_u32(color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        uint32x4_t s = vld1q_u32(&src[i]);
+        uint32x4_t d = vld1q_u32(&dst[i]);
+        vst1q_u32(&dst[i], vbslq_u32(vceqq_u32(s, transparent), d, vandq_u32(s, c)));
+    }
+    scalar_and_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+static void neon_blend_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const uint32x4_t transparent = vdupq_n_u32(COLOR_SG2_TRANSPARENT);
+    const uint32x4_t c = vdupq_n_u32(color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        uint32x4_t s = vld1q_u32(&src[i]);
+        uint32x4_t d = vld1q_u32(&dst[i]);
+        vst1q_u32(&dst[i], vandq_u32(d, vorrq_u32(vceqq_u32(s, transparent), c)));
+    }
+    scalar_blend_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+static uint16x8_t neon_mix(uint16x8_t src, uint16x8_t dst, uint16x8_t alpha)
+{
+    uint16x8_t inverse_alpha = vsubq_u16(vdupq_n_u16(256), alpha);
+    return vshrq_n_u16(vmlaq_u16(vmulq_u16(src, alpha), dst, inverse_alpha), 8);
+}
+
+static void neon_blend_alpha_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const uint32x4_t transparent = vdupq_n_u32(COLOR_SG2_TRANSPARENT);
+    const uint32x4_t opaque = vdupq_n_u32(ALPHA_MASK);
+    const uint32x4_t rgb = vdupq_n_u32(RGB_MASK);
+    const uint32x4_t c = vdupq_n_u32(color);
+    const uint16x8_t c16 = vmovl_u8(vget_low_u8(vreinterpretq_u8_u32(c)));
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        uint32x4_t s = vld1q_u32(&src[i]);
+        uint32x4_t d = vld1q_u32(&dst[i]);
+        // copy the alpha value of each pixel to all four of its bytes
+        uint8x16_t alpha8 = vreinterpretq_u8_u32(vmulq_n_u32(vshrq_n_u32(s, 24), 0x01010101));
+        uint8x16_t d8 = vreinterpretq_u8_u32(d);
+        uint16x8_t mixed_lo = neon_mix(c16, vmovl_u8(vget_low_u8(d8)), vmovl_u8(vget_low_u8(alpha8)));
+        uint16x8_t mixed_hi = neon_mix(c16, vmovl_u8(vget_high_u8(d8)), vmovl_u8(vget_high_u8(alpha8)));
+        uint32x4_t mixed = vandq_u32(vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(mixed_lo), vmovn_u16(mixed_hi))), rgb);
+
+        uint32x4_t value = vbslq_u32(vceqq_u32(vandq_u32(s, opaque), opaque), c, mixed);
+        vst1q_u32(&dst[i], vbslq_u32(vceqq_u32(s, transparent), d, value));
+    }
+    scalar_blend_alpha_transparent(&dst[i], &src[i], num_pixels - i, color);
+}
+
+static void neon_fill(color_t *dst, int num_pixels, color_t color)
+{
+    const uint32x4_t c = vdupq_n_u32(color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        vst1q_u32(&dst[i], c);
+    }
+    scalar_fill(&dst[i], num_pixels - i, color);
+}
+
+static void neon_and(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    const uint32x4_t c = vdupq_n_u32(color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        vst1q_u32(&dst[i], vandq_u32(vld1q_u32(&src[i]), c));
+    }
+    scalar_and(&dst[i], &src[i], num_pixels - i, color);
+}
+
+static void neon_blend(color_t *dst, int num_pixels, color_t color)
+{
+    const uint32x4_t c = vdupq_n_u32(color);
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        vst1q_u32(&dst[i], vandq_u32(vld1q_u32(&dst[i]), c));
+    }
+    scalar_blend(&dst[i], num_pixels - i, color);
+}
+
+static void neon_blend_alpha(color_t *dst, int num_pixels, color_t color)
+{
+    const uint32x4_t rgb = vdupq_n_u32(RGB_MASK);
+    const uint16x8_t c16 = vmovl_u8(vget_low_u8(vreinterpretq_u8_u32(vdupq_n_u32(color))));
+    const uint16x8_t alpha = vdupq_n_u16((uint16_t) (color >> 24));
+    int i = 0;
+    for (; i + 4 <= num_pixels; i += 4) {
+        uint8x16_t d8 = vreinterpretq_u8_u32(vld1q_u32(&dst[i]));
+        uint16x8_t mixed_lo = neon_mix(c16, vmovl_u8(vget_low_u8(d8)), alpha);
+        uint16x8_t mixed_hi = neon_mix(c16, vmovl_u8(vget_high_u8(d8)), alpha);
+        uint32x4_t mixed = vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(mixed_lo), vmovn_u16(mixed_hi)));
+        vst1q_u32(&dst[i], vandq_u32(mixed, rgb));
+    }
+    scalar_blend_alpha(&dst[i], num_pixels - i, color);
+}
+
+static const blit_kernels neon_kernels = {
+    neon_copy_transparent,
+    neon_set_transparent,
+    neon_and_transparent,
+    neon_blend_transparent,
+    neon_blend_alpha_transparent,
+    neon_fill,
+    neon_and,
+    neon_blend,
+    neon_blend_alpha
+};
+
+#endif // BLIT_HAS_NEON
+
+static struct {
+    blit_implementation implementation;
+    const blit_kernels *kernels;
+} data = { BLIT_SCALAR, &scalar_kernels };
+
+static const blit_kernels *get_kernels(blit_implementation implementation)
+{
+    switch (implementation) {
+        case BLIT_SCALAR:
+            return &scalar_kernels;
+#ifdef BLIT_HAS_SSE2
+        case BLIT_SSE2:
+            return &sse2_kernels;
+#endif
+#ifdef BLIT_HAS_AVX2
+        case BLIT_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &avx2_kernels : 0;
+#endif
+#ifdef BLIT_HAS_NEON
+        case BLIT_NEON:
+            return &neon_kernels;
+#endif
+        default:
+            return 0;
+    }
+}
+
+void blit_init(void)
+{
+    for (int i = BLIT_MAX - 1; i > BLIT_SCALAR; i--) {
+        if (blit_use((blit_implementation) i)) {
+            return;
+        }
+    }
+    blit_use(BLIT_SCALAR);
+}
+
+int blit_is_supported(blit_implementation implementation)
+{
+    return get_kernels(implementation) != 0;
+}
+
+int blit_use(blit_implementation implementation)
+{
+    const blit_kernels *kernels = get_kernels(implementation);
+    if (!kernels) {
+        return 0;
+    }
+    data.implementation = implementation;
+    data.kernels = kernels;
+    return 1;
+}
+
+blit_implementation blit_get_implementation(void)
+{
+    return data.implementation;
+}
+
+const char *blit_implementation_name(blit_implementation implementation)
+{
+    switch (implementation) {
+        case BLIT_SCALAR: return "scalar";
+        case BLIT_SSE2: return "sse2";
+        case BLIT_AVX2: return "avx2";
+        case BLIT_NEON: return "neon";
+        default: return "unknown";
+    }
+}
+
+void blit_copy_transparent(color_t *dst, const color_t *src, int num_pixels)
+{
+    data.kernels->copy_transparent(dst, src, num_pixels);
+}
+
+void blit_set_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    data.kernels->set_transparent(dst, src, num_pixels, color);
+}
+
+void blit_and_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    data.kernels->and_transparent(dst, src, num_pixels, color);
+}
+
+void blit_blend_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    data.kernels->blend_transparent(dst, src, num_pixels, color);
+}
+
+void blit_blend_alpha_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    data.kernels->blend_alpha_transparent(dst, src, num_pixels, color);
+}
+
+void blit_fill(color_t *dst, int num_pixels, color_t color)
+{
+    data.kernels->fill(dst, num_pixels, color);
+}
+
+void blit_and(color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    data.kernels->and_src(dst, src, num_pixels, color);
+}
+
+void blit_blend(color_t *dst, int num_pixels, color_t color)
+{
+    data.kernels->blend(dst, num_pixels, color);
+}
+
+void blit_blend_alpha(color_t *dst, int num_pixels, color_t color)
+{
+    data.kernels->blend_alpha(dst, num_pixels, color);
+}
@@ -0,0 +1,130 @@
+#ifndef GRAPHICS_BLIT_H
+#define GRAPHICS_BLIT_H
+
+#include "graphics/color.h"
+
+/**
+ * @file
+ * Pixel run kernels used by the image drawing functions.
+ * Every implementation produces exactly the same pixels as the scalar one.
+ */
+
+typedef enum {
+    BLIT_SCALAR = 0,
+    BLIT_SSE2 = 1,
+    BLIT_AVX2 = 2,
+    BLIT_NEON = 3,
+    BLIT_MAX = 4
+} blit_implementation;
+
+/**
+ * Selects the fastest implementation supported by the CPU
+ */
+void blit_init(void);
+
+/**
+ * Checks whether an implementation is compiled in and supported by the CPU
+ * @param implementation Implementation to check
+ * @return Boolean true if it can be used
+ */
+int blit_is_supported(blit_implementation implementation);
+
+/**
+ * Forces a specific implementation
+ * @param implementation Implementation to use
+ * @return Boolean true if the implementation is now used, false if it is not supported
+ */
+int blit_use(blit_implementation implementation);
+
+/**
+ * Gets the implementation currently in use
+ * @return Implementation
+ */
+blit_implementation blit_get_implementation(void);
+
+/**
+ * Gets the name of an implementation
+ * @param implementation Implementation
+ * @return Name
+ */
+const char *blit_implementation_name(blit_implementation implementation);
+
+/**
+ * Copies the pixels that are not COLOR_SG2_TRANSPARENT
+ * @param dst Destination pixels
+ * @param src Source pixels
+ * @param num_pixels Number of pixels
+ */
+void blit_copy_transparent(color_t *dst, const color_t *src, int num_pixels);
+
+/**
+ * Sets a color wherever the source pixel is not transparent
+ * @param dst Destination pixels
+ * @param src Source pixels
+ * @param num_pixels Number of pixels
+ * @param color Color to set
+ */
+void blit_set_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color);
+
+/**
+ * Copies the non-transparent source pixels masked with a color
+ * @param dst Destination pixels
+ * @param src Source pixels
+ * @param num_pixels Number of pixels
+ * @param color Color mask
+ */
+void blit_and_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color);
+
+/**
+ * Masks the destination with a color wherever the source pixel is not transparent
+ * @param dst Destination pixels
+ * @param src Source pixels
+ * @param num_pixels Number of pixels
+ * @param color Color mask
+ */
+void blit_blend_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color);
+
+/**
+ * Blends a color into the destination wherever the source pixel is not transparent,
+ * using the alpha value of each source pixel
+ * @param dst Destination pixels
+ * @param src Source pixels, only the alpha channel is used
+ * @param num_pixels Number of pixels
+ * @param color Color to blend
+ */
+void blit_blend_alpha_transparent(color_t *dst, const color_t *src, int num_pixels, color_t color);
+
+/**
+ * Fills the destination with a color
+ * @param dst Destination pixels
+ * @param num_pixels Number of pixels
+ * @param color Color
+ */
+void blit_fill(color_t *dst, int num_pixels, color_t color);
+
+/**
+ * Copies the source pixels masked with a color
+ * @param dst Destination pixels
+ * @param src Source pixels
+ * @param num_pixels Number of pixels
+ * @param color Color mask
+ */
+void blit_and(color_t *dst, const color_t *src, int num_pixels, color_t color);
+
+/**
+ * Masks the destination pixels with a color
+ * @param dst Destination pixels
+ * @param num_pixels Number of pixels
+ * @param color Color mask
+ */
+void blit_blend(color_t *dst, int num_pixels, color_t color);
+
+/**
+ * Blends a color into the destination using the color's own alpha value
+ * @param dst Destination pixels
+ * @param num_pixels Number of pixels
+ * @param color Color to blend, alpha must not be 0 or 255
+ */
+void blit_blend_alpha(color_t *dst, int num_pixels, color_t color);
+
+#endif // GRAPHICS_BLIT_H
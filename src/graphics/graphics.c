@@ -2,6 +2,7 @@
 
 #include "city/view.h"
 #include "core/config.h"
+#include "graphics/blit.h"
 #include "graphics/color.h"
 #include "graphics/menu.h"
 #include "graphics/screen.h"
@@ -16,22 +17,29 @@ static struct {
     color_t *pixels;
     int width;
     int height;
-} canvas[2];
+} canvas[3];
 
-static struct {
+// The drawing state is kept per thread so the city can be drawn in bands on several threads
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+static THREAD_LOCAL struct {
     int x_start;
     int x_end;
     int y_start;
     int y_end;
 } clip_rectangle = {0, 800, 0, 600};
 
-static struct {
+static THREAD_LOCAL struct {
     int x;
     int y;
 } translation;
 
-static clip_info clip;
-static canvas_type active_canvas;
+static THREAD_LOCAL clip_info clip;
+static THREAD_LOCAL canvas_type active_canvas;
 
 #ifdef __vita__
 extern vita2d_texture *tex_buffer_ui;
@@ -62,6 +70,7 @@ void graphics_init_canvas(int width, int height)
     canvas[CANVAS_CITY].width = width * 2;
     canvas[CANVAS_CITY].height = height * 2;
 
+    blit_init();
     graphics_clear_screens();
     graphics_set_clip_rectangle(0, 0, width, height);
 }
@@ -80,6 +89,29 @@ void graphics_set_active_canvas(canvas_type type)
     graphics_reset_clip_rectangle();
 }
 
+void graphics_set_custom_canvas(color_t *pixels, int width, int height)
+{
+    canvas[CANVAS_CUSTOM].pixels = pixels;
+    canvas[CANVAS_CUSTOM].width = width;
+    canvas[CANVAS_CUSTOM].height = height;
+    graphics_set_active_canvas(CANVAS_CUSTOM);
+}
+
+void graphics_get_state(graphics_state *state)
+{
+    state->canvas = active_canvas;
+    state->translation_x = translation.x;
+    state->translation_y = translation.y;
+}
+
+void graphics_set_state(const graphics_state *state)
+{
+    active_canvas = state->canvas;
+    translation.x = state->translation_x;
+    translation.y = state->translation_y;
+    graphics_reset_clip_rectangle();
+}
+
 static void translate_clip(int dx, int dy)
 {
     clip_rectangle.x_start -= dx;
@@ -239,7 +271,7 @@ color_t *graphics_get_pixel(int x, int y)
     if (active_canvas == CANVAS_UI) {
         return &canvas[CANVAS_UI].pixels[(translation.y + y) * canvas[CANVAS_UI].width + translation.x + x];
     } else {
-        return &canvas[CANVAS_CITY].pixels[y * canvas[CANVAS_CITY].width + x];
+        return &canvas[active_canvas].pixels[y * canvas[active_canvas].width + x];
     }
 }
 
@@ -5,7 +5,8 @@
 
 typedef enum {
     CANVAS_UI = 0,
-    CANVAS_CITY = 1
+    CANVAS_CITY = 1,
+    CANVAS_CUSTOM = 2
 } canvas_type;
 
 typedef enum {
@@ -30,9 +31,23 @@ typedef struct {
     int is_visible;
 } clip_info;
 
+/**
+ * Drawing state of a thread. Worker threads start with the default state,
+ * so jobs that draw take over the state of the thread that started them.
+ */
+typedef struct {
+    canvas_type canvas;
+    int translation_x;
+    int translation_y;
+} graphics_state;
+
 void graphics_init_canvas(int width, int height);
 const void *graphics_canvas(canvas_type type);
 void graphics_set_active_canvas(canvas_type type);
+void graphics_set_custom_canvas(color_t *pixels, int width, int height);
+
+void graphics_get_state(graphics_state *state);
+void graphics_set_state(const graphics_state *state);
 
 void graphics_in_dialog(void);
 void graphics_reset_dialog(void);
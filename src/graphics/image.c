@@ -1,6 +1,7 @@
 #include "image.h"
 
 #include "core/log.h"
+#include "graphics/blit.h"
 #include "graphics/graphics.h"
 #include "graphics/screen.h"
 
@@ -10,8 +11,6 @@
 #define FOOTPRINT_HEIGHT 30
 
 #define COMPONENT(c, shift) ((c >> shift) & 0xff)
-#define MIX_RB(src, dst, alpha) ((((src & 0xff00ff) * alpha + (dst & 0xff00ff) * (256 - alpha)) >> 8) & 0xff00ff)
-#define MIX_G(src, dst, alpha) ((((src & 0x00ff00) * alpha + (dst & 0x00ff00) * (256 - alpha)) >> 8) & 0x00ff00)
 
 typedef enum {
     DRAW_TYPE_SET,
@@ -41,56 +40,23 @@ static void draw_uncompressed(const image *img, const color_t *data, int x_offse
     for (int y = clip->clipped_pixels_top; y < img->height - clip->clipped_pixels_bottom; y++) {
         data += clip->clipped_pixels_left;
         color_t *dst = graphics_get_pixel(x_offset + clip->clipped_pixels_left, y_offset + y);
-        int x_max = img->width - clip->clipped_pixels_right;
+        int num_pixels = img->width - clip->clipped_pixels_right - clip->clipped_pixels_left;
         if (type == DRAW_TYPE_NONE) {
             if (img->draw.type == IMAGE_TYPE_WITH_TRANSPARENCY || img->draw.is_external) { // can be transparent
-                for (int x = clip->clipped_pixels_left; x < x_max; x++, dst++) {
-                    if (*data != COLOR_SG2_TRANSPARENT) {
-                        *dst = *data;
-                    }
-                    data++;
-                }
+                blit_copy_transparent(dst, data, num_pixels);
             } else {
-                int num_pixels = x_max - clip->clipped_pixels_left;
                 memcpy(dst, data, num_pixels * sizeof(color_t));
-                data += num_pixels;
             }
         } else if (type == DRAW_TYPE_SET) {
-            for (int x = clip->clipped_pixels_left; x < x_max; x++, dst++) {
-                if (*data != COLOR_SG2_TRANSPARENT) {
-                    *dst = color;
-                }
-                data++;
-            }
+            blit_set_transparent(dst, data, num_pixels, color);
         } else if (type == DRAW_TYPE_AND) {
-            for (int x = clip->clipped_pixels_left; x < x_max; x++, dst++) {
-                if (*data != COLOR_SG2_TRANSPARENT) {
-                    *dst = *data & color;
-                }
-                data++;
-            }
+            blit_and_transparent(dst, data, num_pixels, color);
         } else if (type == DRAW_TYPE_BLEND) {
-            for (int x = clip->clipped_pixels_left; x < x_max; x++, dst++) {
-                if (*data != COLOR_SG2_TRANSPARENT) {
-                    *dst &= color;
-                }
-                data++;
-            }
+            blit_blend_transparent(dst, data, num_pixels, color);
         } else if (type == DRAW_TYPE_BLEND_ALPHA) {
-            for (int x = clip->clipped_pixels_left; x < x_max; x++, dst++) {
-                if (*data != COLOR_SG2_TRANSPARENT) {
-                    color_t alpha = COMPONENT(*data, 24);
-                    if (alpha == 255) {
-                        *dst = color;
-                    } else {
-                        color_t s = color;
-                        color_t d = *dst;
-                        *dst = MIX_RB(s, d, alpha) | MIX_G(s, d, alpha);
-                    }
-                }
-                data++;
-            }
+            blit_blend_alpha_transparent(dst, data, num_pixels, color);
         }
+        data += num_pixels;
         data += clip->clipped_pixels_right;
     }
 }
@@ -164,11 +130,7 @@ static void draw_compressed_set(const image *img, const color_t *data, int x_off
                 color_t *dst = graphics_get_pixel(x_offset + x, y_offset + y);
                 if (unclipped) {
                     x += b;
-                    while (b) {
-                        *dst = color;
-                        dst++;
-                        b--;
-                    }
+                    blit_fill(dst, b, color);
                 } else {
                     while (b) {
                         if (x >= clip->clipped_pixels_left && x < img->width - clip->clipped_pixels_right) {
@@ -211,12 +173,7 @@ static void draw_compressed_and(const image *img, const color_t *data, int x_off
                 color_t *dst = graphics_get_pixel(x_offset + x, y_offset + y);
                 if (unclipped) {
                     x += b;
-                    while (b) {
-                        *dst = *pixels & color;
-                        dst++;
-                        pixels++;
-                        b--;
-                    }
+                    blit_and(dst, pixels, b, color);
                 } else {
                     while (b) {
                         if (x >= clip->clipped_pixels_left && x < img->width - clip->clipped_pixels_right) {
@@ -258,11 +215,7 @@ static void draw_compressed_blend(const image *img, const color_t *data, int x_o
                 color_t *dst = graphics_get_pixel(x_offset + x, y_offset + y);
                 if (unclipped) {
                     x += b;
-                    while (b) {
-                        *dst &= color;
-                        dst++;
-                        b--;
-                    }
+                    blit_blend(dst, b, color);
                 } else {
                     while (b) {
                         if (x >= clip->clipped_pixels_left && x < img->width - clip->clipped_pixels_right) {
@@ -316,13 +269,8 @@ static void draw_compressed_blend_alpha(const image *img, const color_t *data, i
                 data += b;
                 if (unclipped) {
                     x += b;
-                    while (b) {
-                        color_t d = *dst;
-                        *dst = (((src_rb + (d & 0xff00ff) * alpha_dst) & 0xff00ff00) |
-                                ((src_g  + (d & 0x00ff00) * alpha_dst) & 0x00ff0000)) >> 8;
-                        b--;
-                        dst++;
-                    }
+                    blit_blend_alpha(dst, b, color);
+                    dst += b;
                 } else {
                     while (b) {
                         if (x >= clip->clipped_pixels_left && x < img->width - clip->clipped_pixels_right) {
@@ -428,10 +376,8 @@ static void draw_footprint_tile(const color_t *data, int x_offset, int y_offset,
             memcpy(buffer, src, x_max * sizeof(color_t));
             src += x_max + x_pixel_advance;
         } else {
-            for (int x = 0; x < x_max; x++, buffer++, src++) {
-                *buffer = *src & color_mask;
-            }
-            src += x_pixel_advance;
+            blit_and(buffer, src, x_max, color_mask);
+            src += x_max + x_pixel_advance;
         }
     }
 }
@@ -707,7 +653,7 @@ void image_draw_fullscreen_background(int image_id)
 void image_draw_isometric_footprint(int image_id, int x, int y, color_t color_mask)
 {
     const image *img = image_get(image_id);
-    if (img->draw.type != IMAGE_TYPE_ISOMETRIC) {
+    if (img->draw.type != IMAGE_TYPE_ISOMETRIC || !image_data(image_id)) {
         return;
     }
     switch (img->width) {
@@ -732,7 +678,7 @@ void image_draw_isometric_footprint(int image_id, int x, int y, color_t color_ma
 void image_draw_isometric_footprint_from_draw_tile(int image_id, int x, int y, color_t color_mask)
 {
     const image *img = image_get(image_id);
-    if (img->draw.type != IMAGE_TYPE_ISOMETRIC) {
+    if (img->draw.type != IMAGE_TYPE_ISOMETRIC || !image_data(image_id)) {
         return;
     }
     switch (img->width) {
@@ -763,7 +709,11 @@ void image_draw_isometric_top(int image_id, int x, int y, color_t color_mask)
     if (!img->draw.has_compressed_part) {
         return;
     }
-    const color_t *data = &image_data(image_id)[img->draw.uncompressed_length];
+    const color_t *data = image_data(image_id);
+    if (!data) {
+        return;
+    }
+    data += img->draw.uncompressed_length;
 
     int height = img->height;
     switch (img->width) {
@@ -808,7 +758,11 @@ void image_draw_isometric_top_from_draw_tile(int image_id, int x, int y, color_t
     if (!img->draw.has_compressed_part) {
         return;
     }
-    const color_t *data = &image_data(image_id)[img->draw.uncompressed_length];
+    const color_t *data = image_data(image_id);
+    if (!data) {
+        return;
+    }
+    data += img->draw.uncompressed_length;
 
     int height = img->height;
     switch (img->width) {
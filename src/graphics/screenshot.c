@@ -24,6 +24,7 @@
 #define TILE_Y_SIZE 30
 #define IMAGE_HEIGHT_CHUNK TILE_Y_SIZE
 #define IMAGE_BYTES_PER_PIXEL 3
+#define CITY_BAND_HEIGHT (4 * IMAGE_HEIGHT_CHUNK)
 
 enum {
     FULL_CITY_SCREENSHOT = 0,
@@ -49,6 +50,27 @@ static struct {
     png_infop info_ptr;
 } image;
 
+// The full city is drawn in blocks of horizontal bands, one band per worker, one block per frame.
+// While a block is drawn on the main thread, a background job encodes the previous block, so two
+// blocks are kept in memory.
+static struct {
+    int in_progress;
+    char filename[FILE_NAME_MAX];
+    int map_width;
+    int map_height;
+    int width;
+    int num_bands;
+    color_t *blocks[2];
+    int drawing_block;
+    int drawn_rows;
+    int encoding_rows;
+    int encoding_job;
+    int base_width;
+    int current_height;
+    int max_height;
+    int error;
+} city_render;
+
 static void image_free(void)
 {
     image.width = 0;
@@ -140,12 +162,12 @@ static int image_request_rows(void)
     return 0;
 }
 
-static int image_write_rows(const color_t *canvas, int canvas_width)
+static int image_write_rows(const color_t *canvas, int canvas_width, int num_rows)
 {
     if (setjmp(png_jmpbuf(image.png_ptr))) {
         return 0;
     }
-    for (int y = 0; y < image.rows_in_memory; ++y) {
+    for (int y = 0; y < num_rows; ++y) {
         uint8_t *pixel = image.pixels;
         for (int x = 0; x < image.width; x++) {
             color_t input = canvas[y * canvas_width + x];
@@ -176,7 +198,7 @@ static int image_write_canvas(void)
     int current_height = image_set_loop_height_limits(0, image.height);
     int size;
     while ((size = image_request_rows())) {
-        if (!image_write_rows(canvas + current_height * image.width, image.width)) {
+        if (!image_write_rows(canvas + current_height * image.width, image.width, size)) {
             free(screen_buffer);
             return 0;
         }
@@ -193,6 +215,10 @@ static void image_finish(void)
 
 static void create_window_screenshot(void)
 {
+    if (city_render.in_progress) {
+        log_info("A full city screenshot is still being saved", 0, 0);
+        return;
+    }
     int width = screen_width();
     int height = screen_height();
 
@@ -219,72 +245,169 @@ static void create_window_screenshot(void)
     image_free();
 }
 
-static void create_full_city_screenshot(void)
+static void city_render_free(void)
 {
-    if (!window_is(WINDOW_CITY) && !window_is(WINDOW_CITY_MILITARY)) {
-        return;
-    }
-    pixel_offset original_camera_pixels;
-    city_view_get_camera_in_pixels(&original_camera_pixels.x, &original_camera_pixels.y);
-    int width = screen_width();
-    int height = screen_height();
+    free(city_render.blocks[0]);
+    free(city_render.blocks[1]);
+    city_render.blocks[0] = 0;
+    city_render.blocks[1] = 0;
+    city_render.in_progress = 0;
+}
 
-    int city_width_pixels = map_grid_width() * TILE_X_SIZE;
-    int city_height_pixels = map_grid_height() * TILE_Y_SIZE;
+static int city_render_create(int width)
+{
+    // One worker is left for encoding
+    int num_bands = system_parallel_worker_count() - 1;
+    city_render.num_bands = num_bands > 1 ? num_bands : 1;
+    city_render.width = width;
+    city_render.drawing_block = 0;
+    city_render.drawn_rows = 0;
+    city_render.encoding_rows = 0;
+    city_render.encoding_job = 0;
+    city_render.error = 0;
+    size_t block_size = (size_t) width * CITY_BAND_HEIGHT * city_render.num_bands * sizeof(color_t);
+    city_render.blocks[0] = (color_t *) malloc(block_size);
+    city_render.blocks[1] = (color_t *) malloc(block_size);
+    if (!city_render.blocks[0] || !city_render.blocks[1]) {
+        city_render_free();
+        return 0;
+    }
+    return 1;
+}
 
-    if (!image_create(city_width_pixels, city_height_pixels + TILE_Y_SIZE, IMAGE_HEIGHT_CHUNK)) {
-        log_error("Unable to set memory for full city screenshot", 0, 0);
-        return;
+static void draw_city_band(void *userdata, int index, int worker)
+{
+    int y_start = index * CITY_BAND_HEIGHT;
+    int y_end = y_start + CITY_BAND_HEIGHT;
+    if (y_end > city_render.drawn_rows) {
+        y_end = city_render.drawn_rows;
     }
-    const char *filename = generate_filename(FULL_CITY_SCREENSHOT);
-    if (!image_begin_io(filename) || !image_write_header()) {
-        log_error("Unable to write screenshot to:", filename, 0);
-        image_free();
+    if (y_start >= y_end) {
         return;
     }
+    color_t *pixels = city_render.blocks[city_render.drawing_block];
+    memset(&pixels[y_start * city_render.width], 0, sizeof(color_t) * city_render.width * (y_end - y_start));
+    city_without_overlay_draw_offscreen_rows(y_start, y_end);
+}
 
-    int canvas_width = city_width_pixels + (city_view_is_sidebar_collapsed() ? 40 : 160);
+// Runs on a worker thread, so it only touches the image and the block that is not being drawn
+static void encode_city_block(void *block)
+{
+    if (!image_write_rows(block, city_render.width, city_render.encoding_rows)) {
+        city_render.error = 1;
+    }
+}
+
+static void draw_city_block(void)
+{
+    int rows = city_render.max_height - city_render.current_height;
+    if (rows > CITY_BAND_HEIGHT * city_render.num_bands) {
+        rows = CITY_BAND_HEIGHT * city_render.num_bands;
+    }
+    pixel_offset original_camera_pixels;
+    city_view_get_camera_in_pixels(&original_camera_pixels.x, &original_camera_pixels.y);
     int zoom_active = config_get(CONFIG_UI_ZOOM);
     int old_scale = 100;
     if (zoom_active) {
         old_scale = city_view_get_scale();
-        city_view_set_scale(100);
         config_set(CONFIG_UI_ZOOM, 0);
+        city_view_set_scale(100);
     }
-    screen_set_resolution(canvas_width, TOP_MENU_HEIGHT + IMAGE_HEIGHT_CHUNK);
-    graphics_set_clip_rectangle(0, TOP_MENU_HEIGHT, city_width_pixels, IMAGE_HEIGHT_CHUNK);
 
-    int base_width = (GRID_SIZE * TILE_X_SIZE - city_width_pixels) / 2 + TILE_X_SIZE;
-    int max_height = (GRID_SIZE * TILE_Y_SIZE + city_height_pixels) / 2;
-    int min_height = max_height - city_height_pixels - TILE_Y_SIZE;
-    map_tile dummy_tile = { 0, 0, 0 };
-    int error = 0;
-    int current_height = image_set_loop_height_limits(min_height, max_height);
-    int size;
-    const color_t *canvas = (color_t *) graphics_canvas(CANVAS_UI) + TOP_MENU_HEIGHT * canvas_width;
-    while ((size = image_request_rows())) {
-        city_view_set_camera_from_pixel_position(base_width, current_height);
-        city_without_overlay_draw(0, 0, &dummy_tile);
-        if (!image_write_rows(canvas, canvas_width)) {
-            log_error("Error writing image", 0, 0);
-            error = 1;
-            break;
-        }
-        current_height += size;
-    }
+    // The camera is at the top of the block, exactly where it would be for drawing the block on screen
+    city_view_set_offscreen_viewport(city_render.width, rows);
+    city_view_set_camera_from_pixel_position(city_render.base_width, city_render.current_height);
+    graphics_set_custom_canvas(city_render.blocks[city_render.drawing_block], city_render.width, rows);
+    city_render.drawn_rows = rows;
+    city_without_overlay_begin_offscreen_draw();
+    system_run_parallel(draw_city_band, 0, city_render.num_bands);
+    city_without_overlay_end_offscreen_draw();
+    city_render.current_height += rows;
+
+    graphics_set_active_canvas(CANVAS_UI);
     if (zoom_active) {
         config_set(CONFIG_UI_ZOOM, 1);
         city_view_set_scale(old_scale);
     }
-    screen_set_resolution(width, height);
+    city_view_set_viewport(screen_width(), screen_height());
     city_view_set_camera_from_pixel_position(original_camera_pixels.x, original_camera_pixels.y);
-    if (!error) {
+}
+
+static void finish_full_city_screenshot(void)
+{
+    if (city_render.error) {
+        log_error("Error writing image", 0, 0);
+    } else {
         image_finish();
-        log_info("Saved full city screenshot:", filename, 0);
+        log_info("Saved full city screenshot:", city_render.filename, 0);
     }
+    city_render_free();
     image_free();
 }
 
+static void create_full_city_screenshot(void)
+{
+    if (city_render.in_progress) {
+        log_info("A full city screenshot is still being saved", 0, 0);
+        return;
+    }
+    if (!window_is(WINDOW_CITY) && !window_is(WINDOW_CITY_MILITARY)) {
+        return;
+    }
+    city_render.map_width = map_grid_width();
+    city_render.map_height = map_grid_height();
+    int city_width_pixels = city_render.map_width * TILE_X_SIZE;
+    int city_height_pixels = city_render.map_height * TILE_Y_SIZE;
+
+    if (!image_create(city_width_pixels, city_height_pixels + TILE_Y_SIZE, IMAGE_HEIGHT_CHUNK) ||
+        !city_render_create(city_width_pixels)) {
+        log_error("Unable to set memory for full city screenshot", 0, 0);
+        image_free();
+        return;
+    }
+    const char *filename = generate_filename(FULL_CITY_SCREENSHOT);
+    if (!image_begin_io(filename) || !image_write_header()) {
+        log_error("Unable to write screenshot to:", filename, 0);
+        city_render_free();
+        image_free();
+        return;
+    }
+    strncpy(city_render.filename, filename, FILE_NAME_MAX - 1);
+    city_render.base_width = (GRID_SIZE * TILE_X_SIZE - city_width_pixels) / 2 + TILE_X_SIZE;
+    city_render.max_height = (GRID_SIZE * TILE_Y_SIZE + city_height_pixels) / 2;
+    city_render.current_height = city_render.max_height - city_height_pixels - TILE_Y_SIZE;
+    city_render.in_progress = 1;
+}
+
+void graphics_update_screenshot(void)
+{
+    if (!city_render.in_progress || !system_background_job_done(city_render.encoding_job)) {
+        return;
+    }
+    city_render.encoding_job = 0;
+    if (city_render.map_width != map_grid_width() || city_render.map_height != map_grid_height()) {
+        // Another city was loaded
+        city_render.error = 1;
+    }
+    if (city_render.error ||
+        (!city_render.drawn_rows && city_render.current_height >= city_render.max_height)) {
+        finish_full_city_screenshot();
+        return;
+    }
+    if (city_render.drawn_rows) {
+        city_render.encoding_rows = city_render.drawn_rows;
+        city_render.drawn_rows = 0;
+        color_t *block = city_render.blocks[city_render.drawing_block];
+        city_render.drawing_block = 1 - city_render.drawing_block;
+        city_render.encoding_job = system_start_background_job(encode_city_block, block);
+    }
+    // Dialogs on top of the city only delay the screenshot
+    if (city_render.current_height < city_render.max_height &&
+        (window_is(WINDOW_CITY) || window_is(WINDOW_CITY_MILITARY))) {
+        draw_city_block();
+    }
+}
+
 void graphics_save_screenshot(int full_city)
 {
     if (full_city) {
@@ -3,4 +3,9 @@
 
 void graphics_save_screenshot(int full_city);
 
+/**
+ * Continues saving a full city screenshot, one part per call. Must be called once per frame.
+ */
+void graphics_update_screenshot(void);
+
 #endif // GRAPHICS_SCREENSHOT_H
@@ -38,7 +38,7 @@ void warning_draw(void)
             continue;
         }
         int top_offset = TOP_OFFSETS[i];
-        if (game_state_is_paused()) {
+        if (game_state_is_paused() || game_state_is_turbo()) {
             top_offset += 70;
         }
         int box_width = determine_width(text);
@@ -1,6 +1,9 @@
 #include "hotkey.h"
 
 #include "city/constants.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "game/profiler.h"
 #include "game/settings.h"
 #include "game/state.h"
 #include "game/system.h"
@@ -13,6 +16,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 typedef struct {
     int *action;
@@ -33,6 +37,8 @@ typedef struct {
     int resize_to;
     int save_screenshot;
     int save_city_screenshot;
+    int toggle_profiler;
+    int dump_profiler;
 } global_hotkeys;
 
 static struct {
@@ -56,6 +62,15 @@ static void add_definition(const hotkey_mapping *mapping)
         case HOTKEY_TOGGLE_PAUSE:
             def->action = &data.hotkey_state.toggle_pause;
             break;
+        case HOTKEY_TOGGLE_TURBO:
+            def->action = &data.hotkey_state.toggle_turbo;
+            break;
+        case HOTKEY_UNDO:
+            def->action = &data.hotkey_state.undo;
+            break;
+        case HOTKEY_REDO:
+            def->action = &data.hotkey_state.redo;
+            break;
         case HOTKEY_TOGGLE_OVERLAY:
             def->action = &data.hotkey_state.toggle_overlay;
             break;
@@ -212,6 +227,12 @@ static void add_definition(const hotkey_mapping *mapping)
         case HOTKEY_SAVE_CITY_SCREENSHOT:
             def->action = &data.global_hotkey_state.save_city_screenshot;
             break;
+        case HOTKEY_TOGGLE_PROFILER:
+            def->action = &data.global_hotkey_state.toggle_profiler;
+            break;
+        case HOTKEY_DUMP_PROFILER:
+            def->action = &data.global_hotkey_state.dump_profiler;
+            break;
         default:
             def->action = 0;
     }
@@ -356,6 +377,18 @@ void hotkey_key_released(key_type key, key_modifier_type modifiers)
     }
 }
 
+static void dump_profiler(void)
+{
+    char filename[FILE_NAME_MAX];
+    time_t curtime = time(NULL);
+    strftime(filename, FILE_NAME_MAX, "profile %Y-%m-%d %H.%M.%S.csv", localtime(&curtime));
+    if (profiler_dump(filename)) {
+        log_info("Saved profiler data:", filename, 0);
+    } else {
+        log_error("Unable to write profiler data to:", filename, 0);
+    }
+}
+
 static void confirm_exit(int accepted)
 {
     if (accepted) {
@@ -390,4 +423,11 @@ void hotkey_handle_global_keys(void)
     if (data.global_hotkey_state.save_city_screenshot) {
         graphics_save_screenshot(1);
     }
+    if (data.global_hotkey_state.toggle_profiler) {
+        profiler_set_enabled(!profiler_is_enabled());
+        window_invalidate();
+    }
+    if (data.global_hotkey_state.dump_profiler) {
+        dump_profiler();
+    }
 }
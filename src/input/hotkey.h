@@ -18,6 +18,9 @@ typedef struct {
     int show_overlay;
     int toggle_overlay;
     int toggle_pause;
+    int toggle_turbo;
+    int undo;
+    int redo;
     int toggle_editor_battle_info;
     int set_bookmark;
     int go_to_bookmark;
@@ -1,6 +1,8 @@
 #include "aqueduct.h"
 
 #include "map/grid.h"
+#include "map/journal.h"
+#include "map/water_supply.h"
 
 /**
  * The aqueduct grid is used in two ways:
@@ -9,8 +11,18 @@
  * This leads to some strange results
  */
 static grid_u8 aqueduct;
+// Undo does not use a backup of the grid anymore, but saved games still contain one
 static grid_u8 aqueduct_backup;
 
+static void set_aqueduct(int grid_offset, int value)
+{
+    map_journal_record(JOURNAL_AQUEDUCT, grid_offset, aqueduct.items[grid_offset]);
+    if (aqueduct.items[grid_offset] != value) {
+        map_water_supply_network_changed();
+    }
+    aqueduct.items[grid_offset] = value;
+}
+
 int map_aqueduct_at(int grid_offset)
 {
     return aqueduct.items[grid_offset];
@@ -18,23 +30,23 @@ int map_aqueduct_at(int grid_offset)
 
 void map_aqueduct_set(int grid_offset, int value)
 {
-    aqueduct.items[grid_offset] = value;
+    set_aqueduct(grid_offset, value);
 }
 
 void map_aqueduct_remove(int grid_offset)
 {
-    aqueduct.items[grid_offset] = 0;
+    set_aqueduct(grid_offset, 0);
     if (aqueduct.items[grid_offset + map_grid_delta(0, -1)] == 5) {
-        aqueduct.items[grid_offset + map_grid_delta(0, -1)] = 1;
+        set_aqueduct(grid_offset + map_grid_delta(0, -1), 1);
     }
     if (aqueduct.items[grid_offset + map_grid_delta(1, 0)] == 6) {
-        aqueduct.items[grid_offset + map_grid_delta(1, 0)] = 2;
+        set_aqueduct(grid_offset + map_grid_delta(1, 0), 2);
     }
     if (aqueduct.items[grid_offset + map_grid_delta(0, 1)] == 5) {
-        aqueduct.items[grid_offset + map_grid_delta(0, 1)] = 3;
+        set_aqueduct(grid_offset + map_grid_delta(0, 1), 3);
     }
     if (aqueduct.items[grid_offset + map_grid_delta(-1, 0)] == 6) {
-        aqueduct.items[grid_offset + map_grid_delta(-1, 0)] = 4;
+        set_aqueduct(grid_offset + map_grid_delta(-1, 0), 4);
     }
 }
 
@@ -43,16 +55,6 @@ void map_aqueduct_clear(void)
     map_grid_clear_u8(aqueduct.items);
 }
 
-void map_aqueduct_backup(void)
-{
-    map_grid_copy_u8(aqueduct.items, aqueduct_backup.items);
-}
-
-void map_aqueduct_restore(void)
-{
-    map_grid_copy_u8(aqueduct_backup.items, aqueduct.items);
-}
-
 void map_aqueduct_save_state(buffer *buf, buffer *backup)
 {
     map_grid_save_state_u8(aqueduct.items, buf);
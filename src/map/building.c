@@ -3,6 +3,9 @@
 #include "building/building.h"
 #include "core/config.h"
 #include "map/grid.h"
+#include "map/journal.h"
+#include "map/tile_changes.h"
+#include "map/water_supply.h"
 
 static grid_u16 buildings_grid;
 static grid_u8 damage_grid;
@@ -16,7 +19,12 @@ int map_building_at(int grid_offset)
 
 void map_building_set(int grid_offset, int building_id)
 {
+    map_journal_record(JOURNAL_BUILDING, grid_offset, buildings_grid.items[grid_offset]);
+    if (buildings_grid.items[grid_offset] != building_id) {
+        map_water_supply_tile_changed(grid_offset, 0);
+    }
     buildings_grid.items[grid_offset] = building_id;
+    map_tile_changes_mark(grid_offset);
 }
 
 void map_building_damage_clear(int grid_offset)
@@ -64,6 +72,7 @@ void map_building_clear(void)
     map_grid_clear_u16(buildings_grid.items);
     map_grid_clear_u8(damage_grid.items);
     map_grid_clear_u8(rubble_type_grid.items);
+    map_tile_changes_mark_all();
 }
 
 void map_clear_highlights(void)
@@ -81,6 +90,7 @@ void map_building_load_state(buffer *buildings, buffer *damage)
 {
     map_grid_load_state_u16(buildings_grid.items, buildings);
     map_grid_load_state_u8(damage_grid.items, damage);
+    map_tile_changes_mark_all();
 }
 
 int map_building_is_reservoir(int x, int y)
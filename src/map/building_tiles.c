@@ -177,12 +177,14 @@ void map_building_tiles_remove(int building_id, int x, int y)
     if (building_id && building_is_farm(b->type)) {
         size = 3;
     }
+    int removed = 0;
     for (int dy = 0; dy < size; dy++) {
         for (int dx = 0; dx < size; dx++) {
             int grid_offset = map_grid_offset(x + dx, y + dy);
             if (building_id && map_building_at(grid_offset) != building_id) {
                 continue;
             }
+            removed = 1;
             if (building_id && b->type != BUILDING_BURNING_RUIN) {
                 map_set_rubble_building_type(grid_offset, b->type);
             }
@@ -205,6 +207,10 @@ void map_building_tiles_remove(int building_id, int x, int y)
             }
         }
     }
+    if (!removed) {
+        // the tiles were already given back, for example by undo
+        return;
+    }
     map_tiles_update_region_empty_land(x, y, x + size, y + size);
     map_tiles_update_region_meadow(x, y, x + size, y + size);
     map_tiles_update_region_rubble(x, y, x + size, y + size);
@@ -3,17 +3,70 @@
 #include "building/building.h"
 #include "building/model.h"
 #include "core/calc.h"
+#include "core/log.h"
+#include "core/slot_bitmap.h"
 #include "map/data.h"
 #include "map/grid.h"
 #include "map/property.h"
 #include "map/ring.h"
 #include "map/terrain.h"
 
+#include <string.h>
+
+#define MAX_DESIRABILITY 100
+#define MAX_RANGE 6
+#define VERIFY_INTERVAL 64
+
+#define BLOCK_SIZE 8
+#define BLOCKS_PER_ROW ((GRID_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE)
+
+typedef struct {
+    int value;
+    int step;
+    int step_size;
+    int range;
+} desirability_effect;
+
+typedef enum {
+    TERRAIN_EFFECT_NONE = 0,
+    TERRAIN_EFFECT_PLAZA = 1,
+    TERRAIN_EFFECT_FAULT_LINE = 2,
+    TERRAIN_EFFECT_GARDEN = 3,
+    TERRAIN_EFFECT_RUBBLE = 4
+} terrain_effect;
+
 static grid_i8 desirability_grid;
 
+// The full update clamps the value after every ring it adds, so the result depends on the order in
+// which buildings are added. As long as the positive and the negative contributions of a tile each
+// stay within the bounds, no clamping can happen in any order, and the value is simply their sum.
+// These sums are kept up to date by only adding or removing the buildings and terrain that changed.
+// Tiles that do get clamped ("saturated") are recalculated in the original order.
+static struct {
+    int in_sync;
+    int updates_since_verify;
+    int saturated_tiles;
+    uint16_t saturated_blocks[BLOCKS_PER_ROW * BLOCKS_PER_ROW];
+    grid_i16 positive;
+    grid_i16 negative;
+    grid_u8 terrain;
+    struct {
+        int x;
+        int y;
+        int size;
+        desirability_effect effect;
+    } buildings[MAX_BUILDINGS];
+} incremental;
+
+static uint32_t applied_building_words[SLOT_BITMAP_WORDS(MAX_BUILDINGS)];
+static slot_bitmap applied_buildings = { applied_building_words, MAX_BUILDINGS, 0 };
+
+static grid_i8 verify_grid;
+
 void map_desirability_clear(void)
 {
     map_grid_clear_i8(desirability_grid.items);
+    incremental.in_sync = 0;
 }
 
 static void add_desirability_at_distance(int x, int y, int size, int distance, int desirability)
@@ -68,7 +121,7 @@ static void add_to_terrain(int x, int y, int size, int desirability, int step, i
 static void update_buildings(void)
 {
     int max_id = building_get_highest_id();
-    for (int i = 1; i <= max_id; i++) {
+    for (int i = building_next_id(0); i && i <= max_id; i = building_next_id(i)) {
         building *b = building_get(i);
         if (b->state == BUILDING_STATE_IN_USE) {
             const model_building *model = model_get_building(b->type);
@@ -120,11 +173,323 @@ static void update_terrain(void)
     }
 }
 
+
+static int is_saturated(int grid_offset)
+{
+    return incremental.positive.items[grid_offset] > MAX_DESIRABILITY ||
+        incremental.negative.items[grid_offset] < -MAX_DESIRABILITY;
+}
+
+static int block_of(int grid_offset)
+{
+    return (grid_offset / GRID_SIZE / BLOCK_SIZE) * BLOCKS_PER_ROW + (grid_offset % GRID_SIZE) / BLOCK_SIZE;
+}
+
+static void add_incremental_at_distance(int x, int y, int size, int distance, int desirability, int sign)
+{
+    int base_offset = map_grid_offset(x, y);
+    int start = map_ring_start(size, distance);
+    int end = map_ring_end(size, distance);
+    int16_t *items = desirability > 0 ? incremental.positive.items : incremental.negative.items;
+    for (int i = start; i < end; i++) {
+        const ring_tile *tile = map_ring_tile(i);
+        if (!map_ring_is_inside_map(x + tile->x, y + tile->y)) {
+            continue;
+        }
+        int grid_offset = base_offset + tile->grid_offset;
+        int was_saturated = is_saturated(grid_offset);
+        items[grid_offset] += sign * desirability;
+        int saturated = is_saturated(grid_offset);
+        if (saturated != was_saturated) {
+            incremental.saturated_tiles += saturated - was_saturated;
+            incremental.saturated_blocks[block_of(grid_offset)] += saturated - was_saturated;
+        }
+        if (!saturated) {
+            desirability_grid.items[grid_offset] =
+                incremental.positive.items[grid_offset] + incremental.negative.items[grid_offset];
+        }
+    }
+}
+
+static void add_incremental(int x, int y, int size, const desirability_effect *effect, int sign)
+{
+    if (size <= 0) {
+        return;
+    }
+    int desirability = effect->value;
+    int range = effect->range > MAX_RANGE ? MAX_RANGE : effect->range;
+    int tiles_within_step = 0;
+    for (int distance = 1; distance <= range; distance++) {
+        if (desirability) {
+            add_incremental_at_distance(x, y, size, distance, desirability, sign);
+        }
+        tiles_within_step++;
+        if (tiles_within_step >= effect->step) {
+            desirability += effect->step_size;
+            tiles_within_step = 0;
+        }
+    }
+}
+
+static void get_model_effect(building_type type, desirability_effect *effect)
+{
+    const model_building *model = model_get_building(type);
+    effect->value = model->desirability_value;
+    effect->step = model->desirability_step;
+    effect->step_size = model->desirability_step_size;
+    effect->range = model->desirability_range;
+}
+
+static int is_applied(const building *b, const desirability_effect *effect)
+{
+    if (!slot_bitmap_is_used(&applied_buildings, b->id)) {
+        return 0;
+    }
+    const desirability_effect *applied = &incremental.buildings[b->id].effect;
+    return b->x == incremental.buildings[b->id].x && b->y == incremental.buildings[b->id].y &&
+        b->size == incremental.buildings[b->id].size &&
+        effect->value == applied->value && effect->step == applied->step &&
+        effect->step_size == applied->step_size && effect->range == applied->range;
+}
+
+static void remove_building(int id)
+{
+    add_incremental(incremental.buildings[id].x, incremental.buildings[id].y, incremental.buildings[id].size,
+        &incremental.buildings[id].effect, -1);
+    slot_bitmap_set_free(&applied_buildings, id);
+}
+
+static void update_incremental_buildings(void)
+{
+    int max_id = building_get_highest_id();
+    desirability_effect effect;
+    for (int i = slot_bitmap_find_used(&applied_buildings, 0); i >= 0;
+        i = slot_bitmap_find_used(&applied_buildings, i + 1)) {
+        const building *b = building_get(i);
+        if (b->state != BUILDING_STATE_IN_USE || i > max_id) {
+            remove_building(i);
+        }
+    }
+    for (int i = building_next_id(0); i && i <= max_id; i = building_next_id(i)) {
+        const building *b = building_get(i);
+        if (b->state != BUILDING_STATE_IN_USE) {
+            continue;
+        }
+        get_model_effect(b->type, &effect);
+        if (is_applied(b, &effect)) {
+            continue;
+        }
+        if (slot_bitmap_is_used(&applied_buildings, i)) {
+            remove_building(i);
+        }
+        incremental.buildings[i].x = b->x;
+        incremental.buildings[i].y = b->y;
+        incremental.buildings[i].size = b->size;
+        incremental.buildings[i].effect = effect;
+        add_incremental(b->x, b->y, b->size, &effect, 1);
+        slot_bitmap_set_used(&applied_buildings, i);
+    }
+}
+
+static terrain_effect get_terrain_effect(int grid_offset)
+{
+    int terrain = map_terrain_get(grid_offset);
+    if (map_property_is_plaza_or_earthquake(grid_offset)) {
+        if (terrain & TERRAIN_ROAD) {
+            return TERRAIN_EFFECT_PLAZA;
+        } else if (terrain & TERRAIN_ROCK) {
+            return TERRAIN_EFFECT_FAULT_LINE;
+        } else {
+            // invalid plaza/earthquake flag
+            map_property_clear_plaza_or_earthquake(grid_offset);
+            return TERRAIN_EFFECT_NONE;
+        }
+    } else if (terrain & TERRAIN_GARDEN) {
+        return TERRAIN_EFFECT_GARDEN;
+    } else if (terrain & TERRAIN_RUBBLE) {
+        return TERRAIN_EFFECT_RUBBLE;
+    }
+    return TERRAIN_EFFECT_NONE;
+}
+
+static int get_terrain_effect_values(terrain_effect type, desirability_effect *effect)
+{
+    switch (type) {
+        case TERRAIN_EFFECT_PLAZA:
+            get_model_effect(BUILDING_PLAZA, effect);
+            return 1;
+        case TERRAIN_EFFECT_FAULT_LINE:
+            // earthquake fault line: slight negative
+            get_model_effect(BUILDING_HOUSE_VACANT_LOT, effect);
+            return 1;
+        case TERRAIN_EFFECT_GARDEN:
+            get_model_effect(BUILDING_GARDENS, effect);
+            return 1;
+        case TERRAIN_EFFECT_RUBBLE:
+            effect->value = -2;
+            effect->step = 1;
+            effect->step_size = 1;
+            effect->range = 2;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void update_incremental_terrain(void)
+{
+    desirability_effect effect;
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
+            terrain_effect type = get_terrain_effect(grid_offset);
+            if (type == incremental.terrain.items[grid_offset]) {
+                continue;
+            }
+            if (get_terrain_effect_values(incremental.terrain.items[grid_offset], &effect)) {
+                add_incremental(x, y, 1, &effect, -1);
+            }
+            if (get_terrain_effect_values(type, &effect)) {
+                add_incremental(x, y, 1, &effect, 1);
+            }
+            incremental.terrain.items[grid_offset] = type;
+        }
+    }
+}
+
+static int has_saturated_tiles_within(int x, int y, int size, int range)
+{
+    int grid_offset = map_grid_offset(x, y);
+    int x_min = calc_bound(grid_offset % GRID_SIZE - range, 0, GRID_SIZE - 1) / BLOCK_SIZE;
+    int y_min = calc_bound(grid_offset / GRID_SIZE - range, 0, GRID_SIZE - 1) / BLOCK_SIZE;
+    int x_max = calc_bound(grid_offset % GRID_SIZE + size - 1 + range, 0, GRID_SIZE - 1) / BLOCK_SIZE;
+    int y_max = calc_bound(grid_offset / GRID_SIZE + size - 1 + range, 0, GRID_SIZE - 1) / BLOCK_SIZE;
+    for (int block_y = y_min; block_y <= y_max; block_y++) {
+        for (int block_x = x_min; block_x <= x_max; block_x++) {
+            if (incremental.saturated_blocks[block_y * BLOCKS_PER_ROW + block_x]) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void add_saturated_at_distance(int x, int y, int size, int distance, int desirability)
+{
+    int base_offset = map_grid_offset(x, y);
+    int start = map_ring_start(size, distance);
+    int end = map_ring_end(size, distance);
+    for (int i = start; i < end; i++) {
+        const ring_tile *tile = map_ring_tile(i);
+        int grid_offset = base_offset + tile->grid_offset;
+        if (map_ring_is_inside_map(x + tile->x, y + tile->y) && is_saturated(grid_offset)) {
+            desirability_grid.items[grid_offset] =
+                calc_bound(desirability_grid.items[grid_offset] + desirability, -100, 100);
+        }
+    }
+}
+
+static void add_saturated(int x, int y, int size, const desirability_effect *effect)
+{
+    int range = effect->range > MAX_RANGE ? MAX_RANGE : effect->range;
+    if (size <= 0 || range <= 0 || !has_saturated_tiles_within(x, y, size, range)) {
+        return;
+    }
+    int desirability = effect->value;
+    int tiles_within_step = 0;
+    for (int distance = 1; distance <= range; distance++) {
+        if (desirability) {
+            add_saturated_at_distance(x, y, size, distance, desirability);
+        }
+        tiles_within_step++;
+        if (tiles_within_step >= effect->step) {
+            desirability += effect->step_size;
+            tiles_within_step = 0;
+        }
+    }
+}
+
+static void update_saturated_tiles(void)
+{
+    // clear the saturated tiles and find the area that can reach them
+    int x_min = GRID_SIZE;
+    int y_min = GRID_SIZE;
+    int x_max = -1;
+    int y_max = -1;
+    for (int block_y = 0; block_y < BLOCKS_PER_ROW; block_y++) {
+        for (int block_x = 0; block_x < BLOCKS_PER_ROW; block_x++) {
+            if (!incremental.saturated_blocks[block_y * BLOCKS_PER_ROW + block_x]) {
+                continue;
+            }
+            for (int y = block_y * BLOCK_SIZE; y < (block_y + 1) * BLOCK_SIZE && y < GRID_SIZE; y++) {
+                for (int x = block_x * BLOCK_SIZE; x < (block_x + 1) * BLOCK_SIZE && x < GRID_SIZE; x++) {
+                    if (is_saturated(y * GRID_SIZE + x)) {
+                        desirability_grid.items[y * GRID_SIZE + x] = 0;
+                        x_min = x < x_min ? x : x_min;
+                        y_min = y < y_min ? y : y_min;
+                        x_max = x > x_max ? x : x_max;
+                        y_max = y > y_max ? y : y_max;
+                    }
+                }
+            }
+        }
+    }
+    // same order as the full update: buildings by id, then terrain
+    for (int i = slot_bitmap_find_used(&applied_buildings, 0); i >= 0;
+        i = slot_bitmap_find_used(&applied_buildings, i + 1)) {
+        add_saturated(incremental.buildings[i].x, incremental.buildings[i].y, incremental.buildings[i].size,
+            &incremental.buildings[i].effect);
+    }
+    int start = map_data.start_offset;
+    x_min = calc_bound(x_min - start % GRID_SIZE - MAX_RANGE, 0, map_data.width - 1);
+    x_max = calc_bound(x_max - start % GRID_SIZE + MAX_RANGE, 0, map_data.width - 1);
+    y_min = calc_bound(y_min - start / GRID_SIZE - MAX_RANGE, 0, map_data.height - 1);
+    y_max = calc_bound(y_max - start / GRID_SIZE + MAX_RANGE, 0, map_data.height - 1);
+    desirability_effect effect;
+    for (int y = y_min; y <= y_max; y++) {
+        for (int x = x_min; x <= x_max; x++) {
+            if (get_terrain_effect_values(incremental.terrain.items[map_grid_offset(x, y)], &effect)) {
+                add_saturated(x, y, 1, &effect);
+            }
+        }
+    }
+}
+
+static void reset_incremental(void)
+{
+    map_grid_clear_i8(desirability_grid.items);
+    map_grid_clear_i16(incremental.positive.items);
+    map_grid_clear_i16(incremental.negative.items);
+    map_grid_clear_u8(incremental.terrain.items);
+    memset(incremental.saturated_blocks, 0, sizeof(incremental.saturated_blocks));
+    slot_bitmap_clear(&applied_buildings);
+    incremental.saturated_tiles = 0;
+    incremental.in_sync = 1;
+}
+
 void map_desirability_update(void)
 {
-    map_desirability_clear();
-    update_buildings();
-    update_terrain();
+    if (!incremental.in_sync) {
+        reset_incremental();
+    }
+    update_incremental_buildings();
+    update_incremental_terrain();
+    if (incremental.saturated_tiles) {
+        update_saturated_tiles();
+    }
+
+    if (++incremental.updates_since_verify >= VERIFY_INTERVAL) {
+        // Once in a while, check the result against a full update
+        incremental.updates_since_verify = 0;
+        memcpy(verify_grid.items, desirability_grid.items, sizeof(verify_grid.items));
+        map_grid_clear_i8(desirability_grid.items);
+        update_buildings();
+        update_terrain();
+        if (memcmp(verify_grid.items, desirability_grid.items, sizeof(verify_grid.items)) != 0) {
+            log_error("Desirability out of sync, recalculating", 0, 0);
+            incremental.in_sync = 0;
+        }
+    }
 }
 
 int map_desirability_get(int grid_offset)
@@ -157,4 +522,5 @@ void map_desirability_save_state(buffer *buf)
 void map_desirability_load_state(buffer *buf)
 {
     map_grid_load_state_i8(desirability_grid.items, buf);
+    incremental.in_sync = 0;
 }
@@ -1,9 +1,27 @@
 #include "figure.h"
 
+#include "core/calc.h"
 #include "map/grid.h"
+#include "map/tile_changes.h"
+
+#include <string.h>
+
+#define BUCKET_SIZE 8
+#define BUCKETS_PER_ROW ((GRID_SIZE + BUCKET_SIZE - 1) / BUCKET_SIZE)
 
 static grid_u16 figures;
 
+// Number of figures on the tiles of each BUCKET_SIZE x BUCKET_SIZE block, used to skip empty areas
+static struct {
+    int valid;
+    uint16_t figures[BUCKETS_PER_ROW * BUCKETS_PER_ROW];
+} buckets;
+
+static int bucket_for_offset(int grid_offset)
+{
+    return (grid_offset / GRID_SIZE / BUCKET_SIZE) * BUCKETS_PER_ROW + (grid_offset % GRID_SIZE) / BUCKET_SIZE;
+}
+
 int map_has_figure_at(int grid_offset)
 {
     return map_grid_is_valid_offset(grid_offset) && figures.items[grid_offset] > 0;
@@ -36,6 +54,8 @@ void map_figure_add(figure *f)
     } else {
         figures.items[f->grid_offset] = f->id;
     }
+    buckets.figures[bucket_for_offset(f->grid_offset)]++;
+    map_tile_changes_mark(f->grid_offset);
 }
 
 void map_figure_update(figure *f)
@@ -65,6 +85,7 @@ void map_figure_delete(figure *f)
         return;
     }
 
+    int removed = 1;
     if (figures.items[f->grid_offset] == f->id) {
         figures.items[f->grid_offset] = f->next_figure_id_on_same_tile;
     } else {
@@ -72,8 +93,13 @@ void map_figure_delete(figure *f)
         while (prev->id && prev->next_figure_id_on_same_tile != f->id) {
             prev = figure_get(prev->next_figure_id_on_same_tile);
         }
+        removed = prev->id != 0;
         prev->next_figure_id_on_same_tile = f->next_figure_id_on_same_tile;
     }
+    if (removed && buckets.figures[bucket_for_offset(f->grid_offset)]) {
+        buckets.figures[bucket_for_offset(f->grid_offset)]--;
+    }
+    map_tile_changes_mark(f->grid_offset);
     f->next_figure_id_on_same_tile = 0;
 }
 
@@ -93,9 +119,56 @@ int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f))
     return 0;
 }
 
+static void count_bucket_figures(void)
+{
+    memset(buckets.figures, 0, sizeof(buckets.figures));
+    for (int grid_offset = 0; grid_offset < GRID_SIZE * GRID_SIZE; grid_offset++) {
+        int figure_id = figures.items[grid_offset];
+        for (int guard = 0; figure_id && guard < MAX_FIGURES; guard++) {
+            buckets.figures[bucket_for_offset(grid_offset)]++;
+            figure_id = figure_get(figure_id)->next_figure_id_on_same_tile;
+        }
+    }
+    buckets.valid = 1;
+}
+
+void map_figure_foreach_in_area(int x_min, int y_min, int x_max, int y_max, void (*callback)(figure *f))
+{
+    if (!buckets.valid) {
+        count_bucket_figures();
+    }
+    int origin = map_grid_offset(0, 0);
+    int gx_min = calc_bound(origin % GRID_SIZE + x_min, 0, GRID_SIZE - 1);
+    int gy_min = calc_bound(origin / GRID_SIZE + y_min, 0, GRID_SIZE - 1);
+    int gx_max = calc_bound(origin % GRID_SIZE + x_max, 0, GRID_SIZE - 1);
+    int gy_max = calc_bound(origin / GRID_SIZE + y_max, 0, GRID_SIZE - 1);
+    for (int by = gy_min / BUCKET_SIZE; by <= gy_max / BUCKET_SIZE; by++) {
+        for (int bx = gx_min / BUCKET_SIZE; bx <= gx_max / BUCKET_SIZE; bx++) {
+            if (!buckets.figures[by * BUCKETS_PER_ROW + bx]) {
+                continue;
+            }
+            int y_end = calc_bound(by * BUCKET_SIZE + BUCKET_SIZE - 1, gy_min, gy_max);
+            int x_end = calc_bound(bx * BUCKET_SIZE + BUCKET_SIZE - 1, gx_min, gx_max);
+            for (int y = calc_bound(by * BUCKET_SIZE, gy_min, gy_max); y <= y_end; y++) {
+                for (int x = calc_bound(bx * BUCKET_SIZE, gx_min, gx_max); x <= x_end; x++) {
+                    int figure_id = figures.items[y * GRID_SIZE + x];
+                    while (figure_id) {
+                        figure *f = figure_get(figure_id);
+                        callback(f);
+                        figure_id = f->next_figure_id_on_same_tile;
+                    }
+                }
+            }
+        }
+    }
+}
+
 void map_figure_clear(void)
 {
     map_grid_clear_u16(figures.items);
+    memset(buckets.figures, 0, sizeof(buckets.figures));
+    buckets.valid = 1;
+    map_tile_changes_mark_all();
 }
 
 void map_figure_save_state(buffer *buf)
@@ -106,4 +179,7 @@ void map_figure_save_state(buffer *buf)
 void map_figure_load_state(buffer *buf)
 {
     map_grid_load_state_u16(figures.items, buf);
+    // the figures themselves are loaded later, so their tile lists cannot be counted yet
+    buckets.valid = 0;
+    map_tile_changes_mark_all();
 }
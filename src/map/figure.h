@@ -26,6 +26,17 @@ void map_figure_delete(figure *f);
 
 int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f));
 
+/**
+ * Calls the callback for every figure on the tiles in the given area, skipping empty parts of the map.
+ * Figures are not visited in any particular order.
+ * @param x_min Minimum x, may be outside the map
+ * @param y_min Minimum y, may be outside the map
+ * @param x_max Maximum x, may be outside the map
+ * @param y_max Maximum y, may be outside the map
+ * @param callback Function to call for each figure
+ */
+void map_figure_foreach_in_area(int x_min, int y_min, int x_max, int y_max, void (*callback)(figure *f));
+
 /**
  * Clears the map
  */
@@ -1,9 +1,11 @@
 #include "image.h"
 
 #include "map/grid.h"
+#include "map/journal.h"
+#include "map/terrain.h"
+#include "map/water_supply.h"
 
 static grid_u16 images;
-static grid_u16 images_backup;
 
 int map_image_at(int grid_offset)
 {
@@ -12,24 +14,14 @@ int map_image_at(int grid_offset)
 
 void map_image_set(int grid_offset, int image_id)
 {
+    map_journal_record(JOURNAL_IMAGE, grid_offset, images.items[grid_offset]);
+    // aqueduct images show whether the aqueduct has water
+    if (images.items[grid_offset] != image_id && map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
+        map_water_supply_network_changed();
+    }
     images.items[grid_offset] = image_id;
 }
 
-void map_image_backup(void)
-{
-    map_grid_copy_u16(images.items, images_backup.items);
-}
-
-void map_image_restore(void)
-{
-    map_grid_copy_u16(images_backup.items, images.items);
-}
-
-void map_image_restore_at(int grid_offset)
-{
-    images.items[grid_offset] = images_backup.items[grid_offset];
-}
-
 void map_image_clear(void)
 {
     map_grid_clear_u16(images.items);
@@ -1,6 +1,8 @@
 #ifndef MAP_IMAGE_CONTEXT_H
 #define MAP_IMAGE_CONTEXT_H
 
+#include "core/buffer.h"
+
 typedef struct {
     int is_valid;
     int group_offset;
@@ -9,6 +11,15 @@ typedef struct {
 } terrain_image;
 
 void map_image_context_init(void);
+
+/**
+ * The image variant counters are not part of saved games, but in-memory snapshots need them
+ * to draw the same variants as before
+ */
+int map_image_context_state_size(void);
+void map_image_context_save_state(buffer *buf);
+void map_image_context_load_state(buffer *buf);
+
 void map_image_context_reset_water(void);
 void map_image_context_reset_elevation(void);
 
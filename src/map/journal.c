@@ -0,0 +1,210 @@
+#include "journal.h"
+
+#include "core/log.h"
+#include "map/aqueduct.h"
+#include "map/building.h"
+#include "map/grid.h"
+#include "map/image.h"
+#include "map/property.h"
+#include "map/sprite.h"
+#include "map/terrain.h"
+
+#include <stdint.h>
+#include <string.h>
+
+// Enough for every layer of every tile to change in a single recording, twice over
+#define MAX_CHANGES (1 << 19)
+
+typedef struct {
+    int grid_offset;
+    uint16_t value;
+    uint8_t layer;
+} journal_change;
+
+static struct {
+    int recording;
+    int recording_start;
+    int keep_from;
+    int is_full;
+    int replace_start;
+    int replace_end;
+    unsigned int recording_id;
+    int first_position;
+    int num_changes;
+    journal_change changes[MAX_CHANGES];
+    unsigned int recorded_id[GRID_SIZE * GRID_SIZE];
+    uint8_t recorded_layers[GRID_SIZE * GRID_SIZE];
+} data;
+
+static void start_recording(int keep_from)
+{
+    data.recording_id++;
+    if (!data.recording_id) {
+        memset(data.recorded_id, 0, sizeof(data.recorded_id));
+        data.recording_id = 1;
+    }
+    data.recording = 1;
+    data.recording_start = map_journal_position();
+    data.keep_from = keep_from;
+    data.is_full = 0;
+}
+
+void map_journal_start(void)
+{
+    start_recording(map_journal_position());
+}
+
+void map_journal_stop(void)
+{
+    data.recording = 0;
+}
+
+void map_journal_start_replacing(int start, int end)
+{
+    data.replace_start = start;
+    data.replace_end = end;
+    start_recording(start);
+}
+
+static void reverse_changes(int from, int to)
+{
+    for (to--; from < to; from++, to--) {
+        journal_change change = data.changes[from];
+        data.changes[from] = data.changes[to];
+        data.changes[to] = change;
+    }
+}
+
+int map_journal_finish_replacing(void)
+{
+    data.recording = 0;
+    if (data.is_full) {
+        map_journal_truncate(data.replace_start);
+        return -1;
+    }
+    int start = data.replace_start - data.first_position;
+    int end = data.replace_end - data.first_position;
+    int recording_start = data.recording_start - data.first_position;
+    int num_replaced = end - start;
+    memmove(&data.changes[start], &data.changes[end], (data.num_changes - end) * sizeof(journal_change));
+    data.num_changes -= num_replaced;
+    recording_start -= num_replaced;
+    // rotate the recording in front of the changes that followed the replaced ones
+    reverse_changes(start, recording_start);
+    reverse_changes(recording_start, data.num_changes);
+    reverse_changes(start, data.num_changes);
+    return data.replace_start + data.num_changes - recording_start;
+}
+
+void map_journal_record(journal_layer layer, int grid_offset, int value)
+{
+    if (!data.recording) {
+        return;
+    }
+    if (data.recorded_id[grid_offset] != data.recording_id) {
+        data.recorded_id[grid_offset] = data.recording_id;
+        data.recorded_layers[grid_offset] = 0;
+    } else if (data.recorded_layers[grid_offset] & layer) {
+        return;
+    }
+    if (data.num_changes == MAX_CHANGES) {
+        map_journal_forget_before(data.keep_from);
+        if (data.num_changes == MAX_CHANGES) {
+            log_error("Too many map changes to record", 0, 0);
+            data.recording = 0;
+            data.is_full = 1;
+            return;
+        }
+    }
+    data.recorded_layers[grid_offset] |= layer;
+    journal_change *change = &data.changes[data.num_changes++];
+    change->grid_offset = grid_offset;
+    change->value = (uint16_t) value;
+    change->layer = (uint8_t) layer;
+}
+
+int map_journal_position(void)
+{
+    return data.first_position + data.num_changes;
+}
+
+int map_journal_oldest(void)
+{
+    return data.first_position;
+}
+
+static void restore_change(const journal_change *change, int layers)
+{
+    int grid_offset = change->grid_offset;
+    switch (change->layer & layers) {
+        case JOURNAL_TERRAIN:
+            map_terrain_set(grid_offset, change->value);
+            break;
+        case JOURNAL_AQUEDUCT:
+            map_aqueduct_set(grid_offset, change->value);
+            break;
+        case JOURNAL_PROPERTIES:
+            map_property_restore_tile(grid_offset, change->value);
+            break;
+        case JOURNAL_SPRITE:
+            map_sprite_animation_set(grid_offset, change->value);
+            break;
+        case JOURNAL_IMAGE:
+            map_image_set(grid_offset, change->value);
+            break;
+        case JOURNAL_BUILDING:
+            map_building_set(grid_offset, change->value);
+            break;
+        default:
+            if (change->layer == JOURNAL_IMAGE && (layers & JOURNAL_IMAGE_WITHOUT_BUILDING) &&
+                !map_building_at(grid_offset)) {
+                map_image_set(grid_offset, change->value);
+            }
+            break;
+    }
+}
+
+void map_journal_restore(int position, int layers)
+{
+    map_journal_restore_range(position, map_journal_position(), layers);
+}
+
+void map_journal_restore_range(int start, int end, int layers)
+{
+    // Every tile layer is recorded once per recording, so the order only matters across recordings.
+    // Restoring while replacing may forget changes before start, so the index is taken for every change.
+    for (int position = end - 1; position >= start && position >= data.first_position; position--) {
+        restore_change(&data.changes[position - data.first_position], layers);
+    }
+}
+
+void map_journal_truncate(int position)
+{
+    if (position < data.first_position) {
+        position = data.first_position;
+    }
+    if (position < map_journal_position()) {
+        data.num_changes = position - data.first_position;
+    }
+}
+
+void map_journal_forget_before(int position)
+{
+    if (position > map_journal_position()) {
+        position = map_journal_position();
+    }
+    int count = position - data.first_position;
+    if (count <= 0) {
+        return;
+    }
+    data.num_changes -= count;
+    memmove(data.changes, &data.changes[count], data.num_changes * sizeof(journal_change));
+    data.first_position = position;
+}
+
+void map_journal_clear(void)
+{
+    data.recording = 0;
+    data.first_position = 0;
+    data.num_changes = 0;
+}
@@ -0,0 +1,104 @@
+#ifndef MAP_JOURNAL_H
+#define MAP_JOURNAL_H
+
+/**
+ * @file
+ * Records the original value of every tile that changes while recording,
+ * so the changes can be reverted without keeping copies of the whole map.
+ * Positions in the journal only grow, so they stay valid when old changes are forgotten.
+ */
+
+typedef enum {
+    JOURNAL_TERRAIN = 0x01,
+    JOURNAL_AQUEDUCT = 0x02,
+    JOURNAL_PROPERTIES = 0x04,
+    JOURNAL_SPRITE = 0x08,
+    JOURNAL_IMAGE = 0x10,
+    /** Only used for restoring: the images of tiles without a building */
+    JOURNAL_IMAGE_WITHOUT_BUILDING = 0x20,
+    JOURNAL_BUILDING = 0x40
+} journal_layer;
+
+#define JOURNAL_ALL_LAYERS (JOURNAL_TERRAIN | JOURNAL_AQUEDUCT | JOURNAL_PROPERTIES | JOURNAL_SPRITE | \
+    JOURNAL_IMAGE | JOURNAL_BUILDING)
+
+/**
+ * Starts recording changes. Every tile layer is recorded at most once until the next start.
+ */
+void map_journal_start(void);
+
+/**
+ * Stops recording changes
+ */
+void map_journal_stop(void);
+
+/**
+ * Starts a recording that will take the place of the changes from start to end,
+ * which are usually restored while recording. Changes before start may be forgotten when the journal is full.
+ * @param start Position of the first change to replace
+ * @param end Position after the last change to replace
+ */
+void map_journal_start_replacing(int start, int end);
+
+/**
+ * Stops the recording started by map_journal_start_replacing and puts it in place of the replaced changes.
+ * Changes after the replaced ones move by the difference in length.
+ * @return Position after the last change of the recording, or -1 if the journal was full.
+ *         In that case all changes from the start position onwards are dropped.
+ */
+int map_journal_finish_replacing(void);
+
+/**
+ * Records the value of a tile before it changes. Called by the map layers themselves.
+ * @param layer Layer that is about to change
+ * @param grid_offset Tile that is about to change
+ * @param value Current value of the tile
+ */
+void map_journal_record(journal_layer layer, int grid_offset, int value);
+
+/**
+ * Gets the position after the last recorded change
+ * @return Position
+ */
+int map_journal_position(void);
+
+/**
+ * Gets the position of the oldest change still kept. When the journal is full,
+ * changes from before the current recording are forgotten.
+ * @return Position
+ */
+int map_journal_oldest(void);
+
+/**
+ * Restores all changes from the position onwards to their original values
+ * @param position Position of the first change to restore
+ * @param layers Bitmask of journal_layer values to restore
+ */
+void map_journal_restore(int position, int layers);
+
+/**
+ * Restores the changes from start to end to their original values, newest first
+ * @param start Position of the first change to restore
+ * @param end Position after the last change to restore
+ * @param layers Bitmask of journal_layer values to restore
+ */
+void map_journal_restore_range(int start, int end, int layers);
+
+/**
+ * Drops all changes from the position onwards without restoring them
+ * @param position Position of the first change to drop
+ */
+void map_journal_truncate(int position);
+
+/**
+ * Forgets all changes before the position
+ * @param position Position of the first change to keep
+ */
+void map_journal_forget_before(int position);
+
+/**
+ * Stops recording and forgets all changes
+ */
+void map_journal_clear(void);
+
+#endif // MAP_JOURNAL_H
@@ -1,7 +1,9 @@
 #include "property.h"
 
 #include "map/grid.h"
+#include "map/journal.h"
 #include "map/random.h"
+#include "map/tile_changes.h"
 
 enum {
     BIT_SIZE1 = 0x00,
@@ -31,14 +33,17 @@ enum {
 static grid_u8 edge_grid;
 static grid_u8 bitfields_grid;
 
-static grid_u8 edge_backup;
-static grid_u8 bitfields_backup;
-
 static int edge_for(int x, int y)
 {
     return 8 * y + x;
 }
 
+static void record(int grid_offset)
+{
+    map_journal_record(JOURNAL_PROPERTIES, grid_offset,
+        bitfields_grid.items[grid_offset] | edge_grid.items[grid_offset] << 8);
+}
+
 int map_property_is_draw_tile(int grid_offset)
 {
     return edge_grid.items[grid_offset] & EDGE_LEFTMOST_TILE;
@@ -46,12 +51,16 @@ int map_property_is_draw_tile(int grid_offset)
 
 void map_property_mark_draw_tile(int grid_offset)
 {
+    record(grid_offset);
     edge_grid.items[grid_offset] |= EDGE_LEFTMOST_TILE;
+    map_tile_changes_mark(grid_offset);
 }
 
 void map_property_clear_draw_tile(int grid_offset)
 {
+    record(grid_offset);
     edge_grid.items[grid_offset] &= ~EDGE_LEFTMOST_TILE;
+    map_tile_changes_mark(grid_offset);
 }
 
 int map_property_is_native_land(int grid_offset)
@@ -61,12 +70,18 @@ int map_property_is_native_land(int grid_offset)
 
 void map_property_mark_native_land(int grid_offset)
 {
+    record(grid_offset);
     edge_grid.items[grid_offset] |= EDGE_NATIVE_LAND;
 }
 
 void map_property_clear_all_native_land(void)
 {
-    map_grid_and_u8(edge_grid.items, EDGE_NO_NATIVE_LAND);
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        if (edge_grid.items[i] & EDGE_NATIVE_LAND) {
+            record(i);
+            edge_grid.items[i] &= EDGE_NO_NATIVE_LAND;
+        }
+    }
 }
 
 int map_property_multi_tile_xy(int grid_offset)
@@ -91,17 +106,21 @@ int map_property_is_multi_tile_xy(int grid_offset, int x, int y)
 
 void map_property_set_multi_tile_xy(int grid_offset, int x, int y, int is_draw_tile)
 {
+    record(grid_offset);
     if (is_draw_tile) {
         edge_grid.items[grid_offset] = edge_for(x, y) | EDGE_LEFTMOST_TILE;
     } else {
         edge_grid.items[grid_offset] = edge_for(x, y);
     }
+    map_tile_changes_mark(grid_offset);
 }
 
 void map_property_clear_multi_tile_xy(int grid_offset)
 {
+    record(grid_offset);
     // only keep native land marker
     edge_grid.items[grid_offset] &= EDGE_NATIVE_LAND;
+    map_tile_changes_mark(grid_offset);
 }
 
 int map_property_multi_tile_size(int grid_offset)
@@ -117,6 +136,7 @@ int map_property_multi_tile_size(int grid_offset)
 
 void map_property_set_multi_tile_size(int grid_offset, int size)
 {
+    record(grid_offset);
     bitfields_grid.items[grid_offset] &= BIT_NO_SIZES;
     switch (size) {
         case 2: bitfields_grid.items[grid_offset] |= BIT_SIZE2; break;
@@ -124,6 +144,7 @@ void map_property_set_multi_tile_size(int grid_offset, int size)
         case 4: bitfields_grid.items[grid_offset] |= BIT_SIZE4; break;
         case 5: bitfields_grid.items[grid_offset] |= BIT_SIZE5; break;
     }
+    map_tile_changes_mark(grid_offset);
 }
 
 void map_property_init_alternate_terrain(void)
@@ -147,6 +168,7 @@ int map_property_is_alternate_terrain(int grid_offset)
 
 void map_property_set_alternate_terrain(int grid_offset)
 {
+    record(grid_offset);
     bitfields_grid.items[grid_offset] |= BIT_ALTERNATE_TERRAIN;
 }
 
@@ -157,11 +179,13 @@ int map_property_is_plaza_or_earthquake(int grid_offset)
 
 void map_property_mark_plaza_or_earthquake(int grid_offset)
 {
+    record(grid_offset);
     bitfields_grid.items[grid_offset] |= BIT_PLAZA_OR_EARTHQUAKE;
 }
 
 void map_property_clear_plaza_or_earthquake(int grid_offset)
 {
+    record(grid_offset);
     bitfields_grid.items[grid_offset] &= BIT_NO_PLAZA;
 }
 
@@ -172,11 +196,13 @@ int map_property_is_constructing(int grid_offset)
 
 void map_property_mark_constructing(int grid_offset)
 {
+    record(grid_offset);
     bitfields_grid.items[grid_offset] |= BIT_CONSTRUCTION;
 }
 
 void map_property_clear_constructing(int grid_offset)
 {
+    record(grid_offset);
     bitfields_grid.items[grid_offset] &= BIT_NO_CONSTRUCTION;
 }
 
@@ -187,35 +213,38 @@ int map_property_is_deleted(int grid_offset)
 
 void map_property_mark_deleted(int grid_offset)
 {
+    record(grid_offset);
     bitfields_grid.items[grid_offset] |= BIT_DELETED;
 }
 
 void map_property_clear_deleted(int grid_offset)
 {
+    record(grid_offset);
     bitfields_grid.items[grid_offset] &= BIT_NO_DELETED;
 }
 
 void map_property_clear_constructing_and_deleted(void)
 {
-    map_grid_and_u8(bitfields_grid.items, BIT_NO_CONSTRUCTION_AND_DELETED);
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        if (bitfields_grid.items[i] & ~BIT_NO_CONSTRUCTION_AND_DELETED) {
+            record(i);
+            bitfields_grid.items[i] &= BIT_NO_CONSTRUCTION_AND_DELETED;
+        }
+    }
 }
 
 void map_property_clear(void)
 {
     map_grid_clear_u8(bitfields_grid.items);
     map_grid_clear_u8(edge_grid.items);
+    map_tile_changes_mark_all();
 }
 
-void map_property_backup(void)
-{
-    map_grid_copy_u8(bitfields_grid.items, bitfields_backup.items);
-    map_grid_copy_u8(edge_grid.items, edge_backup.items);
-}
-
-void map_property_restore(void)
+void map_property_restore_tile(int grid_offset, int value)
 {
-    map_grid_copy_u8(bitfields_backup.items, bitfields_grid.items);
-    map_grid_copy_u8(edge_backup.items, edge_grid.items);
+    bitfields_grid.items[grid_offset] = value & 0xff;
+    edge_grid.items[grid_offset] = value >> 8;
+    map_tile_changes_mark(grid_offset);
 }
 
 void map_property_save_state(buffer *bitfields, buffer *edge)
@@ -228,4 +257,5 @@ void map_property_load_state(buffer *bitfields, buffer *edge)
 {
     map_grid_load_state_u8(bitfields_grid.items, bitfields);
     map_grid_load_state_u8(edge_grid.items, edge);
+    map_tile_changes_mark_all();
 }
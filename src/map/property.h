@@ -53,8 +53,12 @@ void map_property_clear_constructing_and_deleted(void);
 
 void map_property_clear(void);
 
-void map_property_backup(void);
-void map_property_restore(void);
+/**
+ * Restores the properties of a tile to a value recorded by the map journal
+ * @param grid_offset Tile to restore
+ * @param value Recorded value
+ */
+void map_property_restore_tile(int grid_offset, int value);
 
 void map_property_save_state(buffer *bitfields, buffer *edge);
 void map_property_load_state(buffer *bitfields, buffer *edge);
@@ -6,23 +6,26 @@
 #include "map/routing_terrain.h"
 #include "map/terrain.h"
 
-#include <string.h>
-
-#define MAX_QUEUE 1000
-
-static const int ADJACENT_OFFSETS[] = {-GRID_SIZE, 1, GRID_SIZE, -1};
+#define NO_NETWORK (-1)
 
 static grid_u8 network;
 
 static struct {
-    int items[MAX_QUEUE];
-    int head;
-    int tail;
-} queue;
+    int needs_update;
+    int parent[GRID_SIZE * GRID_SIZE];
+    int size[GRID_SIZE * GRID_SIZE];
+    int network_id[GRID_SIZE * GRID_SIZE];
+} data = {.needs_update = 1};
 
 void map_road_network_clear(void)
 {
     map_grid_clear_u8(network.items);
+    data.needs_update = 1;
+}
+
+void map_road_network_invalidate(void)
+{
+    data.needs_update = 1;
 }
 
 int map_road_network_get(int grid_offset)
@@ -30,62 +33,103 @@ int map_road_network_get(int grid_offset)
     return network.items[grid_offset];
 }
 
-static int mark_road_network(int grid_offset, uint8_t network_id)
+static int is_network_tile(int grid_offset)
 {
-    memset(&queue, 0, sizeof(queue));
-    int guard = 0;
-    int next_offset;
-    int size = 1;
-    do {
-        if (++guard >= GRID_SIZE * GRID_SIZE) {
-            break;
-        }
-        network.items[grid_offset] = network_id;
-        next_offset = -1;
-        for (int i = 0; i < 4; i++) {
-            int new_offset = grid_offset + ADJACENT_OFFSETS[i];
-            if (map_routing_citizen_is_passable(new_offset) && !network.items[new_offset]) {
-                if (map_routing_citizen_is_road(new_offset) || map_terrain_is(new_offset, TERRAIN_ACCESS_RAMP)) {
-                    network.items[new_offset] = network_id;
-                    size++;
-                    if (next_offset == -1) {
-                        next_offset = new_offset;
-                    } else {
-                        queue.items[queue.tail++] = new_offset;
-                        if (queue.tail >= MAX_QUEUE) {
-                            queue.tail = 0;
-                        }
-                    }
+    return map_routing_citizen_is_passable(grid_offset) &&
+        (map_routing_citizen_is_road(grid_offset) || map_terrain_is(grid_offset, TERRAIN_ACCESS_RAMP));
+}
+
+static int find_root(int grid_offset)
+{
+    while (data.parent[grid_offset] != grid_offset) {
+        data.parent[grid_offset] = data.parent[data.parent[grid_offset]];
+        grid_offset = data.parent[grid_offset];
+    }
+    return grid_offset;
+}
+
+static void join(int grid_offset, int other_offset)
+{
+    int root = find_root(grid_offset);
+    int other_root = find_root(other_offset);
+    if (root == other_root) {
+        return;
+    }
+    if (data.size[root] < data.size[other_root]) {
+        int tmp = root;
+        root = other_root;
+        other_root = tmp;
+    }
+    data.parent[other_root] = root;
+    data.size[root] += data.size[other_root];
+}
+
+static void join_adjacent_tiles(void)
+{
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
+            data.network_id[grid_offset] = 0;
+            if (is_network_tile(grid_offset)) {
+                data.parent[grid_offset] = grid_offset;
+                data.size[grid_offset] = 1;
+                if (x > 0 && is_network_tile(grid_offset - 1)) {
+                    join(grid_offset, grid_offset - 1);
                 }
+                if (y > 0 && is_network_tile(grid_offset - GRID_SIZE)) {
+                    join(grid_offset, grid_offset - GRID_SIZE);
+                }
+            } else if (map_terrain_is(grid_offset, TERRAIN_ROAD)) {
+                // a road the citizens cannot use yet still forms a network of its own
+                data.parent[grid_offset] = grid_offset;
+                data.size[grid_offset] = 1;
+            } else {
+                data.parent[grid_offset] = NO_NETWORK;
             }
         }
-        if (next_offset == -1) {
-            if (queue.head == queue.tail) {
-                return size;
-            }
-            next_offset = queue.items[queue.head++];
-            if (queue.head >= MAX_QUEUE) {
-                queue.head = 0;
+    }
+}
+
+static void number_networks(void)
+{
+    // Networks are numbered in the order of their first road tile, and ramps only count when next to a road
+    int next_network_id = 1;
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
+            if (data.parent[grid_offset] != NO_NETWORK && map_terrain_is(grid_offset, TERRAIN_ROAD)) {
+                int root = find_root(grid_offset);
+                if (!data.network_id[root]) {
+                    data.network_id[root] = next_network_id;
+                    city_map_add_to_largest_road_networks(next_network_id, data.size[root]);
+                    next_network_id++;
+                }
             }
         }
-        grid_offset = next_offset;
-    } while (next_offset > -1);
-    return size;
+    }
 }
 
-void map_road_network_update(void)
+static void mark_networks(void)
 {
-    city_map_clear_largest_road_networks();
-    map_grid_clear_u8(network.items);
-    int network_id = 1;
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
-            if (map_terrain_is(grid_offset, TERRAIN_ROAD) && !network.items[grid_offset]) {
-                int size = mark_road_network(grid_offset, network_id);
-                city_map_add_to_largest_road_networks(network_id, size);
-                network_id++;
+            if (data.parent[grid_offset] != NO_NETWORK) {
+                network.items[grid_offset] = (uint8_t) data.network_id[find_root(grid_offset)];
             }
         }
     }
 }
+
+void map_road_network_update(void)
+{
+    if (!data.needs_update) {
+        return;
+    }
+    data.needs_update = 0;
+    city_map_clear_largest_road_networks();
+    map_grid_clear_u8(network.items);
+    join_adjacent_tiles();
+    number_networks();
+    mark_networks();
+}
@@ -1,8 +1,19 @@
 #ifndef MAP_ROAD_NETWORK_H
 #define MAP_ROAD_NETWORK_H
 
+/**
+ * @file
+ * Connected networks of roads and access ramps.
+ * The networks are only recalculated when a road, a ramp or the citizen routing grid changed.
+ */
+
 void map_road_network_clear(void);
 
+/**
+ * Marks the networks as outdated, so the next update recalculates them
+ */
+void map_road_network_invalidate(void);
+
 int map_road_network_get(int grid_offset);
 
 void map_road_network_update(void);
@@ -1,6 +1,7 @@
 #include "routing.h"
 
 #include "building/building.h"
+#include "core/config.h"
 #include "map/building.h"
 #include "map/figure.h"
 #include "map/grid.h"
@@ -8,13 +9,24 @@
 #include "map/routing_data.h"
 #include "map/terrain.h"
 
+#include <string.h>
+
 #define MAX_QUEUE GRID_SIZE * GRID_SIZE
 #define GUARD 50000
+#define MAX_CACHED_DISTANCES 4
 
 static const int ROUTE_OFFSETS[] = {-162, 1, 162, -1, -161, 163, 161, -163};
 
 static grid_i16 routing_distance;
 
+// A tile's routing distance is only valid when its stamp matches the current generation,
+// so the distance grid does not need to be cleared before each route calculation
+static struct {
+    uint16_t current;
+    uint16_t distance[GRID_SIZE * GRID_SIZE];
+    uint16_t closed[GRID_SIZE * GRID_SIZE];
+} generation;
+
 static struct {
     int total_routes_calculated;
     int enemy_routes_calculated;
@@ -26,6 +38,33 @@ static struct {
     int items[MAX_QUEUE];
 } queue;
 
+// Goal-directed search: all tiles in the current bucket share the same estimated route length,
+// tiles in the other bucket are two steps longer
+static struct {
+    int active;
+    int goal_x;
+    int goal_y;
+    int f_value;
+    int current;
+    struct {
+        int head;
+        int count;
+        int items[MAX_QUEUE];
+    } buckets[2];
+} astar;
+
+// Land distance fields of recently used sources, valid while the citizen land grid is unchanged
+static struct {
+    int land_version;
+    int use_counter;
+    struct {
+        int source_offset;
+        int land_version;
+        int last_used;
+        grid_i16 distance;
+    } entries[MAX_CACHED_DISTANCES];
+} distance_cache;
+
 static grid_u8 water_drag;
 
 static struct {
@@ -34,12 +73,72 @@ static struct {
 
 static void clear_distances(void)
 {
-    map_grid_clear_i16(routing_distance.items);
+    if (++generation.current == 0) {
+        memset(generation.distance, 0, sizeof(generation.distance));
+        memset(generation.closed, 0, sizeof(generation.closed));
+        generation.current = 1;
+    }
+}
+
+static int get_distance(int grid_offset)
+{
+    return generation.distance[grid_offset] == generation.current ? routing_distance.items[grid_offset] : 0;
+}
+
+static void set_distance(int grid_offset, int dist)
+{
+    routing_distance.items[grid_offset] = dist;
+    generation.distance[grid_offset] = generation.current;
+}
+
+static int is_closed(int grid_offset)
+{
+    return generation.closed[grid_offset] == generation.current;
+}
+
+static int astar_f_value(int grid_offset, int dist)
+{
+    int dx = grid_offset % GRID_SIZE - astar.goal_x;
+    int dy = grid_offset / GRID_SIZE - astar.goal_y;
+    return dist + (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+}
+
+static void astar_push(int grid_offset, int dist)
+{
+    // with the manhattan heuristic on a 4-way grid, each step keeps f equal or increases it by 2
+    int bucket = astar_f_value(grid_offset, dist) == astar.f_value ? astar.current : astar.current ^ 1;
+    int index = astar.buckets[bucket].head + astar.buckets[bucket].count;
+    if (index >= MAX_QUEUE) {
+        index -= MAX_QUEUE;
+    }
+    astar.buckets[bucket].items[index] = grid_offset;
+    astar.buckets[bucket].count++;
+}
+
+static int astar_pop(void)
+{
+    if (!astar.buckets[astar.current].count) {
+        astar.current ^= 1;
+        if (!astar.buckets[astar.current].count) {
+            return -1;
+        }
+        astar.f_value += 2;
+    }
+    int grid_offset = astar.buckets[astar.current].items[astar.buckets[astar.current].head];
+    if (++astar.buckets[astar.current].head >= MAX_QUEUE) {
+        astar.buckets[astar.current].head = 0;
+    }
+    astar.buckets[astar.current].count--;
+    return grid_offset;
 }
 
 static void enqueue(int next_offset, int dist)
 {
-    routing_distance.items[next_offset] = dist;
+    set_distance(next_offset, dist);
+    if (astar.active) {
+        astar_push(next_offset, dist);
+        return;
+    }
     queue.items[queue.tail++] = next_offset;
     if (queue.tail >= MAX_QUEUE) {
         queue.tail = 0;
@@ -48,7 +147,7 @@ static void enqueue(int next_offset, int dist)
 
 static int valid_offset(int grid_offset)
 {
-    return map_grid_is_valid_offset(grid_offset) && routing_distance.items[grid_offset] == 0;
+    return map_grid_is_valid_offset(grid_offset) && get_distance(grid_offset) == 0;
 }
 
 static void route_queue(int source, int dest, void (*callback)(int next_offset, int dist))
@@ -61,7 +160,7 @@ static void route_queue(int source, int dest, void (*callback)(int next_offset,
         if (offset == dest) {
             break;
         }
-        int dist = 1 + routing_distance.items[offset];
+        int dist = 1 + get_distance(offset);
         for (int i = 0; i < 4; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS[i])) {
                 callback(offset + ROUTE_OFFSETS[i], dist);
@@ -80,7 +179,7 @@ static void route_queue_until(int source, int (*callback)(int next_offset, int d
     enqueue(source, 1);
     while (queue.head != queue.tail) {
         int offset = queue.items[queue.head];
-        int dist = 1 + routing_distance.items[offset];
+        int dist = 1 + get_distance(offset);
         for (int i = 0; i < 4; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS[i])) {
                 if (!callback(offset + ROUTE_OFFSETS[i], dist)) {
@@ -104,7 +203,7 @@ static void route_queue_max(int source, int dest, int max_tiles, void (*callback
         int offset = queue.items[queue.head];
         if (offset == dest) break;
         if (++tiles > max_tiles) break;
-        int dist = 1 + routing_distance.items[offset];
+        int dist = 1 + get_distance(offset);
         for (int i = 0; i < 4; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS[i])) {
                 callback(offset + ROUTE_OFFSETS[i], dist);
@@ -135,7 +234,7 @@ static void route_queue_boat(int source, void (*callback)(int, int))
                 queue.tail = 0;
             }
         } else {
-            int dist = 1 + routing_distance.items[offset];
+            int dist = 1 + get_distance(offset);
             for (int i = 0; i < 4; i++) {
                 if (valid_offset(offset + ROUTE_OFFSETS[i])) {
                     callback(offset + ROUTE_OFFSETS[i], dist);
@@ -159,7 +258,7 @@ static void route_queue_dir8(int source, void (*callback)(int, int))
             break;
         }
         int offset = queue.items[queue.head];
-        int dist = 1 + routing_distance.items[offset];
+        int dist = 1 + get_distance(offset);
         for (int i = 0; i < 8; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS[i])) {
                 callback(offset + ROUTE_OFFSETS[i], dist);
@@ -171,6 +270,57 @@ static void route_queue_dir8(int source, void (*callback)(int, int))
     }
 }
 
+static void route_queue_goal_directed(int source, int dest, int max_tiles, void (*callback)(int, int))
+{
+    clear_distances();
+    astar.active = 1;
+    astar.goal_x = dest % GRID_SIZE;
+    astar.goal_y = dest / GRID_SIZE;
+    astar.f_value = astar_f_value(source, 1);
+    astar.current = 0;
+    astar.buckets[0].head = astar.buckets[0].count = 0;
+    astar.buckets[1].head = astar.buckets[1].count = 0;
+    enqueue(source, 1);
+    int tiles = 0;
+    int offset;
+    while ((offset = astar_pop()) >= 0) {
+        if (is_closed(offset)) {
+            // stale entry: the tile was reached again over a shorter route
+            continue;
+        }
+        generation.closed[offset] = generation.current;
+        if (offset == dest) {
+            break;
+        }
+        if (max_tiles >= 0 && ++tiles > max_tiles) {
+            break;
+        }
+        int dist = 1 + get_distance(offset);
+        for (int i = 0; i < 4; i++) {
+            int next_offset = offset + ROUTE_OFFSETS[i];
+            if (map_grid_is_valid_offset(next_offset) && !is_closed(next_offset)) {
+                int next_dist = get_distance(next_offset);
+                if (next_dist == 0 || dist < next_dist) {
+                    callback(next_offset, dist);
+                }
+            }
+        }
+    }
+    astar.active = 0;
+}
+
+static void route_queue_to(int source, int dst_x, int dst_y, int max_tiles, void (*callback)(int, int))
+{
+    int dest = map_grid_offset(dst_x, dst_y);
+    if (config_get(CONFIG_GP_CH_FAST_ROUTING) && map_grid_is_inside(dst_x, dst_y, 1)) {
+        route_queue_goal_directed(source, dest, max_tiles, callback);
+    } else if (max_tiles >= 0) {
+        route_queue_max(source, dest, max_tiles, callback);
+    } else {
+        route_queue(source, dest, callback);
+    }
+}
+
 static void callback_calc_distance(int next_offset, int dist)
 {
     if (terrain_land_citizen.items[next_offset] >= CITIZEN_0_ROAD) {
@@ -178,10 +328,53 @@ static void callback_calc_distance(int next_offset, int dist)
     }
 }
 
+static int restore_cached_distances(int source_offset)
+{
+    for (int i = 0; i < MAX_CACHED_DISTANCES; i++) {
+        if (distance_cache.entries[i].last_used &&
+            distance_cache.entries[i].land_version == distance_cache.land_version &&
+            distance_cache.entries[i].source_offset == source_offset) {
+            distance_cache.entries[i].last_used = ++distance_cache.use_counter;
+            clear_distances();
+            memcpy(routing_distance.items, distance_cache.entries[i].distance.items, sizeof(routing_distance.items));
+            for (int offset = 0; offset < GRID_SIZE * GRID_SIZE; offset++) {
+                generation.distance[offset] = generation.current;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void store_cached_distances(int source_offset)
+{
+    int index = 0;
+    for (int i = 1; i < MAX_CACHED_DISTANCES; i++) {
+        if (distance_cache.entries[i].last_used < distance_cache.entries[index].last_used) {
+            index = i;
+        }
+    }
+    distance_cache.entries[index].source_offset = source_offset;
+    distance_cache.entries[index].land_version = distance_cache.land_version;
+    distance_cache.entries[index].last_used = ++distance_cache.use_counter;
+    for (int offset = 0; offset < GRID_SIZE * GRID_SIZE; offset++) {
+        distance_cache.entries[index].distance.items[offset] = get_distance(offset);
+    }
+}
+
 void map_routing_calculate_distances(int x, int y)
 {
     ++stats.total_routes_calculated;
-    route_queue(map_grid_offset(x, y), -1, callback_calc_distance);
+    int source_offset = map_grid_offset(x, y);
+    if (!restore_cached_distances(source_offset)) {
+        route_queue(source_offset, -1, callback_calc_distance);
+        store_cached_distances(source_offset);
+    }
+}
+
+void map_routing_clear_distance_cache(void)
+{
+    distance_cache.land_version++;
 }
 
 static void callback_calc_distance_water_boat(int next_offset, int dist)
@@ -190,7 +383,7 @@ static void callback_calc_distance_water_boat(int next_offset, int dist)
         terrain_water.items[next_offset] != WATER_N3_LOW_BRIDGE) {
         enqueue(next_offset, dist);
         if (terrain_water.items[next_offset] == WATER_N2_MAP_EDGE) {
-            routing_distance.items[next_offset] += 4;
+            set_distance(next_offset, get_distance(next_offset) + 4);
         }
     }
 }
@@ -235,7 +428,7 @@ static void callback_calc_distance_build_road(int next_offset, int dist)
     switch (terrain_land_citizen.items[next_offset]) {
         case CITIZEN_N3_AQUEDUCT:
             if (!map_can_place_road_under_aqueduct(next_offset)) {
-                routing_distance.items[next_offset] = -1;
+                set_distance(next_offset, -1);
                 blocked = 1;
             }
             break;
@@ -272,7 +465,7 @@ static void callback_calc_distance_build_aqueduct(int next_offset, int dist)
             break;
     }
     if (map_terrain_is(next_offset, TERRAIN_ROAD) && !map_can_place_aqueduct_on_road(next_offset)) {
-        routing_distance.items[next_offset] = -1;
+        set_distance(next_offset, -1);
         blocked = 1;
     }
     if (!blocked) {
@@ -389,8 +582,8 @@ int map_routing_citizen_can_travel_over_land(int src_x, int src_y, int dst_x, in
     int src_offset = map_grid_offset(src_x, src_y);
     int dst_offset = map_grid_offset(dst_x, dst_y);
     ++stats.total_routes_calculated;
-    route_queue(src_offset, dst_offset, callback_travel_citizen_land);
-    return routing_distance.items[dst_offset] != 0;
+    route_queue_to(src_offset, dst_x, dst_y, -1, callback_travel_citizen_land);
+    return get_distance(dst_offset) != 0;
 }
 
 static void callback_travel_citizen_road_garden(int next_offset, int dist)
@@ -406,8 +599,8 @@ int map_routing_citizen_can_travel_over_road_garden(int src_x, int src_y, int ds
     int src_offset = map_grid_offset(src_x, src_y);
     int dst_offset = map_grid_offset(dst_x, dst_y);
     ++stats.total_routes_calculated;
-    route_queue(src_offset, dst_offset, callback_travel_citizen_road_garden);
-    return routing_distance.items[dst_offset] != 0;
+    route_queue_to(src_offset, dst_x, dst_y, -1, callback_travel_citizen_road_garden);
+    return get_distance(dst_offset) != 0;
 }
 
 static void callback_travel_walls(int next_offset, int dist)
@@ -423,8 +616,8 @@ int map_routing_can_travel_over_walls(int src_x, int src_y, int dst_x, int dst_y
     int src_offset = map_grid_offset(src_x, src_y);
     int dst_offset = map_grid_offset(dst_x, dst_y);
     ++stats.total_routes_calculated;
-    route_queue(src_offset, dst_offset, callback_travel_walls);
-    return routing_distance.items[dst_offset] != 0;
+    route_queue_to(src_offset, dst_x, dst_y, -1, callback_travel_walls);
+    return get_distance(dst_offset) != 0;
 }
 
 static void callback_travel_noncitizen_land_through_building(int next_offset, int dist)
@@ -457,11 +650,11 @@ int map_routing_noncitizen_can_travel_over_land(int src_x, int src_y, int dst_x,
     ++stats.enemy_routes_calculated;
     if (only_through_building_id) {
         state.through_building_id = only_through_building_id;
-        route_queue(src_offset, dst_offset, callback_travel_noncitizen_land_through_building);
+        route_queue_to(src_offset, dst_x, dst_y, -1, callback_travel_noncitizen_land_through_building);
     } else {
-        route_queue_max(src_offset, dst_offset, max_tiles, callback_travel_noncitizen_land);
+        route_queue_to(src_offset, dst_x, dst_y, max_tiles, callback_travel_noncitizen_land);
     }
-    return routing_distance.items[dst_offset] != 0;
+    return get_distance(dst_offset) != 0;
 }
 
 static void callback_travel_noncitizen_through_everything(int next_offset, int dist)
@@ -476,8 +669,8 @@ int map_routing_noncitizen_can_travel_through_everything(int src_x, int src_y, i
     int src_offset = map_grid_offset(src_x, src_y);
     int dst_offset = map_grid_offset(dst_x, dst_y);
     ++stats.total_routes_calculated;
-    route_queue(src_offset, dst_offset, callback_travel_noncitizen_through_everything);
-    return routing_distance.items[dst_offset] != 0;
+    route_queue_to(src_offset, dst_x, dst_y, -1, callback_travel_noncitizen_through_everything);
+    return get_distance(dst_offset) != 0;
 }
 
 void map_routing_block(int x, int y, int size)
@@ -487,14 +680,14 @@ void map_routing_block(int x, int y, int size)
     }
     for (int dy = 0; dy < size; dy++) {
         for (int dx = 0; dx < size; dx++) {
-            routing_distance.items[map_grid_offset(x+dx, y+dy)] = 0;
+            set_distance(map_grid_offset(x+dx, y+dy), 0);
         }
     }
 }
 
 int map_routing_distance(int grid_offset)
 {
-    return routing_distance.items[grid_offset];
+    return get_distance(grid_offset);
 }
 
 void map_routing_save_state(buffer *buf)
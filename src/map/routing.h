@@ -11,6 +11,7 @@ typedef enum {
 } routed_building_type;
 
 void map_routing_calculate_distances(int x, int y);
+void map_routing_clear_distance_cache(void);
 void map_routing_calculate_distances_water_boat(int x, int y);
 void map_routing_calculate_distances_water_flotsam(int x, int y);
 
@@ -29,6 +30,8 @@ int map_routing_noncitizen_can_travel_through_everything(int src_x, int src_y, i
 
 void map_routing_block(int x, int y, int size);
 
+#define ROUTING_STATE_SIZE 16
+
 void map_routing_save_state(buffer *buf);
 
 void map_routing_load_state(buffer *buf);
@@ -9,10 +9,14 @@
 #include "map/image.h"
 #include "map/property.h"
 #include "map/random.h"
+#include "map/road_network.h"
+#include "map/routing.h"
 #include "map/routing_data.h"
 #include "map/sprite.h"
 #include "map/terrain.h"
 
+#include <string.h>
+
 static void map_routing_update_land_noncitizen(void);
 
 void map_routing_update_all(void)
@@ -109,9 +113,20 @@ static int get_land_type_citizen_aqueduct(int grid_offset)
     }
 }
 
+// Road networks are made of passable road and ramp tiles, see is_network_tile() in road_network.c
+static int is_road_network_type(int type, int terrain)
+{
+    return type == CITIZEN_0_ROAD || (type == CITIZEN_2_PASSABLE_TERRAIN && (terrain & TERRAIN_ACCESS_RAMP));
+}
+
 void map_routing_update_land_citizen(void)
 {
+    static grid_i8 previous;
+    memcpy(previous.items, terrain_land_citizen.items, sizeof(previous.items));
+    map_routing_clear_distance_cache();
     map_grid_init_i8(terrain_land_citizen.items, -1);
+    // Changes to the road and ramp terrain itself already mark the networks outdated, see map/terrain.c
+    int road_networks_changed = 0;
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
@@ -138,8 +153,15 @@ void map_routing_update_land_citizen(void)
             } else {
                 terrain_land_citizen.items[grid_offset] = CITIZEN_4_CLEAR_TERRAIN;
             }
+            if (is_road_network_type(terrain_land_citizen.items[grid_offset], terrain) !=
+                is_road_network_type(previous.items[grid_offset], terrain)) {
+                road_networks_changed = 1;
+            }
         }
     }
+    if (road_networks_changed) {
+        map_road_network_invalidate();
+    }
 }
 
 static int get_land_type_noncitizen(int grid_offset)
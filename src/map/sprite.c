@@ -1,10 +1,18 @@
 #include "sprite.h"
 
 #include "map/grid.h"
+#include "map/journal.h"
 
 static grid_u8 sprite;
+// Undo does not use a backup of the grid anymore, but saved games still contain one
 static grid_u8 sprite_backup;
 
+static void set_sprite(int grid_offset, int value)
+{
+    map_journal_record(JOURNAL_SPRITE, grid_offset, sprite.items[grid_offset]);
+    sprite.items[grid_offset] = value;
+}
+
 int map_sprite_animation_at(int grid_offset)
 {
     return sprite.items[grid_offset];
@@ -12,7 +20,7 @@ int map_sprite_animation_at(int grid_offset)
 
 void map_sprite_animation_set(int grid_offset, int value)
 {
-    sprite.items[grid_offset] = value;
+    set_sprite(grid_offset, value);
 }
 
 int map_sprite_bridge_at(int grid_offset)
@@ -22,12 +30,12 @@ int map_sprite_bridge_at(int grid_offset)
 
 void map_sprite_bridge_set(int grid_offset, int value)
 {
-    sprite.items[grid_offset] = value;
+    set_sprite(grid_offset, value);
 }
 
 void map_sprite_clear_tile(int grid_offset)
 {
-    sprite.items[grid_offset] = 0;
+    set_sprite(grid_offset, 0);
 }
 
 void map_sprite_clear(void)
@@ -35,16 +43,6 @@ void map_sprite_clear(void)
     map_grid_clear_u8(sprite.items);
 }
 
-void map_sprite_backup(void)
-{
-    map_grid_copy_u8(sprite.items, sprite_backup.items);
-}
-
-void map_sprite_restore(void)
-{
-    map_grid_copy_u8(sprite_backup.items, sprite.items);
-}
-
 void map_sprite_save_state(buffer *buf, buffer *backup)
 {
     map_grid_save_state_u8(sprite.items, buf);
@@ -23,10 +23,6 @@ void map_sprite_clear_tile(int grid_offset);
 
 void map_sprite_clear(void);
 
-void map_sprite_backup(void);
-
-void map_sprite_restore(void);
-
 void map_sprite_save_state(buffer *buf, buffer *backup);
 
 void map_sprite_load_state(buffer *buf, buffer *backup);
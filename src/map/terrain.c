@@ -1,11 +1,14 @@
 #include "terrain.h"
 
 #include "map/grid.h"
+#include "map/journal.h"
 #include "map/ring.h"
+#include "map/road_network.h"
 #include "map/routing.h"
+#include "map/tile_changes.h"
+#include "map/water_supply.h"
 
 static grid_u16 terrain_grid;
-static grid_u16 terrain_grid_backup;
 
 int map_terrain_is(int grid_offset, int terrain)
 {
@@ -17,19 +20,42 @@ int map_terrain_get(int grid_offset)
     return terrain_grid.items[grid_offset];
 }
 
+static void check_dependent_layers(int grid_offset, int old_terrain, int new_terrain)
+{
+    int changed = old_terrain ^ new_terrain;
+    if (changed & (TERRAIN_ROAD | TERRAIN_ACCESS_RAMP)) {
+        map_road_network_invalidate();
+    }
+    if (changed & (TERRAIN_AQUEDUCT | TERRAIN_WATER | TERRAIN_RESERVOIR_RANGE)) {
+        map_water_supply_network_changed();
+    }
+    if (changed & TERRAIN_FOUNTAIN_RANGE) {
+        map_water_supply_tile_changed(grid_offset, 1);
+    }
+}
+
 void map_terrain_set(int grid_offset, int terrain)
 {
+    map_journal_record(JOURNAL_TERRAIN, grid_offset, terrain_grid.items[grid_offset]);
+    check_dependent_layers(grid_offset, terrain_grid.items[grid_offset], terrain);
     terrain_grid.items[grid_offset] = terrain;
+    map_tile_changes_mark(grid_offset);
 }
 
 void map_terrain_add(int grid_offset, int terrain)
 {
+    map_journal_record(JOURNAL_TERRAIN, grid_offset, terrain_grid.items[grid_offset]);
+    check_dependent_layers(grid_offset, terrain_grid.items[grid_offset], terrain_grid.items[grid_offset] | terrain);
     terrain_grid.items[grid_offset] |= terrain;
+    map_tile_changes_mark(grid_offset);
 }
 
 void map_terrain_remove(int grid_offset, int terrain)
 {
+    map_journal_record(JOURNAL_TERRAIN, grid_offset, terrain_grid.items[grid_offset]);
+    check_dependent_layers(grid_offset, terrain_grid.items[grid_offset], terrain_grid.items[grid_offset] & ~terrain);
     terrain_grid.items[grid_offset] &= ~terrain;
+    map_tile_changes_mark(grid_offset);
 }
 
 void map_terrain_add_with_radius(int x, int y, int size, int radius, int terrain)
@@ -58,7 +84,14 @@ void map_terrain_remove_with_radius(int x, int y, int size, int radius, int terr
 
 void map_terrain_remove_all(int terrain)
 {
-    map_grid_and_u16(terrain_grid.items, ~terrain);
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        if (terrain_grid.items[i] & terrain) {
+            map_journal_record(JOURNAL_TERRAIN, i, terrain_grid.items[i]);
+            check_dependent_layers(i, terrain_grid.items[i], terrain_grid.items[i] & ~terrain);
+            terrain_grid.items[i] &= ~terrain;
+        }
+    }
+    map_tile_changes_mark_all();
 }
 
 int map_terrain_count_directly_adjacent_with_type(int grid_offset, int terrain)
@@ -325,19 +358,11 @@ void map_terrain_add_triumphal_arch_roads(int x, int y, int orientation)
 }
 
 
-void map_terrain_backup(void)
-{
-    map_grid_copy_u16(terrain_grid.items, terrain_grid_backup.items);
-}
-
-void map_terrain_restore(void)
-{
-    map_grid_copy_u16(terrain_grid_backup.items, terrain_grid.items);
-}
-
 void map_terrain_clear(void)
 {
     map_grid_clear_u16(terrain_grid.items);
+    map_tile_changes_mark_all();
+    map_road_network_invalidate();
 }
 
 void map_terrain_init_outside_map(void)
@@ -354,6 +379,7 @@ void map_terrain_init_outside_map(void)
             }
         }
     }
+    map_tile_changes_mark_all();
 }
 
 void map_terrain_save_state(buffer *buf)
@@ -364,4 +390,6 @@ void map_terrain_save_state(buffer *buf)
 void map_terrain_load_state(buffer *buf)
 {
     map_grid_load_state_u16(terrain_grid.items, buf);
+    map_tile_changes_mark_all();
+    map_road_network_invalidate();
 }
@@ -79,10 +79,6 @@ void map_terrain_add_roadblock_road(int x, int y, int orientation);
 void map_terrain_add_gatehouse_roads(int x, int y, int orientation);
 void map_terrain_add_triumphal_arch_roads(int x, int y, int orientation);
 
-void map_terrain_backup(void);
-
-void map_terrain_restore(void);
-
 void map_terrain_clear(void);
 
 void map_terrain_init_outside_map(void);
@@ -0,0 +1,43 @@
+#include "tile_changes.h"
+
+#include "map/grid.h"
+
+#include <string.h>
+
+static struct {
+    uint8_t is_changed[GRID_SIZE * GRID_SIZE];
+    int changed_offsets[GRID_SIZE * GRID_SIZE];
+    int num_changed;
+    int all_changed;
+} data = {.all_changed = 1};
+
+void map_tile_changes_mark(int grid_offset)
+{
+    if (data.all_changed || data.is_changed[grid_offset]) {
+        return;
+    }
+    data.is_changed[grid_offset] = 1;
+    data.changed_offsets[data.num_changed++] = grid_offset;
+}
+
+void map_tile_changes_mark_all(void)
+{
+    data.all_changed = 1;
+}
+
+int map_tile_changes_consume(void (*callback)(int grid_offset))
+{
+    if (data.all_changed) {
+        memset(data.is_changed, 0, sizeof(data.is_changed));
+        data.num_changed = 0;
+        data.all_changed = 0;
+        return 0;
+    }
+    for (int i = 0; i < data.num_changed; i++) {
+        int grid_offset = data.changed_offsets[i];
+        data.is_changed[grid_offset] = 0;
+        callback(grid_offset);
+    }
+    data.num_changed = 0;
+    return 1;
+}
@@ -0,0 +1,29 @@
+#ifndef MAP_TILE_CHANGES_H
+#define MAP_TILE_CHANGES_H
+
+/**
+ * @file
+ * Keeps track of the tiles whose terrain, building or figures changed,
+ * so views of the whole map only have to update those tiles.
+ */
+
+/**
+ * Marks a tile as changed
+ * @param grid_offset Tile that changed
+ */
+void map_tile_changes_mark(int grid_offset);
+
+/**
+ * Marks the whole map as changed
+ */
+void map_tile_changes_mark_all(void);
+
+/**
+ * Passes every changed tile to the callback and forgets the changes
+ * @param callback Function to call for each changed tile
+ * @return Boolean true if the changes were passed per tile,
+ *         false if the whole map changed, in which case the callback is not called
+ */
+int map_tile_changes_consume(void (*callback)(int grid_offset));
+
+#endif // MAP_TILE_CHANGES_H
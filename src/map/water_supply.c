@@ -28,6 +28,133 @@ static struct {
     int tail;
 } queue;
 
+typedef struct {
+    int id;
+    int grid_offset;
+    int x;
+    int y;
+} supply_building;
+
+typedef struct {
+    supply_building items[MAX_BUILDINGS];
+    int size;
+} supply_building_list;
+
+static struct {
+    int updating;
+    int network_needs_update;
+    int fountain_ranges_need_update;
+    int houses_need_update;
+    supply_building_list reservoirs;
+    supply_building_list active_fountains;
+    supply_building_list wells;
+    supply_building_list current;
+    uint8_t tile_changed[GRID_SIZE * GRID_SIZE];
+    int changed_tiles[GRID_SIZE * GRID_SIZE];
+    int num_changed_tiles;
+} data = {0, 1, 1, 1};
+
+static void clear_changed_tiles(void)
+{
+    for (int i = 0; i < data.num_changed_tiles; i++) {
+        data.tile_changed[data.changed_tiles[i]] = 0;
+    }
+    data.num_changed_tiles = 0;
+}
+
+static void mark_tile_changed(int grid_offset)
+{
+    if (data.houses_need_update || data.tile_changed[grid_offset]) {
+        return;
+    }
+    data.tile_changed[grid_offset] = 1;
+    data.changed_tiles[data.num_changed_tiles++] = grid_offset;
+}
+
+void map_water_supply_clear(void)
+{
+    data.network_needs_update = 1;
+    data.fountain_ranges_need_update = 1;
+    data.houses_need_update = 1;
+    data.reservoirs.size = 0;
+    data.active_fountains.size = 0;
+    data.wells.size = 0;
+    clear_changed_tiles();
+}
+
+void map_water_supply_network_changed(void)
+{
+    if (!data.updating) {
+        data.network_needs_update = 1;
+    }
+}
+
+void map_water_supply_tile_changed(int grid_offset, int fountain_range)
+{
+    if (fountain_range && !data.updating) {
+        data.fountain_ranges_need_update = 1;
+    }
+    mark_tile_changed(grid_offset);
+}
+
+static void add_supply_building(supply_building_list *list, const building *b)
+{
+    supply_building *item = &list->items[list->size++];
+    item->id = b->id;
+    item->grid_offset = b->grid_offset;
+    item->x = b->x;
+    item->y = b->y;
+}
+
+static void copy_supply_buildings(const supply_building_list *src, supply_building_list *dst)
+{
+    memcpy(dst->items, src->items, src->size * sizeof(supply_building));
+    dst->size = src->size;
+}
+
+// Both lists are sorted by building id
+static int for_each_difference(const supply_building_list *previous, const supply_building_list *current,
+    void (*callback)(const supply_building *item, const supply_building_list *current))
+{
+    int num_differences = 0;
+    int i = 0;
+    int j = 0;
+    while (i < previous->size || j < current->size) {
+        const supply_building *item;
+        if (j >= current->size || (i < previous->size && previous->items[i].id < current->items[j].id)) {
+            item = &previous->items[i++];
+        } else if (i >= previous->size || current->items[j].id < previous->items[i].id) {
+            item = &current->items[j++];
+        } else {
+            const supply_building *previous_item = &previous->items[i++];
+            item = &current->items[j++];
+            if (item->grid_offset == previous_item->grid_offset) {
+                continue;
+            }
+            if (callback) {
+                callback(previous_item, current);
+            }
+            num_differences++;
+        }
+        if (callback) {
+            callback(item, current);
+        }
+        num_differences++;
+    }
+    return num_differences;
+}
+
+static int is_well_in_range(const supply_building_list *wells, int x, int y, int size)
+{
+    for (int i = 0; i < wells->size; i++) {
+        const supply_building *well = &wells->items[i];
+        if (well->x >= x - 2 && well->x <= x + size + 1 && well->y >= y - 2 && well->y <= y + size + 1) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
 static void mark_well_access(int well_id, int radius)
 {
     building *well = building_get(well_id);
@@ -44,17 +171,11 @@ static void mark_well_access(int well_id, int radius)
     }
 }
 
-void map_water_supply_update_houses(void)
+static void update_all_houses(void)
 {
-    building_list_small_clear();
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
         building *b = building_get(i);
-        if (b->state != BUILDING_STATE_IN_USE) {
-            continue;
-        }
-        if (b->type == BUILDING_WELL) {
-            building_list_small_add(i);
-        } else if (b->house_size) {
+        if (b->state == BUILDING_STATE_IN_USE && b->house_size) {
             b->has_water_access = 0;
             b->has_well_access = 0;
             if (map_terrain_exists_tile_in_area_with_type(
@@ -63,13 +184,65 @@ void map_water_supply_update_houses(void)
             }
         }
     }
-    int total_wells = building_list_small_size();
-    const int *wells = building_list_small_items();
-    for (int i = 0; i < total_wells; i++) {
-        mark_well_access(wells[i], 2);
+    for (int i = 0; i < data.wells.size; i++) {
+        mark_well_access(data.wells.items[i].id, 2);
+    }
+}
+
+static void update_changed_tile(int grid_offset)
+{
+    int building_id = map_building_at(grid_offset);
+    if (!building_id) {
+        return;
+    }
+    building *b = building_get(building_id);
+    if (b->state == BUILDING_STATE_IN_USE && b->house_size) {
+        b->has_water_access = map_terrain_exists_tile_in_area_with_type(
+            b->x, b->y, b->size, TERRAIN_FOUNTAIN_RANGE) ? 1 : 0;
+        b->has_well_access = is_well_in_range(&data.wells, b->x, b->y, b->size);
+    } else if (is_well_in_range(&data.wells, map_grid_offset_to_x(grid_offset), map_grid_offset_to_y(grid_offset), 1)) {
+        // other buildings keep their well access, as they always have
+        b->has_well_access = 1;
     }
 }
 
+static void mark_well_range_changed(const supply_building *well, const supply_building_list *wells)
+{
+    int x_min, y_min, x_max, y_max;
+    map_grid_get_area(well->x, well->y, 1, 2, &x_min, &y_min, &x_max, &y_max);
+    for (int yy = y_min; yy <= y_max; yy++) {
+        for (int xx = x_min; xx <= x_max; xx++) {
+            mark_tile_changed(map_grid_offset(xx, yy));
+        }
+    }
+}
+
+void map_water_supply_update_houses(void)
+{
+    supply_building_list *wells = &data.current;
+    wells->size = 0;
+    building_list_small_clear();
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
+        building *b = building_get(i);
+        if (b->state == BUILDING_STATE_IN_USE && b->type == BUILDING_WELL) {
+            building_list_small_add(i);
+            add_supply_building(wells, b);
+        }
+    }
+    for_each_difference(&data.wells, wells, mark_well_range_changed);
+    copy_supply_buildings(wells, &data.wells);
+
+    if (data.houses_need_update) {
+        data.houses_need_update = 0;
+        update_all_houses();
+    } else {
+        for (int i = 0; i < data.num_changed_tiles; i++) {
+            update_changed_tile(data.changed_tiles[i]);
+        }
+    }
+    clear_changed_tiles();
+}
+
 static void set_all_aqueducts_to_no_water(void)
 {
     int image_without_water = image_group(GROUP_BUILDING_AQUEDUCT) + 15;
@@ -143,26 +316,21 @@ static void fill_aqueducts_from_offset(int grid_offset)
     } while (next_offset > -1);
 }
 
-void map_water_supply_update_reservoir_fountain(void)
+static void update_aqueduct_network(void)
 {
-    map_terrain_remove_all(TERRAIN_FOUNTAIN_RANGE | TERRAIN_RESERVOIR_RANGE);
-    // reservoirs
+    map_terrain_remove_all(TERRAIN_RESERVOIR_RANGE);
     set_all_aqueducts_to_no_water();
-    building_list_large_clear(1);
+    int total_reservoirs = building_list_large_size();
+    const int *reservoirs = building_list_large_items();
     // mark reservoirs next to water
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
-        building *b = building_get(i);
-        if (b->state == BUILDING_STATE_IN_USE && b->type == BUILDING_RESERVOIR) {
-            building_list_large_add(i);
-            if (map_terrain_exists_tile_in_area_with_type(b->x - 1, b->y - 1, 5, TERRAIN_WATER)) {
-                b->has_water_access = 2;
-            } else {
-                b->has_water_access = 0;
-            }
+    for (int i = 0; i < total_reservoirs; i++) {
+        building *b = building_get(reservoirs[i]);
+        if (map_terrain_exists_tile_in_area_with_type(b->x - 1, b->y - 1, 5, TERRAIN_WATER)) {
+            b->has_water_access = 2;
+        } else {
+            b->has_water_access = 0;
         }
     }
-    int total_reservoirs = building_list_large_size();
-    const int *reservoirs = building_list_large_items();
     // fill reservoirs from full ones
     int changed = 1;
     static const int CONNECTOR_OFFSETS[] = {OFFSET(1,-1), OFFSET(3,1), OFFSET(1,3), OFFSET(-1,1)};
@@ -186,8 +354,62 @@ void map_water_supply_update_reservoir_fountain(void)
             map_terrain_add_with_radius(b->x, b->y, 3, 10, TERRAIN_RESERVOIR_RANGE);
         }
     }
-    // fountains
-    for (int i = 1; i < MAX_BUILDINGS; i++) {
+}
+
+static void update_reservoirs(void)
+{
+    supply_building_list *reservoirs = &data.current;
+    reservoirs->size = 0;
+    building_list_large_clear(1);
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
+        building *b = building_get(i);
+        if (b->state == BUILDING_STATE_IN_USE && b->type == BUILDING_RESERVOIR) {
+            building_list_large_add(i);
+            add_supply_building(reservoirs, b);
+        }
+    }
+    if (for_each_difference(&data.reservoirs, reservoirs, 0)) {
+        data.network_needs_update = 1;
+        copy_supply_buildings(reservoirs, &data.reservoirs);
+    }
+    if (data.network_needs_update) {
+        data.network_needs_update = 0;
+        update_aqueduct_network();
+    }
+}
+
+static int fountain_radius(void)
+{
+    return scenario_property_climate() == CLIMATE_DESERT ? 3 : 4;
+}
+
+static void update_fountain_range_around(const supply_building *fountain, const supply_building_list *fountains)
+{
+    int radius = fountain_radius();
+    int x_min, y_min, x_max, y_max;
+    map_grid_get_area(fountain->x, fountain->y, 1, radius, &x_min, &y_min, &x_max, &y_max);
+    for (int yy = y_min; yy <= y_max; yy++) {
+        for (int xx = x_min; xx <= x_max; xx++) {
+            int in_range = 0;
+            for (int i = 0; i < fountains->size && !in_range; i++) {
+                const supply_building *f = &fountains->items[i];
+                in_range = f->x >= xx - radius && f->x <= xx + radius && f->y >= yy - radius && f->y <= yy + radius;
+            }
+            int grid_offset = map_grid_offset(xx, yy);
+            if (in_range && !map_terrain_is(grid_offset, TERRAIN_FOUNTAIN_RANGE)) {
+                map_terrain_add(grid_offset, TERRAIN_FOUNTAIN_RANGE);
+            } else if (!in_range && map_terrain_is(grid_offset, TERRAIN_FOUNTAIN_RANGE)) {
+                map_terrain_remove(grid_offset, TERRAIN_FOUNTAIN_RANGE);
+            }
+        }
+    }
+}
+
+static void update_fountains(void)
+{
+    supply_building_list *active_fountains = &data.current;
+    active_fountains->size = 0;
+    for (int i = building_next_id(0); i; i = building_next_id(i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || b->type != BUILDING_FOUNTAIN) {
             continue;
@@ -206,13 +428,31 @@ void map_water_supply_update_reservoir_fountain(void)
         map_building_tiles_add(i, b->x, b->y, 1, image_id, TERRAIN_BUILDING);
         if (map_terrain_is(b->grid_offset, TERRAIN_RESERVOIR_RANGE) && b->num_workers) {
             b->has_water_access = 1;
-            map_terrain_add_with_radius(b->x, b->y, 1,
-                scenario_property_climate() == CLIMATE_DESERT ? 3 : 4,
-                TERRAIN_FOUNTAIN_RANGE);
+            add_supply_building(active_fountains, b);
         } else {
             b->has_water_access = 0;
         }
     }
+    if (data.fountain_ranges_need_update) {
+        data.fountain_ranges_need_update = 0;
+        map_terrain_remove_all(TERRAIN_FOUNTAIN_RANGE);
+        for (int i = 0; i < active_fountains->size; i++) {
+            const supply_building *f = &active_fountains->items[i];
+            map_terrain_add_with_radius(f->x, f->y, 1, fountain_radius(), TERRAIN_FOUNTAIN_RANGE);
+        }
+    } else {
+        // only the ranges around fountains that were switched on or off change
+        for_each_difference(&data.active_fountains, active_fountains, update_fountain_range_around);
+    }
+    copy_supply_buildings(active_fountains, &data.active_fountains);
+}
+
+void map_water_supply_update_reservoir_fountain(void)
+{
+    data.updating = 1;
+    update_reservoirs();
+    update_fountains();
+    data.updating = 0;
 }
 
 int map_water_supply_is_well_unnecessary(int well_id, int radius)
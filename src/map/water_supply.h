@@ -1,6 +1,30 @@
 #ifndef MAP_WATER_SUPPLY_H
 #define MAP_WATER_SUPPLY_H
 
+/**
+ * @file
+ * Water from reservoirs through aqueducts to fountains, and from fountains and wells to houses.
+ * The map layers report the tiles that change, so a daily update only redoes the parts of
+ * the water supply that changed since the previous one.
+ */
+
+/**
+ * Forgets what is known about the water supply, so the next updates recalculate everything
+ */
+void map_water_supply_clear(void);
+
+/**
+ * Marks the aqueduct network as changed: an aqueduct, water or reservoir range tile changed
+ */
+void map_water_supply_network_changed(void);
+
+/**
+ * Marks a tile whose fountain range or building changed, so the houses on it are updated
+ * @param grid_offset Tile that changed
+ * @param fountain_range Boolean true if the fountain range changed, false if the building changed
+ */
+void map_water_supply_tile_changed(int grid_offset, int fountain_range);
+
 void map_water_supply_update_houses(void);
 void map_water_supply_update_reservoir_fountain(void);
 
@@ -82,6 +82,12 @@ typedef const char * dir_name;
 #include <unistd.h>
 #endif
 
+#if !defined(_WIN32) && !defined(__vita__) && !defined(__SWITCH__)
+#define USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
 static int is_file(int mode)
 {
     return S_ISREG(mode) || S_ISLNK(mode);
@@ -138,6 +144,45 @@ int platform_file_manager_list_directory_contents(const char *dir, int type, con
     return match;
 }
 
+long long platform_file_manager_get_modification_time(const char *path)
+{
+    if (!path || !*path) {
+        path = ".";
+    }
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA file_info;
+    wchar_t *wpath = utf8_to_wchar(path);
+    int result = GetFileAttributesExW(wpath, GetFileExInfoStandard, &file_info);
+    free(wpath);
+    if (!result) {
+        return 0;
+    }
+    // 100 nanosecond intervals
+    return (long long) (((unsigned long long) file_info.ftLastWriteTime.dwHighDateTime << 32) |
+        file_info.ftLastWriteTime.dwLowDateTime);
+#else
+#ifdef __vita__
+    char *resolved_path = vita_prepend_path(path);
+    path = resolved_path;
+#endif
+    struct stat file_info;
+    int result = stat(path, &file_info);
+#ifdef __vita__
+    free(resolved_path);
+#endif
+    if (result != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return (long long) file_info.st_mtimespec.tv_sec * 1000000000 + file_info.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+    return (long long) file_info.st_mtim.tv_sec * 1000000000 + file_info.st_mtim.tv_nsec;
+#else
+    return (long long) file_info.st_mtime;
+#endif
+#endif
+}
+
 int platform_file_manager_should_case_correct_file(void)
 {
 #ifdef _WIN32
@@ -171,6 +216,16 @@ FILE *platform_file_manager_open_file(const char *filename, const char *mode)
     return fp;
 }
 
+int platform_file_manager_rename_file(const char *filename, const char *new_filename)
+{
+    char *resolved_path = vita_prepend_path(filename);
+    char *resolved_new_path = vita_prepend_path(new_filename);
+    int result = rename(resolved_path, resolved_new_path) == 0;
+    free(resolved_path);
+    free(resolved_new_path);
+    return result;
+}
+
 #elif defined(_WIN32)
 
 FILE *platform_file_manager_open_file(const char *filename, const char *mode)
@@ -186,6 +241,20 @@ FILE *platform_file_manager_open_file(const char *filename, const char *mode)
     return fp;
 }
 
+int platform_file_manager_rename_file(const char *filename, const char *new_filename)
+{
+    wchar_t *wfile = utf8_to_wchar(filename);
+    wchar_t *wnew_file = utf8_to_wchar(new_filename);
+
+    // rename() does not replace an existing file on Windows
+    int result = MoveFileExW(wfile, wnew_file, MOVEFILE_REPLACE_EXISTING) != 0;
+
+    free(wfile);
+    free(wnew_file);
+
+    return result;
+}
+
 #else
 
 FILE *platform_file_manager_open_file(const char *filename, const char *mode)
@@ -193,4 +262,101 @@ FILE *platform_file_manager_open_file(const char *filename, const char *mode)
     return fopen(filename, mode);
 }
 
+int platform_file_manager_rename_file(const char *filename, const char *new_filename)
+{
+    return rename(filename, new_filename) == 0;
+}
+
+#endif
+
+#if defined(_WIN32)
+
+const void *platform_file_manager_map_file(const char *filename, size_t *size)
+{
+    wchar_t *wfile = utf8_to_wchar(filename);
+    HANDLE file = CreateFileW(wfile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    free(wfile);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0 || (uint64_t) file_size.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return NULL;
+    }
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) {
+        return NULL;
+    }
+    // The view keeps the mapping alive
+    const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data) {
+        *size = (size_t) file_size.QuadPart;
+    }
+    return data;
+}
+
+void platform_file_manager_unmap_file(const void *data, size_t size)
+{
+    UnmapViewOfFile(data);
+}
+
+#elif defined(USE_MMAP)
+
+const void *platform_file_manager_map_file(const char *filename, size_t *size)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0 || file_info.st_size <= 0 || (uint64_t) file_info.st_size > SIZE_MAX) {
+        close(fd);
+        return NULL;
+    }
+    void *data = mmap(NULL, (size_t) file_info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+    *size = (size_t) file_info.st_size;
+    return data;
+}
+
+void platform_file_manager_unmap_file(const void *data, size_t size)
+{
+    munmap((void *) data, size);
+}
+
+#else
+
+// No memory mapping available: read the whole file instead
+const void *platform_file_manager_map_file(const char *filename, size_t *size)
+{
+    FILE *fp = platform_file_manager_open_file(filename, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    long file_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    void *data = file_size > 0 ? malloc((size_t) file_size) : NULL;
+    if (data && fread(data, 1, (size_t) file_size, fp) != (size_t) file_size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(fp);
+    if (data) {
+        *size = (size_t) file_size;
+    }
+    return data;
+}
+
+void platform_file_manager_unmap_file(const void *data, size_t size)
+{
+    free((void *) data);
+}
+
 #endif
@@ -1,6 +1,7 @@
 #ifndef PLATFORM_FILE_MANAGER_H
 #define PLATFORM_FILE_MANAGER_H
 
+#include <stddef.h>
 #include <stdio.h>
 
 enum {
@@ -34,6 +35,16 @@ int platform_file_manager_set_base_path(const char *path);
  */
 int platform_file_manager_list_directory_contents(const char *dir, int type, const char *extension, int (*callback)(const char *));
 
+/**
+ * Gets the time a file or directory was last modified. For a directory,
+ * this changes whenever entries are added, removed or renamed.
+ * The time has the finest resolution the platform offers, so it is only meant
+ * to be compared with other times returned by this function.
+ * @param path The file or directory, or null if base directory
+ * @return The modification time, or 0 if it could not be determined
+ */
+long long platform_file_manager_get_modification_time(const char *path);
+
 /**
  * Indicates whether the file name casing should be checked
  * @return Whether file name casing should be checked
@@ -55,4 +66,27 @@ FILE *platform_file_manager_open_file(const char *filename, const char *mode);
  */
 int platform_file_manager_remove_file(const char *filename);
 
+/**
+ * Renames a file, replacing the destination if it exists
+ * @param filename The file to rename
+ * @param new_filename The new name of the file
+ * @return true if renaming was successful, false otherwise
+ */
+int platform_file_manager_rename_file(const char *filename, const char *new_filename);
+
+/**
+ * Maps a file into memory for reading. Platforms without memory mapping read the whole file instead
+ * @param filename The file to map
+ * @param size Set to the size of the file on success
+ * @return A pointer to the contents of the file on success, NULL otherwise
+ */
+const void *platform_file_manager_map_file(const char *filename, size_t *size);
+
+/**
+ * Releases a file mapped by platform_file_manager_map_file
+ * @param data The pointer returned by platform_file_manager_map_file
+ * @param size The size of the file
+ */
+void platform_file_manager_unmap_file(const void *data, size_t size);
+
 #endif // PLATFORM_FILE_MANAGER_H
@@ -7,6 +7,7 @@
 #include "core/time.h"
 #include "game/game.h"
 #include "game/system.h"
+#include "graphics/screenshot.h"
 #include "input/mouse.h"
 #include "input/touch.h"
 #include "platform/arguments.h"
@@ -17,6 +18,7 @@
 #include "platform/prefs.h"
 #include "platform/screen.h"
 #include "platform/touch.h"
+#include "platform/worker_pool.h"
 
 #include "tinyfiledialogs/tinyfiledialogs.h"
 
@@ -152,6 +154,7 @@ static void run_and_draw(void)
     time_set_millis(time_before_run);
 
     game_run();
+    graphics_update_screenshot();
     Uint32 time_between_run_and_draw = SDL_GetTicks();
     game_draw();
     Uint32 time_after_draw = SDL_GetTicks();
@@ -179,6 +182,7 @@ static void run_and_draw(void)
     time_set_millis(SDL_GetTicks());
 
     game_run();
+    graphics_update_screenshot();
     game_draw();
 
     platform_screen_render();
@@ -494,6 +498,7 @@ static void teardown(void)
 {
     SDL_Log("Exiting game");
     game_exit();
+    platform_worker_pool_shutdown();
     platform_screen_destroy();
     SDL_Quit();
     teardown_logging();
@@ -0,0 +1,256 @@
+#include "worker_pool.h"
+
+#include "core/log.h"
+#include "game/system.h"
+
+#include "SDL.h"
+
+#include <stdint.h>
+
+#define MAX_WORKERS 8
+#define MAX_BACKGROUND_JOBS 16
+
+typedef struct {
+    int id;
+    int is_running;
+    system_background_job job;
+    void *userdata;
+} background_job;
+
+static struct {
+    int initialized;
+    int num_workers;
+    int quit;
+    SDL_Thread *threads[MAX_WORKERS];
+    SDL_mutex *mutex;
+    SDL_cond *work_available;
+    SDL_cond *work_done;
+    unsigned int batch;
+    system_parallel_job job;
+    void *userdata;
+    int num_jobs;
+    int next_job;
+    int jobs_remaining;
+    background_job background_jobs[MAX_BACKGROUND_JOBS];
+    int background_jobs_queued;
+    int last_background_id;
+} data;
+
+// Must be called with the mutex locked
+static void run_pending_jobs(int worker)
+{
+    while (data.next_job < data.num_jobs) {
+        int index = data.next_job++;
+        system_parallel_job job = data.job;
+        void *userdata = data.userdata;
+        SDL_UnlockMutex(data.mutex);
+        job(userdata, index, worker);
+        SDL_LockMutex(data.mutex);
+        data.jobs_remaining--;
+        if (!data.jobs_remaining) {
+            SDL_CondSignal(data.work_done);
+        }
+    }
+}
+
+// Must be called with the mutex locked. Jobs run in the order in which they were started.
+static void run_background_job(void)
+{
+    background_job *next = 0;
+    for (int i = 0; i < MAX_BACKGROUND_JOBS; i++) {
+        background_job *job = &data.background_jobs[i];
+        if (job->id && !job->is_running && (!next || job->id < next->id)) {
+            next = job;
+        }
+    }
+    if (!next) {
+        return;
+    }
+    next->is_running = 1;
+    data.background_jobs_queued--;
+    SDL_UnlockMutex(data.mutex);
+    next->job(next->userdata);
+    SDL_LockMutex(data.mutex);
+    next->id = 0;
+    next->is_running = 0;
+}
+
+static int worker_thread(void *worker)
+{
+    unsigned int last_batch = 0;
+    SDL_LockMutex(data.mutex);
+    while (1) {
+        while (data.batch == last_batch && !data.background_jobs_queued && !data.quit) {
+            SDL_CondWait(data.work_available, data.mutex);
+        }
+        if (data.quit) {
+            break;
+        }
+        // Parallel jobs come first, since the main thread is waiting for them
+        if (data.batch != last_batch) {
+            last_batch = data.batch;
+            run_pending_jobs((int) (intptr_t) worker);
+        } else {
+            run_background_job();
+        }
+    }
+    SDL_UnlockMutex(data.mutex);
+    return 0;
+}
+
+static void init_workers(void)
+{
+    if (data.initialized) {
+        return;
+    }
+    data.initialized = 1;
+    data.num_workers = 1;
+
+    int cpus = SDL_GetCPUCount();
+    if (cpus > MAX_WORKERS) {
+        cpus = MAX_WORKERS;
+    }
+    if (cpus <= 1) {
+        return;
+    }
+    data.mutex = SDL_CreateMutex();
+    data.work_available = SDL_CreateCond();
+    data.work_done = SDL_CreateCond();
+    if (!data.mutex || !data.work_available || !data.work_done) {
+        log_error("Unable to create worker synchronization, running jobs on the main thread", SDL_GetError(), 0);
+        return;
+    }
+    // The calling thread is worker 0
+    while (data.num_workers < cpus) {
+        SDL_Thread *thread = SDL_CreateThread(worker_thread, "worker", (void *) (intptr_t) data.num_workers);
+        if (!thread) {
+            log_error("Unable to create worker thread", SDL_GetError(), 0);
+            break;
+        }
+        data.threads[data.num_workers++] = thread;
+    }
+    log_info("Parallel workers:", 0, data.num_workers);
+}
+
+int system_parallel_worker_count(void)
+{
+    init_workers();
+    return data.num_workers;
+}
+
+void system_run_parallel(system_parallel_job job, void *userdata, int num_jobs)
+{
+    init_workers();
+    if (data.num_workers <= 1 || num_jobs <= 1) {
+        for (int i = 0; i < num_jobs; i++) {
+            job(userdata, i, 0);
+        }
+        return;
+    }
+    SDL_LockMutex(data.mutex);
+    data.job = job;
+    data.userdata = userdata;
+    data.num_jobs = num_jobs;
+    data.next_job = 0;
+    data.jobs_remaining = num_jobs;
+    data.batch++;
+    SDL_CondBroadcast(data.work_available);
+
+    run_pending_jobs(0);
+    while (data.jobs_remaining) {
+        SDL_CondWait(data.work_done, data.mutex);
+    }
+    SDL_UnlockMutex(data.mutex);
+}
+
+int system_start_background_job(system_background_job job, void *userdata)
+{
+    init_workers();
+    if (data.num_workers <= 1) {
+        job(userdata);
+        return 0;
+    }
+    SDL_LockMutex(data.mutex);
+    background_job *slot = 0;
+    for (int i = 0; i < MAX_BACKGROUND_JOBS; i++) {
+        if (!data.background_jobs[i].id) {
+            slot = &data.background_jobs[i];
+            break;
+        }
+    }
+    if (!slot) {
+        SDL_UnlockMutex(data.mutex);
+        job(userdata);
+        return 0;
+    }
+    data.last_background_id++;
+    if (data.last_background_id <= 0) {
+        data.last_background_id = 1;
+    }
+    slot->id = data.last_background_id;
+    slot->job = job;
+    slot->userdata = userdata;
+    data.background_jobs_queued++;
+    int id = slot->id;
+    SDL_CondSignal(data.work_available);
+    SDL_UnlockMutex(data.mutex);
+    return id;
+}
+
+int system_background_job_done(int id)
+{
+    if (!id) {
+        return 1;
+    }
+    int is_done = 1;
+    SDL_LockMutex(data.mutex);
+    for (int i = 0; i < MAX_BACKGROUND_JOBS; i++) {
+        if (data.background_jobs[i].id == id) {
+            is_done = 0;
+            break;
+        }
+    }
+    SDL_UnlockMutex(data.mutex);
+    return is_done;
+}
+
+system_mutex *system_mutex_create(void)
+{
+    return (system_mutex *) SDL_CreateMutex();
+}
+
+void system_mutex_lock(system_mutex *mutex)
+{
+    if (mutex) {
+        SDL_LockMutex((SDL_mutex *) mutex);
+    }
+}
+
+void system_mutex_unlock(system_mutex *mutex)
+{
+    if (mutex) {
+        SDL_UnlockMutex((SDL_mutex *) mutex);
+    }
+}
+
+void platform_worker_pool_shutdown(void)
+{
+    if (data.num_workers <= 1) {
+        return;
+    }
+    SDL_LockMutex(data.mutex);
+    data.quit = 1;
+    SDL_CondBroadcast(data.work_available);
+    SDL_UnlockMutex(data.mutex);
+    for (int i = 1; i < data.num_workers; i++) {
+        SDL_WaitThread(data.threads[i], 0);
+        data.threads[i] = 0;
+    }
+    data.num_workers = 1;
+    SDL_DestroyCond(data.work_available);
+    SDL_DestroyCond(data.work_done);
+    SDL_DestroyMutex(data.mutex);
+    data.work_available = 0;
+    data.work_done = 0;
+    data.mutex = 0;
+}
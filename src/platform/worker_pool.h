@@ -0,0 +1,15 @@
+#ifndef PLATFORM_WORKER_POOL_H
+#define PLATFORM_WORKER_POOL_H
+
+/**
+ * @file
+ * Worker threads behind system_run_parallel().
+ */
+
+/**
+ * Wakes up and joins all worker threads. Jobs run on the calling thread afterwards.
+ * Must be called before SDL is shut down.
+ */
+void platform_worker_pool_shutdown(void);
+
+#endif // PLATFORM_WORKER_POOL_H
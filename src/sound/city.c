@@ -198,6 +198,13 @@ void sound_city_set_volume(int percentage)
     }
 }
 
+static void mark_channel_view(int channel, int direction)
+{
+    channels[channel].available = 1;
+    ++channels[channel].total_views;
+    ++channels[channel].direction_views[direction];
+}
+
 void sound_city_mark_building_view(building *b, int direction)
 {
     if (b->state == BUILDING_STATE_UNUSED) {
@@ -215,10 +222,15 @@ void sound_city_mark_building_view(building *b, int direction)
             return;
         }
     }
+    mark_channel_view(channel, direction);
+}
 
-    channels[channel].available = 1;
-    ++channels[channel].total_views;
-    ++channels[channel].direction_views[direction];
+void sound_city_mark_type_view(building_type type, int direction)
+{
+    int channel = BUILDING_TYPE_TO_CHANNEL_ID[type];
+    if (channel) {
+        mark_channel_view(channel, direction);
+    }
 }
 
 void sound_city_decay_views(void)
@@ -16,6 +16,8 @@ void sound_city_set_volume(int percentage);
 
 void sound_city_mark_building_view(building *b, int direction);
 
+void sound_city_mark_type_view(building_type type, int direction);
+
 void sound_city_decay_views(void);
 
 void sound_city_play(void);
@@ -4,6 +4,8 @@
 #include "sound/channel.h"
 #include "sound/device.h"
 
+static int muted;
+
 void sound_effect_set_volume(int percentage)
 {
     for (int i = SOUND_CHANNEL_EFFECTS_MIN; i <= SOUND_CHANNEL_EFFECTS_MAX; i++) {
@@ -13,7 +15,7 @@ void sound_effect_set_volume(int percentage)
 
 void sound_effect_play(int effect)
 {
-    if (!setting_sound(SOUND_EFFECTS)->enabled) {
+    if (muted || !setting_sound(SOUND_EFFECTS)->enabled) {
         return;
     }
     if (sound_device_is_channel_playing(effect)) {
@@ -21,3 +23,8 @@ void sound_effect_play(int effect)
     }
     sound_device_play_channel(effect, setting_sound(SOUND_EFFECTS)->volume);
 }
+
+void sound_effect_set_muted(int is_muted)
+{
+    muted = is_muted;
+}
@@ -47,4 +47,10 @@ void sound_effect_set_volume(int percentage);
 
 void sound_effect_play(int effect);
 
+/**
+ * Skips all effects until unmuted, used while the game runs many ticks without drawing them
+ * @param muted Boolean true to skip effects
+ */
+void sound_effect_set_muted(int muted);
+
 #endif // SOUND_EFFECTS_H
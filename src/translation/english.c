@@ -71,6 +71,7 @@ static translation_string all_strings[] = {
     {TR_CONFIG_RANDOM_COLLAPSES_TAKE_MONEY, "Randomly collapsing clay pits and iron mines take some money instead"},
     {TR_CONFIG_MULTIPLE_BARRACKS, "Allow building multiple barracks." },
     {TR_CONFIG_NOT_ACCEPTING_WAREHOUSES, "Warehouses don't accept anything when built"},
+    {TR_CONFIG_FAST_ROUTING, "Faster walker route finding (walkers may pick different paths)"},
     {TR_HOTKEY_TITLE, "Augustus hotkey configuration"},
     {TR_HOTKEY_LABEL, "Hotkey"},
     {TR_HOTKEY_ALTERNATIVE_LABEL, "Alternative"},
@@ -92,6 +93,11 @@ static translation_string all_strings[] = {
     {TR_HOTKEY_RESIZE_TO_1024, "Resize window to 1024x768"},
     {TR_HOTKEY_SAVE_SCREENSHOT, "Save screenshot"},
     {TR_HOTKEY_SAVE_CITY_SCREENSHOT, "Save full city screenshot"},
+    {TR_HOTKEY_TOGGLE_PROFILER, "Toggle performance graph"},
+    {TR_HOTKEY_DUMP_PROFILER, "Save performance data"},
+    {TR_HOTKEY_TOGGLE_TURBO, "Toggle fast forward"},
+    {TR_HOTKEY_UNDO, "Undo construction"},
+    {TR_HOTKEY_REDO, "Redo construction"},
     {TR_HOTKEY_LOAD_FILE, "Load file"},
     {TR_HOTKEY_SAVE_FILE, "Save file"},
     {TR_HOTKEY_INCREASE_GAME_SPEED, "Increase game speed"},
@@ -130,7 +136,12 @@ static translation_string all_strings[] = {
     {TR_HOTKEY_EDITOR_TOGGLE_BATTLE_INFO, "Toggle battle info"},
     {TR_HOTKEY_EDIT_TITLE, "Press new hotkey"},
     {TR_BUILDING_ROADBLOCK, "Roadblock"},
-    {TR_BUILDING_ROADBLOCK_DESC, "Roadblock stops loitering citizens."}
+    {TR_BUILDING_ROADBLOCK_DESC, "Roadblock stops loitering citizens."},
+    {TR_PROFILER_TICK, "Tick (us):"},
+    {TR_PROFILER_SLOWEST_SLOT, "Slowest slot"},
+    {TR_PROFILER_CITY_DRAW, "City draw (us):"},
+    {TR_PROFILER_EXTERNAL_IMAGES, "External images (hits / misses):"},
+    {TR_FAST_FORWARD, "Fast forward"}
 };
 
 void translation_english(const translation_string **strings, int *num_strings)
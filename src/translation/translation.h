@@ -63,6 +63,7 @@ typedef enum {
     TR_CONFIG_RANDOM_COLLAPSES_TAKE_MONEY,
     TR_CONFIG_MULTIPLE_BARRACKS,
     TR_CONFIG_NOT_ACCEPTING_WAREHOUSES,
+    TR_CONFIG_FAST_ROUTING,
     TR_HOTKEY_TITLE,
     TR_HOTKEY_LABEL,
     TR_HOTKEY_ALTERNATIVE_LABEL,
@@ -84,6 +85,11 @@ typedef enum {
     TR_HOTKEY_RESIZE_TO_1024,
     TR_HOTKEY_SAVE_SCREENSHOT,
     TR_HOTKEY_SAVE_CITY_SCREENSHOT,
+    TR_HOTKEY_TOGGLE_PROFILER,
+    TR_HOTKEY_DUMP_PROFILER,
+    TR_HOTKEY_TOGGLE_TURBO,
+    TR_HOTKEY_UNDO,
+    TR_HOTKEY_REDO,
     TR_HOTKEY_LOAD_FILE,
     TR_HOTKEY_SAVE_FILE,
     TR_HOTKEY_INCREASE_GAME_SPEED,
@@ -123,6 +129,11 @@ typedef enum {
     TR_HOTKEY_EDIT_TITLE,
     TR_BUILDING_ROADBLOCK,
     TR_BUILDING_ROADBLOCK_DESC,
+    TR_PROFILER_TICK,
+    TR_PROFILER_SLOWEST_SLOT,
+    TR_PROFILER_CITY_DRAW,
+    TR_PROFILER_EXTERNAL_IMAGES,
+    TR_FAST_FORWARD,
     TRANSLATION_MAX_KEY
 } translation_key;
 
@@ -10,6 +10,7 @@
 #include "core/direction.h"
 #include "core/string.h"
 #include "figure/formation_legion.h"
+#include "game/profiler.h"
 #include "game/settings.h"
 #include "game/state.h"
 #include "graphics/graphics.h"
@@ -66,6 +67,7 @@ static void update_zoom_level(void)
 
 void widget_city_draw(void)
 {
+    time_micros start = profiler_is_enabled() ? time_get_micros() : 0;
     if (config_get(CONFIG_UI_ZOOM)) {
         update_zoom_level();
         graphics_set_active_canvas(CANVAS_CITY);
@@ -79,6 +81,9 @@ void widget_city_draw(void)
     }
 
     graphics_set_active_canvas(CANVAS_UI);
+    if (profiler_is_enabled()) {
+        profiler_record(PROFILER_CITY_DRAW, start);
+    }
 }
 
 void widget_city_draw_for_figure(int figure_id, pixel_coordinate *coord)
@@ -15,6 +15,8 @@
 #include "core/time.h"
 #include "figure/formation_legion.h"
 #include "game/resource.h"
+#include "game/system.h"
+#include "graphics/graphics.h"
 #include "graphics/image.h"
 #include "map/building.h"
 #include "map/figure.h"
@@ -28,8 +30,14 @@
 #include "widget/city_building_ghost.h"
 #include "widget/city_figure.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #define OFFSET(x,y) (x + GRID_SIZE * y)
 
+// Tiles drawn up to this far above a band can still draw into it
+#define BAND_MARGIN_ABOVE 180
+
 static const int ADJACENT_OFFSETS[2][4][7] = {
     {
         { OFFSET(-1, 0), OFFSET(-1, -1),  OFFSET(-1, -2), OFFSET(0, -2), OFFSET(1, -2) },
@@ -54,8 +62,54 @@ static struct {
     int selected_figure_id;
     int highlighted_formation;
     pixel_coordinate *selected_figure_coord;
+    int use_footprint_cache;
+    int draw_all_footprints;
+    int use_stored_animation_offsets;
+    int animation_offsets[GRID_SIZE * GRID_SIZE];
 } draw_context;
 
+// In threaded mode, tops, figures and animations are drawn in horizontal bands of the viewport,
+// one band per worker. Every band has its own clip rectangle and visits all tiles that can reach
+// into it, in the normal draw order, so each pixel ends up exactly as in a single-threaded draw.
+static struct {
+    int num_bands;
+    int x;
+    int y;
+    int width;
+    int height;
+    int margin_below;
+} render_bands;
+
+typedef struct {
+    map_callback *callback1;
+    map_callback *callback2;
+    map_callback *callback3;
+    graphics_state graphics;
+} band_pass;
+
+// Drawing state for city_without_overlay_draw_offscreen_rows(), which runs on worker threads
+static graphics_state offscreen_graphics;
+
+// Footprints never overlap and only change when the image of a tile changes, so the footprint
+// layer of the viewport is kept between frames. Each frame it is copied back to the canvas and
+// only tiles with a different image are drawn again. Tops, figures and animations are interleaved
+// in draw order and are still drawn every frame.
+static struct {
+    color_t *pixels;
+    int x;
+    int y;
+    int width;
+    int height;
+    int camera_x;
+    int camera_y;
+    int camera_odd_row;
+    int orientation;
+    int scale;
+    int is_valid;
+    int has_changes;
+    int drawn_image_ids[GRID_SIZE * GRID_SIZE]; // image id + 1, 0 when nothing is drawn
+} footprint_cache;
+
 static void init_draw_context(int selected_figure_id, pixel_coordinate *figure_coord, int highlighted_formation)
 {
     draw_context.advance_water_animation = 0;
@@ -98,12 +152,35 @@ static int has_adjacent_deletion(int grid_offset)
     return 0;
 }
 
+static int footprint_needs_drawing(int grid_offset, int image_id)
+{
+    if (!draw_context.use_footprint_cache) {
+        return 1;
+    }
+    if (footprint_cache.drawn_image_ids[grid_offset] == image_id + 1 && !draw_context.draw_all_footprints) {
+        return 0;
+    }
+    footprint_cache.drawn_image_ids[grid_offset] = image_id + 1;
+    footprint_cache.has_changes = 1;
+    return 1;
+}
+
+static int footprint_image_at(int grid_offset)
+{
+    if (map_property_is_constructing(grid_offset)) {
+        return image_group(GROUP_TERRAIN_OVERLAY);
+    }
+    return map_image_at(grid_offset);
+}
+
 static void draw_footprint(int x, int y, int grid_offset)
 {
     building_construction_record_view_position(x, y, grid_offset);
     if (grid_offset < 0) {
         // Outside map: draw black tile
-        image_draw_isometric_footprint_from_draw_tile(image_group(GROUP_TERRAIN_BLACK), x, y, 0);
+        if (!draw_context.use_footprint_cache || draw_context.draw_all_footprints) {
+            image_draw_isometric_footprint_from_draw_tile(image_group(GROUP_TERRAIN_BLACK), x, y, 0);
+        }
     } else if (map_property_is_draw_tile(grid_offset)) {
         // Valid grid_offset and leftmost tile -> draw
         int building_id = map_building_at(grid_offset);
@@ -120,14 +197,9 @@ static void draw_footprint(int x, int y, int grid_offset)
             }
         }
         if (map_terrain_is(grid_offset, TERRAIN_GARDEN)) {
-            building *b = building_get(0); // abuse empty building
-            b->type = BUILDING_GARDENS;
-            sound_city_mark_building_view(b, SOUND_DIRECTION_CENTER);
-        }
-        int image_id = map_image_at(grid_offset);
-        if (map_property_is_constructing(grid_offset)) {
-            image_id = image_group(GROUP_TERRAIN_OVERLAY);
+            sound_city_mark_type_view(BUILDING_GARDENS, SOUND_DIRECTION_CENTER);
         }
+        int image_id = footprint_image_at(grid_offset);
         if (draw_context.advance_water_animation &&
             image_id >= draw_context.image_id_water_first &&
             image_id <= draw_context.image_id_water_last) {
@@ -137,8 +209,108 @@ static void draw_footprint(int x, int y, int grid_offset)
             }
             map_image_set(grid_offset, image_id);
         }
-        image_draw_isometric_footprint_from_draw_tile(image_id, x, y, 0);
+        if (footprint_needs_drawing(grid_offset, image_id)) {
+            image_draw_isometric_footprint_from_draw_tile(image_id, x, y, 0);
+        }
+    } else if (draw_context.use_footprint_cache) {
+        footprint_cache.drawn_image_ids[grid_offset] = 0;
+    }
+}
+
+// Draws the footprint only, used for the parts of the viewport that scrolled into view
+static void draw_footprint_uncached(int x, int y, int grid_offset)
+{
+    if (grid_offset < 0) {
+        image_draw_isometric_footprint_from_draw_tile(image_group(GROUP_TERRAIN_BLACK), x, y, 0);
+    } else if (map_property_is_draw_tile(grid_offset)) {
+        image_draw_isometric_footprint_from_draw_tile(footprint_image_at(grid_offset), x, y, 0);
+    }
+}
+
+static void shift_footprint_cache(int dx, int dy)
+{
+    int width = footprint_cache.width - abs(dx);
+    int src_x = dx > 0 ? dx : 0;
+    int dst_x = dx < 0 ? -dx : 0;
+    int rows = footprint_cache.height - abs(dy);
+    for (int i = 0; i < rows; i++) {
+        // copy in the direction that does not overwrite rows that still have to be moved
+        int y = dy >= 0 ? i : rows - 1 - i;
+        color_t *dst = &footprint_cache.pixels[(dy >= 0 ? y : y - dy) * footprint_cache.width];
+        const color_t *src = &footprint_cache.pixels[(dy >= 0 ? y + dy : y) * footprint_cache.width];
+        memmove(&dst[dst_x], &src[src_x], width * sizeof(color_t));
+    }
+}
+
+static void draw_exposed_footprints(int x, int y, int width, int height)
+{
+    graphics_set_clip_rectangle(x, y, width, height);
+    city_view_foreach_map_tile(draw_footprint_uncached);
+}
+
+static void begin_footprint_cache(void)
+{
+    int x, y, width, height, camera_x, camera_y, camera_tile_x, camera_tile_y;
+    city_view_get_scaled_viewport(&x, &y, &width, &height);
+    city_view_get_camera_in_pixels(&camera_x, &camera_y);
+    city_view_get_camera(&camera_tile_x, &camera_tile_y);
+
+    draw_context.use_footprint_cache = 1;
+    draw_context.draw_all_footprints = 0;
+    footprint_cache.has_changes = 0;
+
+    int dx = camera_x - footprint_cache.camera_x;
+    int dy = camera_y - footprint_cache.camera_y;
+    footprint_cache.camera_x = camera_x;
+    footprint_cache.camera_y = camera_y;
+
+    // Odd rows are shifted by half a tile, so moving the camera by an odd number of rows changes the layout
+    if (!footprint_cache.is_valid || footprint_cache.x != x || footprint_cache.y != y ||
+        footprint_cache.width != width || footprint_cache.height != height ||
+        footprint_cache.camera_odd_row != (camera_tile_y & 1) ||
+        footprint_cache.orientation != city_view_orientation() ||
+        footprint_cache.scale != city_view_get_scale()) {
+        if (!footprint_cache.pixels || footprint_cache.width * footprint_cache.height != width * height) {
+            free(footprint_cache.pixels);
+            footprint_cache.pixels = (color_t *) malloc((size_t) width * height * sizeof(color_t));
+        }
+        footprint_cache.is_valid = footprint_cache.pixels != 0;
+        footprint_cache.x = x;
+        footprint_cache.y = y;
+        footprint_cache.width = width;
+        footprint_cache.height = height;
+        footprint_cache.camera_odd_row = camera_tile_y & 1;
+        footprint_cache.orientation = city_view_orientation();
+        footprint_cache.scale = city_view_get_scale();
+        draw_context.use_footprint_cache = footprint_cache.is_valid;
+        draw_context.draw_all_footprints = 1;
+        return;
+    }
+    if (abs(dx) >= width || abs(dy) >= height) {
+        draw_context.draw_all_footprints = 1;
+        return;
+    }
+    if (dx || dy) {
+        shift_footprint_cache(dx, dy);
+        footprint_cache.has_changes = 1;
+    }
+    graphics_draw_from_buffer(x, y, width, height, footprint_cache.pixels);
+    if (dx) {
+        draw_exposed_footprints(dx > 0 ? x + width - dx : x, y, abs(dx), height);
+    }
+    if (dy) {
+        draw_exposed_footprints(x, dy > 0 ? y + height - dy : y, width, abs(dy));
     }
+    graphics_set_clip_rectangle(x, y, width, height);
+}
+
+static void end_footprint_cache(void)
+{
+    if (draw_context.use_footprint_cache && footprint_cache.has_changes) {
+        graphics_save_to_buffer(footprint_cache.x, footprint_cache.y,
+            footprint_cache.width, footprint_cache.height, footprint_cache.pixels);
+    }
+    draw_context.use_footprint_cache = 0;
 }
 
 static void draw_hippodrome_spectators(const building *b, int x, int y, color_t color_mask)
@@ -383,7 +555,8 @@ static void draw_animation(int x, int y, int grid_offset)
             } else if (b->type == BUILDING_BURNING_RUIN && b->ruin_has_plague) {
                 image_draw_masked(image_group(GROUP_PLAGUE_SKULL), x + 18, y - 32, color_mask);
             }
-            int animation_offset = building_animation_offset(b, image_id, grid_offset);
+            int animation_offset = draw_context.use_stored_animation_offsets ?
+                draw_context.animation_offsets[grid_offset] : building_animation_offset(b, image_id, grid_offset);
             if (b->type != BUILDING_HIPPODROME && animation_offset > 0) {
                 if (animation_offset > img->num_animation_sprites) {
                     animation_offset = img->num_animation_sprites;
@@ -505,6 +678,80 @@ static void deletion_draw_remaining(int x, int y, int grid_offset)
     draw_hippodrome_ornaments(x, y, grid_offset);
 }
 
+// Advancing an animation changes the map, so it is done once for all tiles before drawing in bands
+static void store_animation_offset(int x, int y, int grid_offset)
+{
+    int image_id = map_image_at(grid_offset);
+    if (image_get(image_id)->num_animation_sprites && map_property_is_draw_tile(grid_offset)) {
+        building *b = building_get(map_building_at(grid_offset));
+        draw_context.animation_offsets[grid_offset] = building_animation_offset(b, image_id, grid_offset);
+    }
+}
+
+// Sprites are drawn upwards from their tile, so tiles well below a band can still reach into it
+static int band_margin_below(void)
+{
+    return BAND_MARGIN_ABOVE + image_max_city_sprite_extent();
+}
+
+static int init_render_bands(void)
+{
+    int num_bands = config_get(CONFIG_UI_CITY_RENDER_THREADS);
+    if (num_bands <= 1) {
+        return 0;
+    }
+    int num_workers = system_parallel_worker_count();
+    if (num_bands > num_workers) {
+        num_bands = num_workers;
+    }
+    city_view_get_scaled_viewport(&render_bands.x, &render_bands.y, &render_bands.width, &render_bands.height);
+    render_bands.num_bands = num_bands;
+    render_bands.margin_below = band_margin_below();
+    return 1;
+}
+
+static void draw_band(void *userdata, int index, int worker)
+{
+    const band_pass *pass = userdata;
+    graphics_set_state(&pass->graphics);
+    int y_start = render_bands.y + render_bands.height * index / render_bands.num_bands;
+    int y_end = render_bands.y + render_bands.height * (index + 1) / render_bands.num_bands;
+    graphics_set_clip_rectangle(render_bands.x, y_start, render_bands.width, y_end - y_start);
+    city_view_foreach_valid_map_tile_in_rows(y_start - BAND_MARGIN_ABOVE, y_end + render_bands.margin_below,
+        pass->callback1, pass->callback2, pass->callback3);
+}
+
+static void draw_in_bands(map_callback *callback1, map_callback *callback2, map_callback *callback3)
+{
+    band_pass pass = { callback1, callback2, callback3 };
+    graphics_get_state(&pass.graphics);
+    image_begin_parallel_use();
+    system_run_parallel(draw_band, &pass, render_bands.num_bands);
+    image_end_parallel_use();
+    graphics_set_clip_rectangle(render_bands.x, render_bands.y, render_bands.width, render_bands.height);
+}
+
+static void draw_tops_figures_animations(void)
+{
+    if (draw_context.selected_figure_id || !init_render_bands()) {
+        city_view_foreach_valid_map_tile(draw_top, draw_figures, draw_animation);
+        return;
+    }
+    city_view_foreach_valid_map_tile(0, 0, store_animation_offset);
+    draw_context.use_stored_animation_offsets = 1;
+    draw_in_bands(draw_top, draw_figures, draw_animation);
+    draw_context.use_stored_animation_offsets = 0;
+}
+
+static void draw_elevated_figures_ornaments(void)
+{
+    if (draw_context.selected_figure_id || !render_bands.num_bands) {
+        city_view_foreach_valid_map_tile(draw_elevated_figures, draw_hippodrome_ornaments, 0);
+        return;
+    }
+    draw_in_bands(draw_elevated_figures, draw_hippodrome_ornaments, 0);
+}
+
 void city_without_overlay_draw(int selected_figure_id, pixel_coordinate *figure_coord, const map_tile *tile)
 {
     int highlighted_formation = 0;
@@ -516,24 +763,60 @@ void city_without_overlay_draw(int selected_figure_id, pixel_coordinate *figure_
     }
     init_draw_context(selected_figure_id, figure_coord, highlighted_formation);
     int should_mark_deleting = city_building_ghost_mark_deleting(tile);
-    city_view_foreach_map_tile(draw_footprint);
+    if (selected_figure_id) {
+        // The figure view draws a different part of the city, so it does not touch the cache
+        city_view_foreach_map_tile(draw_footprint);
+    } else {
+        begin_footprint_cache();
+        city_view_foreach_map_tile(draw_footprint);
+        end_footprint_cache();
+    }
     if (!should_mark_deleting) {
-        city_view_foreach_valid_map_tile(
-            draw_top,
-            draw_figures,
-            draw_animation
-        );
+        render_bands.num_bands = 0;
+        draw_tops_figures_animations();
         if (!selected_figure_id) {
             city_building_ghost_draw(tile);
         }
-        city_view_foreach_valid_map_tile(
-            draw_elevated_figures,
-            draw_hippodrome_ornaments,
-            0
-        );
+        draw_elevated_figures_ornaments();
     } else {
         city_view_foreach_map_tile(deletion_draw_terrain_top);
         city_view_foreach_map_tile(deletion_draw_figures_animations);
         city_view_foreach_map_tile(deletion_draw_remaining);
     }
 }
+
+void city_without_overlay_begin_offscreen_draw(void)
+{
+    draw_context.advance_water_animation = 0;
+    draw_context.selected_figure_id = 0;
+    draw_context.selected_figure_coord = 0;
+    draw_context.highlighted_formation = 0;
+    city_view_foreach_valid_map_tile(0, 0, store_animation_offset);
+    draw_context.use_stored_animation_offsets = 1;
+    graphics_get_state(&offscreen_graphics);
+    image_begin_parallel_use();
+}
+
+void city_without_overlay_draw_offscreen_rows(int y_start, int y_end)
+{
+    int x, y, width, height;
+    city_view_get_scaled_viewport(&x, &y, &width, &height);
+    graphics_set_state(&offscreen_graphics);
+    graphics_set_clip_rectangle(x, y_start, width, y_end - y_start);
+    int y_min = y_start - BAND_MARGIN_ABOVE;
+    int y_max = y_end + band_margin_below();
+    city_view_foreach_map_tile_in_rows(y_min, y_max, draw_footprint_uncached);
+    city_view_foreach_valid_map_tile_in_rows(y_min, y_max, draw_top, draw_figures, draw_animation);
+    city_view_foreach_valid_map_tile_in_rows(y_min, y_max, draw_elevated_figures, draw_hippodrome_ornaments, 0);
+}
+
+void city_without_overlay_end_offscreen_draw(void)
+{
+    draw_context.use_stored_animation_offsets = 0;
+    image_end_parallel_use();
+}
+
+void city_without_overlay_invalidate_cache(void)
+{
+    footprint_cache.is_valid = 0;
+}
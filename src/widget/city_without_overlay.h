@@ -6,4 +6,25 @@
 
 void city_without_overlay_draw(int selected_figure_id, pixel_coordinate *figure_coord, const map_tile *tile);
 
+void city_without_overlay_invalidate_cache(void);
+
+/**
+ * Prepares drawing the current city view into an off-screen canvas, without the building ghost,
+ * the selected figure or any of the side effects of drawing the city on screen
+ */
+void city_without_overlay_begin_offscreen_draw(void);
+
+/**
+ * Draws the rows of the off-screen city view between y_start and y_end into the active canvas.
+ * Different rows can be drawn on different threads at the same time.
+ * @param y_start First row to draw
+ * @param y_end Row after the last row to draw
+ */
+void city_without_overlay_draw_offscreen_rows(int y_start, int y_end);
+
+/**
+ * Finishes drawing the city off-screen
+ */
+void city_without_overlay_end_offscreen_draw(void);
+
 #endif // WIDGET_CITY_WITHOUT_OVERLAY_H
@@ -12,9 +12,18 @@
 #include "map/property.h"
 #include "map/random.h"
 #include "map/terrain.h"
+#include "map/tile_changes.h"
 #include "scenario/property.h"
 
 #include <stdlib.h>
+#include <string.h>
+
+// The minimap of the whole map is kept in view coordinates, two pixels per tile, with a border
+// for the parts of buildings that stick out. Only the tiles that changed are drawn again,
+// and drawing the minimap copies the visible part of it.
+#define MAP_IMAGE_BORDER 8
+#define MAP_IMAGE_WIDTH (2 * VIEW_X_MAX + 2 * MAP_IMAGE_BORDER)
+#define MAP_IMAGE_HEIGHT (VIEW_Y_MAX + 2 * MAP_IMAGE_BORDER)
 
 enum {
     FIGURE_COLOR_NONE = 0,
@@ -39,7 +48,6 @@ static struct {
     int width;
     int height;
     color_t enemy_color;
-    color_t *cache;
     struct {
         int x;
         int y;
@@ -48,8 +56,17 @@ static struct {
     int refresh_requested;
 } data;
 
+static struct {
+    color_t *terrain;
+    color_t *pixels;
+    int positions[GRID_SIZE * GRID_SIZE]; // pixel index of every tile, -1 when the tile is not in view
+    int is_valid;
+    int has_changes;
+} map_image;
+
 void widget_minimap_invalidate(void)
 {
+    map_image.is_valid = 0;
     data.refresh_requested = 1;
 }
 
@@ -114,8 +131,11 @@ static int has_figure_color(figure *f)
     return FIGURE_COLOR_NONE;
 }
 
-static int draw_figure(int x_view, int y_view, int grid_offset)
+static color_t figure_color(int grid_offset)
 {
+    if (!map_has_figure_at(grid_offset)) {
+        return 0;
+    }
     int color_type = map_figure_foreach_until(grid_offset, has_figure_color);
     if (color_type == FIGURE_COLOR_NONE) {
         return 0;
@@ -126,21 +146,16 @@ static int draw_figure(int x_view, int y_view, int grid_offset)
     } else if (color_type == FIGURE_COLOR_ENEMY) {
         color = data.enemy_color;
     }
-    graphics_draw_horizontal_line(x_view, x_view +1, y_view, color);
-    return 1;
+    return color;
 }
 
-static void draw_minimap_tile(int x_view, int y_view, int grid_offset)
+static void draw_terrain_tile(int x_view, int y_view, int grid_offset)
 {
     if (grid_offset < 0) {
         image_draw(image_group(GROUP_MINIMAP_BLACK), x_view, y_view);
         return;
     }
 
-    if (draw_figure(x_view, y_view, grid_offset)) {
-        return;
-    }
-
     int terrain = map_terrain_get(grid_offset);
     // exception for fort ground: display as empty land
     if (terrain & TERRAIN_BUILDING) {
@@ -219,68 +234,166 @@ static void draw_viewport_rectangle(void)
         COLOR_MINIMAP_VIEWPORT);
 }
 
-static void prepare_minimap_cache(int width, int height)
+// Figures are drawn on top of the terrain, so the tile is the same as the terrain when the figures leave
+static void compose_tile(int grid_offset)
 {
-    if (width != data.width || height != data.height) {
-        free(data.cache);
-        data.cache = (color_t *)malloc(sizeof(color_t) * width * height);
+    int position = map_image.positions[grid_offset];
+    if (position < 0) {
+        return;
+    }
+    color_t color = figure_color(grid_offset);
+    color_t left = color ? color : map_image.terrain[position];
+    color_t right = color ? color : map_image.terrain[position + 1];
+    if (map_image.pixels[position] != left || map_image.pixels[position + 1] != right) {
+        map_image.pixels[position] = left;
+        map_image.pixels[position + 1] = right;
+        map_image.has_changes = 1;
     }
 }
 
-static void cache_minimap(void)
+static void draw_terrain_at(int grid_offset)
 {
-    graphics_save_to_buffer(data.x_offset, data.y_offset, data.width, data.height, data.cache);
+    int position = map_image.positions[grid_offset];
+    if (position >= 0) {
+        draw_terrain_tile(position % MAP_IMAGE_WIDTH, position / MAP_IMAGE_WIDTH, grid_offset);
+    }
 }
 
-static void draw_minimap(void)
+static void update_tile(int grid_offset)
 {
-    graphics_set_clip_rectangle(data.x_offset, data.y_offset, data.width, data.height);
-    foreach_map_tile(draw_minimap_tile);
-    cache_minimap();
-    draw_viewport_rectangle();
-    graphics_reset_clip_rectangle();
+    if (map_image.positions[grid_offset] < 0) {
+        return;
+    }
+    building *b = building_get(map_building_at(grid_offset));
+    if (b->id && b->size > 1) {
+        // The building is drawn from one of its tiles and covers the others
+        for (int y = 0; y < b->size; y++) {
+            for (int x = 0; x < b->size; x++) {
+                draw_terrain_at(map_grid_offset(b->x + x, b->y + y));
+            }
+        }
+        for (int y = 0; y < b->size; y++) {
+            for (int x = 0; x < b->size; x++) {
+                compose_tile(map_grid_offset(b->x + x, b->y + y));
+            }
+        }
+    } else {
+        draw_terrain_at(grid_offset);
+        compose_tile(grid_offset);
+    }
+}
+
+static void ignore_tile(int grid_offset)
+{
+}
+
+static int allocate_map_image(void)
+{
+    if (!map_image.terrain) {
+        map_image.terrain = (color_t *) malloc(sizeof(color_t) * MAP_IMAGE_WIDTH * MAP_IMAGE_HEIGHT);
+        map_image.pixels = (color_t *) malloc(sizeof(color_t) * MAP_IMAGE_WIDTH * MAP_IMAGE_HEIGHT);
+        if (!map_image.terrain || !map_image.pixels) {
+            free(map_image.terrain);
+            free(map_image.pixels);
+            map_image.terrain = 0;
+            map_image.pixels = 0;
+            return 0;
+        }
+    }
+    return 1;
 }
 
-static void draw_uncached(int x_offset, int y_offset, int width_tiles, int height_tiles)
+static void draw_map_image(void)
 {
     data.enemy_color = ENEMY_COLOR_BY_CLIMATE[scenario_property_climate()];
-    prepare_minimap_cache(2 * width_tiles, height_tiles);
-    set_bounds(x_offset, y_offset, width_tiles, height_tiles);
-    draw_minimap();
+    for (int i = 0; i < MAP_IMAGE_WIDTH * MAP_IMAGE_HEIGHT; i++) {
+        map_image.terrain[i] = COLOR_BLACK;
+    }
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        map_image.positions[i] = -1;
+    }
+    graphics_set_custom_canvas(map_image.terrain, MAP_IMAGE_WIDTH, MAP_IMAGE_HEIGHT);
+    for (int y_view = 0; y_view < VIEW_Y_MAX; y_view++) {
+        int y = y_view + MAP_IMAGE_BORDER;
+        for (int x_view = 0; x_view < VIEW_X_MAX; x_view++) {
+            int x = 2 * x_view - (y_view & 1) + MAP_IMAGE_BORDER;
+            int grid_offset = city_view_to_grid_offset(x_view, y_view);
+            if (grid_offset >= 0) {
+                map_image.positions[grid_offset] = y * MAP_IMAGE_WIDTH + x;
+            }
+            draw_terrain_tile(x, y, grid_offset);
+        }
+    }
+    graphics_set_active_canvas(CANVAS_UI);
+    memcpy(map_image.pixels, map_image.terrain, sizeof(color_t) * MAP_IMAGE_WIDTH * MAP_IMAGE_HEIGHT);
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        compose_tile(i);
+    }
+    map_image.is_valid = 1;
+}
+
+static int update_map_image(void)
+{
+    if (!allocate_map_image()) {
+        return 0;
+    }
+    if (!map_image.is_valid) {
+        map_tile_changes_consume(ignore_tile);
+        draw_map_image();
+        return 1;
+    }
+    map_image.has_changes = 0;
+    graphics_set_custom_canvas(map_image.terrain, MAP_IMAGE_WIDTH, MAP_IMAGE_HEIGHT);
+    int per_tile = map_tile_changes_consume(update_tile);
+    graphics_set_active_canvas(CANVAS_UI);
+    if (!per_tile) {
+        draw_map_image();
+        return 1;
+    }
+    return map_image.has_changes;
 }
 
-void draw_using_cache(int x_offset, int y_offset, int width_tiles, int height_tiles, int is_scrolling)
+static void draw_map_image_row(int x_offset, int y_offset, int x_image, int y_image, int width)
 {
-    if (width_tiles * 2 != data.width || height_tiles != data.height || x_offset != data.x_offset) {
-        draw_uncached(x_offset, y_offset, width_tiles, height_tiles);
+    graphics_draw_horizontal_line(x_offset, x_offset + width - 1, y_offset, COLOR_BLACK);
+    if (y_image < 0 || y_image >= MAP_IMAGE_HEIGHT) {
         return;
     }
+    if (x_image < 0) {
+        x_offset -= x_image;
+        width += x_image;
+        x_image = 0;
+    }
+    if (x_image + width > MAP_IMAGE_WIDTH) {
+        width = MAP_IMAGE_WIDTH - x_image;
+    }
+    if (width > 0) {
+        graphics_draw_from_buffer(x_offset, y_offset, width, 1,
+            &map_image.pixels[y_image * MAP_IMAGE_WIDTH + x_image]);
+    }
+}
 
-    if (is_scrolling) {
-        int old_absolute_x = data.absolute_x;
-        int old_absolute_y = data.absolute_y;
-        set_bounds(x_offset, y_offset, width_tiles, height_tiles);
-        if (data.absolute_x != old_absolute_x || data.absolute_y != old_absolute_y) {
-            draw_minimap();
-            return;
+static void draw_minimap(void)
+{
+    graphics_set_clip_rectangle(data.x_offset, data.y_offset, data.width, data.height);
+    if (map_image.is_valid) {
+        int x_image = 2 * data.absolute_x + MAP_IMAGE_BORDER;
+        int y_image = data.absolute_y + MAP_IMAGE_BORDER;
+        for (int y = 0; y < data.height; y++) {
+            draw_map_image_row(data.x_offset, data.y_offset + y, x_image, y_image + y, data.width);
         }
     }
-
-    graphics_set_clip_rectangle(x_offset, y_offset, 2 * width_tiles, height_tiles);
-    graphics_draw_from_buffer(x_offset, y_offset, data.width, data.height, data.cache);
     draw_viewport_rectangle();
     graphics_reset_clip_rectangle();
 }
 
 void widget_minimap_draw(int x_offset, int y_offset, int width_tiles, int height_tiles, int force)
 {
-    if (data.refresh_requested || scroll_in_progress() || force) {
-        if (data.refresh_requested) {
-            draw_uncached(x_offset, y_offset, width_tiles, height_tiles);
-            data.refresh_requested = 0;
-        } else {
-            draw_using_cache(x_offset, y_offset, width_tiles, height_tiles, scroll_in_progress());
-        }
+    int has_changes = update_map_image();
+    if (has_changes || data.refresh_requested || scroll_in_progress() || force) {
+        set_bounds(x_offset, y_offset, width_tiles, height_tiles);
+        draw_minimap();
+        data.refresh_requested = 0;
         graphics_draw_horizontal_line(x_offset - 1, x_offset - 1 + width_tiles * 2, y_offset - 1, COLOR_MINIMAP_DARK);
         graphics_draw_vertical_line(x_offset - 1, y_offset, y_offset + height_tiles, COLOR_MINIMAP_DARK);
         graphics_draw_vertical_line(x_offset - 1 + width_tiles * 2, y_offset, y_offset + height_tiles, COLOR_MINIMAP_LIGHT);
@@ -318,7 +431,7 @@ int widget_minimap_handle_mouse(const mouse *m)
         int grid_offset = get_mouse_grid_offset(m);
         if (grid_offset > 0) {
             city_view_go_to_grid_offset(grid_offset);
-            widget_minimap_invalidate();
+            data.refresh_requested = 1;
             return 1;
         }
     }
@@ -0,0 +1,140 @@
+#include "profiler.h"
+
+#include "city/view.h"
+#include "core/image.h"
+#include "game/profiler.h"
+#include "graphics/graphics.h"
+#include "graphics/text.h"
+#include "translation/translation.h"
+
+#define GRAPH_SAMPLES 128
+#define GRAPH_BAR_WIDTH 2
+#define GRAPH_WIDTH (GRAPH_SAMPLES * GRAPH_BAR_WIDTH)
+#define GRAPH_HEIGHT 64
+#define MICROS_PER_PIXEL 250
+#define PANEL_WIDTH (GRAPH_WIDTH + 16)
+#define PANEL_HEIGHT (2 * GRAPH_HEIGHT + 92)
+
+#define COLOR_PROFILER_BACKGROUND 0xff202020
+#define COLOR_PROFILER_GRID 0xff505050
+#define COLOR_PROFILER_SLOT 0xffffa500
+#define COLOR_PROFILER_FIGURES 0xff3399ff
+#define COLOR_PROFILER_DAY COLOR_RED
+#define COLOR_PROFILER_DRAW 0xff33cc33
+#define COLOR_PROFILER_IMAGES 0xffcccccc
+
+static int bar_height(time_micros micros)
+{
+    int height = (int) ((micros + MICROS_PER_PIXEL - 1) / MICROS_PER_PIXEL);
+    return height > GRAPH_HEIGHT ? GRAPH_HEIGHT : height;
+}
+
+static int draw_bar_segment(int x, int y_bottom, int stacked, time_micros micros, color_t color)
+{
+    int height = bar_height(micros);
+    if (stacked + height > GRAPH_HEIGHT) {
+        height = GRAPH_HEIGHT - stacked;
+    }
+    if (height > 0) {
+        graphics_fill_rect(x, y_bottom - stacked - height, GRAPH_BAR_WIDTH, height, color);
+    }
+    return stacked + height;
+}
+
+static void draw_graph_background(int x, int y)
+{
+    graphics_draw_rect(x - 1, y - 1, GRAPH_WIDTH + 2, GRAPH_HEIGHT + 2, COLOR_PROFILER_GRID);
+    // one line per 4 ms
+    for (int line_y = y + GRAPH_HEIGHT - 16; line_y > y; line_y -= 16) {
+        graphics_draw_horizontal_line(x, x + GRAPH_WIDTH - 1, line_y, COLOR_PROFILER_GRID);
+    }
+}
+
+static void draw_tick_graph(int x, int y)
+{
+    draw_graph_background(x, y);
+    int y_bottom = y + GRAPH_HEIGHT;
+    for (int age = 0; age < GRAPH_SAMPLES; age++) {
+        const profiler_tick_sample *sample = profiler_get_tick_sample(age);
+        if (!sample) {
+            break;
+        }
+        int bar_x = x + GRAPH_WIDTH - (age + 1) * GRAPH_BAR_WIDTH;
+        int stacked = draw_bar_segment(bar_x, y_bottom, 0, sample->figures_micros, COLOR_PROFILER_FIGURES);
+        stacked = draw_bar_segment(bar_x, y_bottom, stacked, sample->slot_micros, COLOR_PROFILER_SLOT);
+        draw_bar_segment(bar_x, y_bottom, stacked, sample->day_micros, COLOR_PROFILER_DAY);
+    }
+}
+
+static void draw_render_graph(int x, int y)
+{
+    draw_graph_background(x, y);
+    int y_bottom = y + GRAPH_HEIGHT;
+    for (int age = 0; age < GRAPH_SAMPLES; age++) {
+        time_micros micros = profiler_get_draw_sample(age);
+        if (!micros) {
+            break;
+        }
+        int bar_x = x + GRAPH_WIDTH - (age + 1) * GRAPH_BAR_WIDTH;
+        draw_bar_segment(bar_x, y_bottom, 0, micros, COLOR_PROFILER_DRAW);
+    }
+}
+
+static int get_slowest_slot(void)
+{
+    int slowest = 0;
+    time_micros max_micros = 0;
+    for (int i = 0; i < PROFILER_TICK_SLOTS; i++) {
+        const profiler_stats *stats = profiler_get_stats(i);
+        if (stats->max_micros > max_micros) {
+            max_micros = stats->max_micros;
+            slowest = i;
+        }
+    }
+    return slowest;
+}
+
+int widget_profiler_draw(void)
+{
+    if (!profiler_is_enabled()) {
+        return 0;
+    }
+    int x, y, width, height;
+    city_view_get_unscaled_viewport(&x, &y, &width, &height);
+    x += 8;
+    y += 8;
+    graphics_fill_rect(x, y, PANEL_WIDTH, PANEL_HEIGHT, COLOR_PROFILER_BACKGROUND);
+    x += 8;
+
+    const profiler_tick_sample *last_tick = profiler_get_tick_sample(0);
+    time_micros last_tick_micros = last_tick ?
+        last_tick->slot_micros + last_tick->figures_micros + last_tick->day_micros : 0;
+    int text_width = text_draw(translation_for(TR_PROFILER_TICK), x, y + 6, FONT_SMALL_PLAIN, COLOR_PROFILER_FIGURES);
+    text_draw_number_colored((int) last_tick_micros, '@', "",
+        x + text_width, y + 6, FONT_SMALL_PLAIN, COLOR_PROFILER_FIGURES);
+    draw_tick_graph(x, y + 20);
+
+    int slowest_slot = get_slowest_slot();
+    text_width = text_draw(translation_for(TR_PROFILER_SLOWEST_SLOT),
+        x, y + GRAPH_HEIGHT + 26, FONT_SMALL_PLAIN, COLOR_PROFILER_SLOT);
+    text_width += text_draw_number_colored(slowest_slot, '@', ": ",
+        x + text_width, y + GRAPH_HEIGHT + 26, FONT_SMALL_PLAIN, COLOR_PROFILER_SLOT);
+    text_draw_number_colored((int) profiler_get_stats(slowest_slot)->max_micros, '@', " us",
+        x + text_width, y + GRAPH_HEIGHT + 26, FONT_SMALL_PLAIN, COLOR_PROFILER_SLOT);
+
+    text_width = text_draw(translation_for(TR_PROFILER_CITY_DRAW),
+        x, y + GRAPH_HEIGHT + 42, FONT_SMALL_PLAIN, COLOR_PROFILER_DRAW);
+    text_draw_number_colored((int) profiler_get_draw_sample(0), '@', "",
+        x + text_width, y + GRAPH_HEIGHT + 42, FONT_SMALL_PLAIN, COLOR_PROFILER_DRAW);
+    draw_render_graph(x, y + GRAPH_HEIGHT + 56);
+
+    int hits, misses;
+    image_get_external_cache_stats(&hits, &misses);
+    text_width = text_draw(translation_for(TR_PROFILER_EXTERNAL_IMAGES),
+        x, y + 2 * GRAPH_HEIGHT + 66, FONT_SMALL_PLAIN, COLOR_PROFILER_IMAGES);
+    text_width += text_draw_number_colored(hits, '@', " / ",
+        x + text_width, y + 2 * GRAPH_HEIGHT + 66, FONT_SMALL_PLAIN, COLOR_PROFILER_IMAGES);
+    text_draw_number_colored(misses, '@', "",
+        x + text_width, y + 2 * GRAPH_HEIGHT + 66, FONT_SMALL_PLAIN, COLOR_PROFILER_IMAGES);
+    return 1;
+}
@@ -0,0 +1,10 @@
+#ifndef WIDGET_PROFILER_H
+#define WIDGET_PROFILER_H
+
+/**
+ * Draws the tick and render time graphs on top of the city view when profiling is enabled
+ * @return True if something was drawn
+ */
+int widget_profiler_draw(void);
+
+#endif // WIDGET_PROFILER_H
@@ -12,6 +12,7 @@
 #include "game/settings.h"
 #include "game/state.h"
 #include "game/time.h"
+#include "game/undo.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
 #include "graphics/lang_text.h"
@@ -21,8 +22,10 @@
 #include "map/bookmark.h"
 #include "map/grid.h"
 #include "scenario/criteria.h"
+#include "translation/translation.h"
 #include "widget/city.h"
 #include "widget/city_with_overlay.h"
+#include "widget/profiler.h"
 #include "widget/top_menu.h"
 #include "widget/sidebar/city.h"
 #include "window/advisors.h"
@@ -86,6 +89,11 @@ static void draw_paused_and_time_left(void)
         outer_panel_draw(x_offset, 40, 28, 3);
         lang_text_draw_centered(13, 2, x_offset, 58, 448, FONT_NORMAL_BLACK);
         city_view_dirty = 1;
+    } else if (game_state_is_turbo()) {
+        int x_offset = center_in_city(448);
+        outer_panel_draw(x_offset, 40, 28, 3);
+        text_draw_centered(translation_for(TR_FAST_FORWARD), x_offset, 58, 448, FONT_NORMAL_BLACK, 0);
+        city_view_dirty = 1;
     }
 }
 
@@ -113,6 +121,7 @@ static void draw_foreground(void)
         draw_cancel_construction();
     }
     city_view_dirty |= widget_city_draw_construction_cost_and_size();
+    city_view_dirty |= widget_profiler_draw();
     if (window_is(WINDOW_CITY)) {
         city_message_process_queue();
     }
@@ -124,6 +133,7 @@ static void draw_foreground_military(void)
     window_city_draw();
     widget_sidebar_city_draw_foreground_military();
     draw_paused_and_time_left();
+    widget_profiler_draw();
 }
 
 static void exit_military_command(void)
@@ -183,6 +193,15 @@ static void handle_hotkeys(const hotkeys *h)
     if (h->toggle_pause) {
         toggle_pause();
     }
+    if (h->toggle_turbo) {
+        game_state_toggle_turbo();
+    }
+    if (h->undo) {
+        game_undo_perform();
+    }
+    if (h->redo) {
+        game_redo_perform();
+    }
     if (h->decrease_game_speed) {
         setting_decrease_game_speed();
     }
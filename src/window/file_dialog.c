@@ -10,6 +10,7 @@
 #include "core/time.h"
 #include "game/file.h"
 #include "game/file_editor.h"
+#include "game/save_index.h"
 #include "graphics/generic_button.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
@@ -31,6 +32,10 @@
 
 static const time_millis NOT_EXIST_MESSAGE_TIMEOUT = 500;
 
+static const color_t THUMBNAIL_COLORS[SAVED_GAME_THUMBNAIL_MAX] = {
+    COLOR_BLACK, 0xff8c9c52, 0xff3a6b9c, 0xff3d6329, 0xff8a8578, 0xffb5a07b, 0xffa55a3c, 0xff5a5a5a
+};
+
 static void button_ok_cancel(int is_ok, int param2);
 static void button_select_file(int index, int param2);
 static void on_scroll(void);
@@ -112,11 +117,64 @@ static void init(file_type type, file_dialog_type dialog_type)
             data.file_list = dir_find_files_with_extension(saved_game_data_expanded.extension);
         }
     }
+    if (type == FILE_TYPE_SAVED_GAME) {
+        game_save_index_set_files(data.file_list);
+    }
     scrollbar_init(&scrollbar, 0, data.file_list->num_files - NUM_FILES_IN_VIEW);
     strncpy(data.selected_file, data.file_data->last_loaded_file, FILE_NAME_MAX);
     input_box_start(&file_name_input, data.typed_name, FILE_NAME_MAX, 0);
 }
 
+static void draw_thumbnail(const uint8_t *thumbnail, int x, int y)
+{
+    for (int row = 0; row < SAVED_GAME_THUMBNAIL_SIZE; row++) {
+        const uint8_t *pixels = &thumbnail[row * SAVED_GAME_THUMBNAIL_SIZE];
+        int start = 0;
+        for (int column = 1; column <= SAVED_GAME_THUMBNAIL_SIZE; column++) {
+            if (column == SAVED_GAME_THUMBNAIL_SIZE || pixels[column] != pixels[start]) {
+                color_t color = THUMBNAIL_COLORS[pixels[start] < SAVED_GAME_THUMBNAIL_MAX ? pixels[start] : 0];
+                graphics_fill_rect(x + start, y + row, column - start, 1, color);
+                start = column;
+            }
+        }
+    }
+}
+
+static const char *get_previewed_filename(void)
+{
+    int index = scrollbar.scroll_position + data.focus_button_id - 1;
+    if (data.focus_button_id && index < data.file_list->num_files) {
+        return data.file_list->files[index];
+    }
+    return data.selected_file;
+}
+
+static void draw_preview(void)
+{
+    const saved_game_info *info = 0;
+    save_index_status status = game_save_index_get(get_previewed_filename(), &info);
+    if (status == SAVE_INDEX_NO_INFO) {
+        return;
+    }
+    outer_panel_draw(128, 380, 24, 6);
+    graphics_draw_rect(143, 395, SAVED_GAME_THUMBNAIL_SIZE + 2, SAVED_GAME_THUMBNAIL_SIZE + 2, COLOR_BLACK);
+    if (status == SAVE_INDEX_PENDING) {
+        text_draw(string_from_ascii("..."), 224, 398, FONT_NORMAL_BLACK, 0);
+        return;
+    }
+    draw_thumbnail(info->thumbnail, 144, 396);
+
+    uint8_t name[SAVED_GAME_INFO_NAME_LENGTH];
+    string_copy(info->scenario_name, name, SAVED_GAME_INFO_NAME_LENGTH);
+    text_ellipsize(name, FONT_NORMAL_BLACK, 272);
+    text_draw(name, 224, 398, FONT_NORMAL_BLACK, 0);
+    lang_text_draw_month_year_max_width(info->month, info->year, 224, 418, 272, FONT_NORMAL_BLACK, 0);
+    int width = lang_text_draw(6, 0, 224, 438, FONT_NORMAL_BLACK);
+    text_draw_number(info->treasury, '@', " ", 220 + width, 438, FONT_NORMAL_BLACK);
+    width = lang_text_draw(6, 1, 224, 456, FONT_NORMAL_BLACK);
+    text_draw_number(info->population, '@', " ", 220 + width, 456, FONT_NORMAL_BLACK);
+}
+
 static void draw_foreground(void)
 {
     graphics_in_dialog();
@@ -151,6 +209,11 @@ static void draw_foreground(void)
     image_buttons_draw(0, 0, image_buttons, 2);
     scrollbar_draw(&scrollbar);
 
+    if (data.type == FILE_TYPE_SAVED_GAME) {
+        game_save_index_update();
+        draw_preview();
+    }
+
     graphics_reset_dialog();
 }
 
@@ -244,6 +307,7 @@ static void button_ok_cancel(int is_ok, int param2)
         if (game_file_delete_saved_game(filename)) {
             dir_find_files_with_extension(data.file_data->extension);
             dir_append_files_with_extension(saved_game_data_expanded.extension);
+            game_save_index_set_files(data.file_list);
 
             if (scrollbar.scroll_position + NUM_FILES_IN_VIEW >= data.file_list->num_files) {
                 --scrollbar.scroll_position;
@@ -46,12 +46,17 @@ static hotkey_widget hotkey_widgets[] = {
     {HOTKEY_RESIZE_TO_1024, TR_HOTKEY_RESIZE_TO_1024},
     {HOTKEY_SAVE_SCREENSHOT, TR_HOTKEY_SAVE_SCREENSHOT},
     {HOTKEY_SAVE_CITY_SCREENSHOT, TR_HOTKEY_SAVE_CITY_SCREENSHOT},
+    {HOTKEY_TOGGLE_PROFILER, TR_HOTKEY_TOGGLE_PROFILER},
+    {HOTKEY_DUMP_PROFILER, TR_HOTKEY_DUMP_PROFILER},
     {HOTKEY_LOAD_FILE, TR_HOTKEY_LOAD_FILE},
     {HOTKEY_SAVE_FILE, TR_HOTKEY_SAVE_FILE},
     {HOTKEY_HEADER, TR_HOTKEY_HEADER_CITY},
     {HOTKEY_INCREASE_GAME_SPEED, TR_HOTKEY_INCREASE_GAME_SPEED},
     {HOTKEY_DECREASE_GAME_SPEED, TR_HOTKEY_DECREASE_GAME_SPEED},
     {HOTKEY_TOGGLE_PAUSE, TR_HOTKEY_TOGGLE_PAUSE},
+    {HOTKEY_TOGGLE_TURBO, TR_HOTKEY_TOGGLE_TURBO},
+    {HOTKEY_UNDO, TR_HOTKEY_UNDO},
+    {HOTKEY_REDO, TR_HOTKEY_REDO},
     {HOTKEY_CYCLE_LEGION, TR_HOTKEY_CYCLE_LEGION},
     {HOTKEY_ROTATE_MAP_LEFT, TR_HOTKEY_ROTATE_MAP_LEFT},
     {HOTKEY_ROTATE_MAP_RIGHT, TR_HOTKEY_ROTATE_MAP_RIGHT},
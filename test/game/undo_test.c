@@ -0,0 +1,249 @@
+#include "building/construction.h"
+#include "game/file.h"
+#include "game/game.h"
+#include "game/undo.h"
+#include "map/aqueduct.h"
+#include "map/building.h"
+#include "map/grid.h"
+#include "map/image.h"
+#include "map/terrain.h"
+#include "sav/run_ticks.h"
+
+#include <stdio.h>
+
+// More than the undo timeout of 500 ticks
+#define TICKS_TO_RUN 600
+
+#define NUM_ACTIONS 4
+#define AREA_WIDTH 8
+#define AREA_HEIGHT 5
+
+typedef struct {
+    int terrain[GRID_SIZE * GRID_SIZE];
+    int aqueduct[GRID_SIZE * GRID_SIZE];
+    int image[GRID_SIZE * GRID_SIZE];
+    int building[GRID_SIZE * GRID_SIZE];
+} map_state;
+
+// state before every action, after the last one, and the current state
+static map_state states[NUM_ACTIONS + 2];
+
+static int is_empty_area(int x, int y, int width, int height)
+{
+    for (int dy = 0; dy < height; dy++) {
+        for (int dx = 0; dx < width; dx++) {
+            if (map_terrain_get(map_grid_offset(x + dx, y + dy))) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+static int find_empty_area(int width, int height, int *x, int *y)
+{
+    int map_width, map_height;
+    map_grid_size(&map_width, &map_height);
+    for (int ty = 2; ty < map_height - height - 2; ty++) {
+        for (int tx = 2; tx < map_width - width - 2; tx++) {
+            if (is_empty_area(tx, ty, width, height)) {
+                *x = tx;
+                *y = ty;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int find_tree(int *x, int *y)
+{
+    int width, height;
+    map_grid_size(&width, &height);
+    for (int ty = 2; ty < height - 2; ty++) {
+        for (int tx = 2; tx < width - 2; tx++) {
+            if (map_terrain_get(map_grid_offset(tx, ty)) == TERRAIN_TREE) {
+                *x = tx;
+                *y = ty;
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void place_line(building_type type, int x_start, int y_start, int x_end, int y_end)
+{
+    building_construction_set_type(type);
+    building_construction_start(x_start, y_start, map_grid_offset(x_start, y_start));
+    building_construction_update(x_end, y_end, map_grid_offset(x_end, y_end));
+    building_construction_place();
+}
+
+static void place(building_type type, int x, int y)
+{
+    place_line(type, x, y, x, y);
+}
+
+static int check(const char *description, int actual, int expected)
+{
+    if (actual != expected) {
+        printf("FAILED %s: got %d, expected %d\n", description, actual, expected);
+        return 1;
+    }
+    printf("ok %s\n", description);
+    return 0;
+}
+
+static void save_map_state(map_state *state)
+{
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        state->terrain[i] = map_terrain_get(i);
+        state->aqueduct[i] = map_aqueduct_at(i);
+        state->image[i] = map_image_at(i);
+        state->building[i] = map_building_at(i);
+    }
+}
+
+static int count_differences(const char *grid, const int *actual, const int *expected, int report)
+{
+    int differences = 0;
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        if (actual[i] != expected[i]) {
+            if (report && !differences) {
+                printf("  %s of tile %d is %d, expected %d\n", grid, i, actual[i], expected[i]);
+            }
+            differences++;
+        }
+    }
+    return differences;
+}
+
+static int count_map_differences(const map_state *actual, const map_state *expected, int report)
+{
+    return count_differences("terrain", actual->terrain, expected->terrain, report) +
+        count_differences("aqueduct", actual->aqueduct, expected->aqueduct, report) +
+        count_differences("image", actual->image, expected->image, report) +
+        count_differences("building", actual->building, expected->building, report);
+}
+
+static int check_map(const char *description, const map_state *expected)
+{
+    map_state *current = &states[NUM_ACTIONS + 1];
+    save_map_state(current);
+    int differences = count_map_differences(current, expected, 1);
+    if (differences) {
+        printf("FAILED %s: %d tiles differ\n", description, differences);
+        return 1;
+    }
+    printf("ok %s\n", description);
+    return 0;
+}
+
+static int test_timeout(int x, int y)
+{
+    int errors = 0;
+
+    place(BUILDING_CLEAR_LAND, x, y);
+    errors += check("can undo after clearing land", game_can_undo(), 1);
+
+    // A bridge away from the water fails with "shore needed"
+    place(BUILDING_LOW_BRIDGE, x, y);
+    errors += check("can undo after a failed placement", game_can_undo(), 1);
+
+    building_construction_set_type(BUILDING_ROAD);
+    building_construction_start(x, y, map_grid_offset(x, y));
+    building_construction_cancel();
+    errors += check("can undo after a cancelled placement", game_can_undo(), 1);
+
+    run_ticks(TICKS_TO_RUN);
+    errors += check("can undo after the timeout", game_can_undo(), 0);
+
+    // The first action timed out, so only the new one can be undone
+    place(BUILDING_CLEAR_LAND, x, y);
+    game_undo_perform();
+    errors += check("can undo after undoing a later action", game_can_undo(), 0);
+    errors += check("can redo after undoing a later action", game_can_redo(), 1);
+
+    run_ticks(TICKS_TO_RUN);
+    errors += check("can redo after the timeout", game_can_redo(), 0);
+    return errors;
+}
+
+static void perform_action(int action, int x, int y, int tree_x, int tree_y)
+{
+    switch (action) {
+        case 0: place_line(BUILDING_ROAD, x, y, x + AREA_WIDTH - 1, y); break;
+        case 1: place_line(BUILDING_AQUEDUCT, x, y + 2, x + AREA_WIDTH - 1, y + 2); break;
+        case 2: place(BUILDING_PREFECTURE, x + 1, y + 4); break;
+        default: place(BUILDING_CLEAR_LAND, tree_x, tree_y); break;
+    }
+}
+
+static int test_undo_redo(int x, int y, int tree_x, int tree_y)
+{
+    char description[100];
+    int errors = 0;
+
+    for (int i = 0; i < NUM_ACTIONS; i++) {
+        save_map_state(&states[i]);
+        perform_action(i, x, y, tree_x, tree_y);
+        snprintf(description, sizeof(description), "can undo action %d", i + 1);
+        errors += check(description, game_can_undo(), 1);
+    }
+    save_map_state(&states[NUM_ACTIONS]);
+    for (int i = 0; i < NUM_ACTIONS; i++) {
+        snprintf(description, sizeof(description), "action %d changes the map", i + 1);
+        errors += check(description, count_map_differences(&states[i + 1], &states[i], 0) > 0, 1);
+    }
+
+    for (int i = NUM_ACTIONS - 1; i >= 0; i--) {
+        game_undo_perform();
+        snprintf(description, sizeof(description), "map after undoing action %d", i + 1);
+        errors += check_map(description, &states[i]);
+    }
+    errors += check("can undo after undoing all actions", game_can_undo(), 0);
+
+    for (int i = 0; i < NUM_ACTIONS; i++) {
+        game_redo_perform();
+        snprintf(description, sizeof(description), "map after redoing action %d", i + 1);
+        errors += check_map(description, &states[i + 1]);
+    }
+    errors += check("can redo after redoing all actions", game_can_redo(), 0);
+
+    // Redone actions can be undone again
+    game_undo_perform();
+    game_undo_perform();
+    errors += check_map("map after undoing redone actions", &states[NUM_ACTIONS - 2]);
+    game_redo_perform();
+    errors += check_map("map after redoing an action again", &states[NUM_ACTIONS - 1]);
+
+    // A new action replaces the ones that could be redone
+    perform_action(NUM_ACTIONS - 1, x, y, tree_x, tree_y);
+    errors += check("can redo after a new action", game_can_redo(), 0);
+    game_undo_perform();
+    errors += check_map("map after undoing the new action", &states[NUM_ACTIONS - 1]);
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        printf("Usage: undo_test <saved game>\n");
+        return 1;
+    }
+    if (!game_pre_init() || !game_init() || !game_file_load_saved_game(argv[1])) {
+        printf("Unable to load %s\n", argv[1]);
+        return 1;
+    }
+    int x, y, tree_x, tree_y;
+    if (!find_empty_area(AREA_WIDTH, AREA_HEIGHT, &x, &y) || !find_tree(&tree_x, &tree_y)) {
+        printf("No empty area or tree in %s\n", argv[1]);
+        return 1;
+    }
+    int errors = test_timeout(x, y);
+    errors += test_undo_redo(x, y, tree_x, tree_y);
+
+    game_exit();
+    return errors ? 1 : 0;
+}
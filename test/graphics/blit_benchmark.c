@@ -0,0 +1,230 @@
+#include "core/time.h"
+#include "graphics/blit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_RUN_LENGTH 70
+#define GUARD_PIXELS 8
+#define GUARD_COLOR 0x12345678
+
+#define DEFAULT_WIDTH 1920
+#define DEFAULT_ROWS 1080
+#define DEFAULT_REPEAT 10
+
+typedef enum {
+    KERNEL_COPY_TRANSPARENT,
+    KERNEL_SET_TRANSPARENT,
+    KERNEL_AND_TRANSPARENT,
+    KERNEL_BLEND_TRANSPARENT,
+    KERNEL_BLEND_ALPHA_TRANSPARENT,
+    KERNEL_FILL,
+    KERNEL_AND,
+    KERNEL_BLEND,
+    KERNEL_BLEND_ALPHA,
+    KERNEL_MAX
+} kernel_type;
+
+static const char *KERNEL_NAMES[KERNEL_MAX] = {
+    "copy_transparent", "set_transparent", "and_transparent", "blend_transparent",
+    "blend_alpha_transparent", "fill", "and", "blend", "blend_alpha"
+};
+
+static uint32_t random_state = 0x2545f491;
+
+static uint32_t next_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+// Sprite-like data: a quarter of the pixels are transparent and the alpha
+// values favour fully transparent and fully opaque pixels
+static color_t random_source_pixel(void)
+{
+    uint32_t r = next_random();
+    switch (r & 7) {
+        case 0:
+        case 1:
+            return COLOR_SG2_TRANSPARENT;
+        case 2:
+            return next_random() & 0x00ffffff;
+        case 3:
+        case 4:
+            return next_random() | 0xff000000;
+        default:
+            return next_random();
+    }
+}
+
+static void fill_random(color_t *src, color_t *dst, int num_pixels)
+{
+    for (int i = 0; i < num_pixels; i++) {
+        src[i] = random_source_pixel();
+        dst[i] = next_random();
+    }
+}
+
+static color_t random_color(void)
+{
+    // blend_alpha is never called with alpha 0 or 255
+    color_t alpha = 1 + next_random() % 254;
+    return (alpha << 24) | (next_random() & 0x00ffffff);
+}
+
+static void run_kernel(kernel_type kernel, color_t *dst, const color_t *src, int num_pixels, color_t color)
+{
+    switch (kernel) {
+        case KERNEL_COPY_TRANSPARENT:
+            blit_copy_transparent(dst, src, num_pixels);
+            break;
+        case KERNEL_SET_TRANSPARENT:
+            blit_set_transparent(dst, src, num_pixels, color);
+            break;
+        case KERNEL_AND_TRANSPARENT:
+            blit_and_transparent(dst, src, num_pixels, color);
+            break;
+        case KERNEL_BLEND_TRANSPARENT:
+            blit_blend_transparent(dst, src, num_pixels, color);
+            break;
+        case KERNEL_BLEND_ALPHA_TRANSPARENT:
+            blit_blend_alpha_transparent(dst, src, num_pixels, color);
+            break;
+        case KERNEL_FILL:
+            blit_fill(dst, num_pixels, color);
+            break;
+        case KERNEL_AND:
+            blit_and(dst, src, num_pixels, color);
+            break;
+        case KERNEL_BLEND:
+            blit_blend(dst, num_pixels, color);
+            break;
+        case KERNEL_BLEND_ALPHA:
+            blit_blend_alpha(dst, num_pixels, color);
+            break;
+        default:
+            break;
+    }
+}
+
+static int verify_implementation(blit_implementation implementation)
+{
+    color_t src[MAX_RUN_LENGTH + 4];
+    color_t original[MAX_RUN_LENGTH + 4];
+    color_t expected[MAX_RUN_LENGTH + 4 + GUARD_PIXELS];
+    color_t actual[MAX_RUN_LENGTH + 4 + GUARD_PIXELS];
+    int errors = 0;
+
+    for (int kernel = 0; kernel < KERNEL_MAX; kernel++) {
+        for (int length = 0; length <= MAX_RUN_LENGTH; length++) {
+            // unaligned start offsets exercise the unaligned loads and stores
+            for (int offset = 0; offset < 4; offset++) {
+                color_t color = random_color();
+                fill_random(src, original, MAX_RUN_LENGTH + 4);
+                for (int i = 0; i < MAX_RUN_LENGTH + 4 + GUARD_PIXELS; i++) {
+                    expected[i] = actual[i] = i < MAX_RUN_LENGTH + 4 ? original[i] : GUARD_COLOR;
+                }
+                blit_use(BLIT_SCALAR);
+                run_kernel(kernel, &expected[offset], &src[offset], length, color);
+                blit_use(implementation);
+                run_kernel(kernel, &actual[offset], &src[offset], length, color);
+                if (memcmp(expected, actual, sizeof(expected)) != 0) {
+                    if (errors < 10) {
+                        printf("MISMATCH %s %s length %d offset %d\n", blit_implementation_name(implementation),
+                            KERNEL_NAMES[kernel], length, offset);
+                    }
+                    errors++;
+                }
+            }
+        }
+    }
+    return errors;
+}
+
+static double benchmark_kernel(kernel_type kernel, color_t *dst, const color_t *src,
+                               int width, int rows, int repeat)
+{
+    color_t color = random_color();
+    time_micros start = time_get_micros();
+    for (int r = 0; r < repeat; r++) {
+        for (int y = 0; y < rows; y++) {
+            run_kernel(kernel, &dst[y * width], &src[y * width], width, color);
+        }
+    }
+    time_micros elapsed = time_get_micros() - start;
+    return elapsed ? (double) width * rows * repeat / elapsed : 0.0;
+}
+
+static void usage(void)
+{
+    printf("Usage: blit_benchmark [--verify] [--width N] [--rows N] [--repeat N]\n");
+    printf("Checks that every blit implementation matches the scalar one, then measures megapixels per second\n");
+}
+
+int main(int argc, char **argv)
+{
+    int verify_only = 0;
+    int width = DEFAULT_WIDTH;
+    int rows = DEFAULT_ROWS;
+    int repeat = DEFAULT_REPEAT;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--verify") == 0) {
+            verify_only = 1;
+        } else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rows") == 0 && i + 1 < argc) {
+            rows = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (width <= 0 || rows <= 0 || repeat <= 0) {
+        usage();
+        return 1;
+    }
+
+    int errors = 0;
+    for (int i = BLIT_SCALAR + 1; i < BLIT_MAX; i++) {
+        if (blit_is_supported(i)) {
+            int result = verify_implementation(i);
+            printf("verify %s: %s\n", blit_implementation_name(i), result ? "FAILED" : "ok");
+            errors += result;
+        }
+    }
+    if (errors || verify_only) {
+        return errors ? 1 : 0;
+    }
+
+    color_t *src = (color_t *) malloc((size_t) width * rows * sizeof(color_t));
+    color_t *dst = (color_t *) malloc((size_t) width * rows * sizeof(color_t));
+    if (!src || !dst) {
+        printf("Out of memory\n");
+        return 1;
+    }
+    fill_random(src, dst, width * rows);
+
+    double scalar_speed[KERNEL_MAX];
+    printf("%-24s %-8s %10s %8s\n", "kernel", "impl", "Mpixel/s", "speedup");
+    for (int i = BLIT_SCALAR; i < BLIT_MAX; i++) {
+        if (!blit_use(i)) {
+            continue;
+        }
+        for (int kernel = 0; kernel < KERNEL_MAX; kernel++) {
+            double speed = benchmark_kernel(kernel, dst, src, width, rows, repeat);
+            if (i == BLIT_SCALAR) {
+                scalar_speed[kernel] = speed;
+            }
+            printf("%-24s %-8s %10.1f %7.2fx\n", KERNEL_NAMES[kernel], blit_implementation_name(i), speed,
+                scalar_speed[kernel] ? speed / scalar_speed[kernel] : 0.0);
+        }
+    }
+    free(src);
+    free(dst);
+    return 0;
+}
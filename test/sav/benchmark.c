@@ -0,0 +1,259 @@
+#include "core/backtrace.h"
+#include "core/file.h"
+#include "core/time.h"
+#include "game/file.h"
+#include "game/game.h"
+#include "game/profiler.h"
+#include "game/settings.h"
+#include "game/snapshot.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_TICKS 2000
+#define SNAPSHOT_REPEATS 10
+
+typedef enum {
+    FORMAT_CSV,
+    FORMAT_JSON
+} output_format;
+
+typedef struct {
+    const char *filename;
+    int ticks;
+    time_micros total_micros;
+    time_micros p50;
+    time_micros p90;
+    time_micros p99;
+    time_micros max;
+    time_micros checkpoint;
+    time_micros restore;
+    profiler_stats slots[PROFILER_DAY + 1];
+} benchmark_result;
+
+static time_millis game_millis;
+
+static void handler(int sig)
+{
+    fprintf(stderr, "Oops, crashed with signal %d :(", sig);
+    backtrace_print();
+    exit(1);
+}
+
+static int compare_micros(const void *va, const void *vb)
+{
+    time_micros a = *(const time_micros *) va;
+    time_micros b = *(const time_micros *) vb;
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static time_micros percentile(const time_micros *sorted, int count, int pct)
+{
+    if (count <= 0) {
+        return 0;
+    }
+    int index = (count * pct + 99) / 100 - 1;
+    if (index < 0) {
+        index = 0;
+    }
+    return sorted[index];
+}
+
+static int measure_snapshots(benchmark_result *result)
+{
+    // The first snapshot allocates the memory for all of them
+    if (!game_snapshot_take()) {
+        return 0;
+    }
+    time_micros checkpoint = 0;
+    time_micros restore = 0;
+    for (int i = 0; i < SNAPSHOT_REPEATS; i++) {
+        time_micros start = time_get_micros();
+        game_snapshot_take();
+        time_micros taken = time_get_micros();
+        game_snapshot_restore(0);
+        restore += time_get_micros() - taken;
+        checkpoint += taken - start;
+    }
+    result->checkpoint = checkpoint / SNAPSHOT_REPEATS;
+    result->restore = restore / SNAPSHOT_REPEATS;
+    return 1;
+}
+
+static int run_benchmark(const char *saved_game, int ticks, benchmark_result *result)
+{
+    if (!game_file_load_saved_game(saved_game)) {
+        fprintf(stderr, "Unable to load saved game %s\n", saved_game);
+        return 0;
+    }
+    time_micros *latencies = (time_micros *) malloc(ticks * sizeof(time_micros));
+    if (!latencies) {
+        return 0;
+    }
+    setting_reset_speeds(100, setting_scroll_speed());
+    profiler_set_enabled(1);
+
+    time_micros start = time_get_micros();
+    for (int i = 0; i < ticks; i++) {
+        // Each game_run() call executes exactly one tick at 100% speed
+        game_millis += 2;
+        time_set_millis(game_millis);
+        time_micros tick_start = time_get_micros();
+        game_run();
+        latencies[i] = time_get_micros() - tick_start;
+    }
+    result->total_micros = time_get_micros() - start;
+
+    profiler_set_enabled(0);
+    for (int i = 0; i <= PROFILER_DAY; i++) {
+        result->slots[i] = *profiler_get_stats(i);
+    }
+    qsort(latencies, ticks, sizeof(time_micros), compare_micros);
+    result->filename = saved_game;
+    result->ticks = ticks;
+    result->p50 = percentile(latencies, ticks, 50);
+    result->p90 = percentile(latencies, ticks, 90);
+    result->p99 = percentile(latencies, ticks, 99);
+    result->max = latencies[ticks - 1];
+    free(latencies);
+    if (!measure_snapshots(result)) {
+        fprintf(stderr, "Unable to take a snapshot of %s\n", saved_game);
+        return 0;
+    }
+    return 1;
+}
+
+static double ticks_per_second(const benchmark_result *r)
+{
+    return r->total_micros ? r->ticks * 1000000.0 / r->total_micros : 0.0;
+}
+
+static void write_csv(FILE *fp, const benchmark_result *results, int num_results)
+{
+    fprintf(fp, "file,ticks,total_us,ticks_per_second,p50_us,p90_us,p99_us,max_us");
+    for (int s = 1; s < PROFILER_TICK_SLOTS; s++) {
+        fprintf(fp, ",tick_%d_us", s);
+    }
+    fprintf(fp, ",figures_us,day_us,checkpoint_us,restore_us\n");
+    for (int i = 0; i < num_results; i++) {
+        const benchmark_result *r = &results[i];
+        fprintf(fp, "%s,%d,%llu,%.1f,%llu,%llu,%llu,%llu", r->filename, r->ticks,
+            (unsigned long long) r->total_micros, ticks_per_second(r),
+            (unsigned long long) r->p50, (unsigned long long) r->p90,
+            (unsigned long long) r->p99, (unsigned long long) r->max);
+        for (int s = 1; s <= PROFILER_DAY; s++) {
+            fprintf(fp, ",%llu", (unsigned long long) r->slots[s].total_micros);
+        }
+        fprintf(fp, ",%llu,%llu\n", (unsigned long long) r->checkpoint, (unsigned long long) r->restore);
+    }
+}
+
+static void write_json_slot(FILE *fp, const char *name, const profiler_stats *slot, int last)
+{
+    fprintf(fp, "        \"%s\": {\"calls\": %d, \"total_us\": %llu, \"max_us\": %llu}%s\n",
+        name, slot->calls, (unsigned long long) slot->total_micros,
+        (unsigned long long) slot->max_micros, last ? "" : ",");
+}
+
+static void write_json(FILE *fp, const benchmark_result *results, int num_results)
+{
+    fprintf(fp, "[\n");
+    for (int i = 0; i < num_results; i++) {
+        const benchmark_result *r = &results[i];
+        fprintf(fp, "  {\n");
+        fprintf(fp, "    \"file\": \"%s\",\n", r->filename);
+        fprintf(fp, "    \"ticks\": %d,\n", r->ticks);
+        fprintf(fp, "    \"total_us\": %llu,\n", (unsigned long long) r->total_micros);
+        fprintf(fp, "    \"ticks_per_second\": %.1f,\n", ticks_per_second(r));
+        fprintf(fp, "    \"latency_us\": {\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"max\": %llu},\n",
+            (unsigned long long) r->p50, (unsigned long long) r->p90,
+            (unsigned long long) r->p99, (unsigned long long) r->max);
+        fprintf(fp, "    \"snapshot_us\": {\"checkpoint\": %llu, \"restore\": %llu},\n",
+            (unsigned long long) r->checkpoint, (unsigned long long) r->restore);
+        fprintf(fp, "    \"slots\": {\n");
+        char name[16];
+        for (int s = 1; s < PROFILER_TICK_SLOTS; s++) {
+            snprintf(name, sizeof(name), "tick_%d", s);
+            write_json_slot(fp, name, &r->slots[s], 0);
+        }
+        write_json_slot(fp, "figures", &r->slots[PROFILER_FIGURES], 0);
+        write_json_slot(fp, "day", &r->slots[PROFILER_DAY], 1);
+        fprintf(fp, "    }\n");
+        fprintf(fp, "  }%s\n", i < num_results - 1 ? "," : "");
+    }
+    fprintf(fp, "]\n");
+}
+
+static void usage(void)
+{
+    printf("Usage: benchmark [--ticks N] [--format csv|json] [--output FILE] FILE.sav...\n");
+}
+
+int main(int argc, char **argv)
+{
+    int ticks = DEFAULT_TICKS;
+    output_format format = FORMAT_CSV;
+    const char *output = 0;
+    int first_file = argc;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = strcmp(argv[++i], "json") == 0 ? FORMAT_JSON : FORMAT_CSV;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage();
+            return -1;
+        } else {
+            first_file = i;
+            break;
+        }
+    }
+    int num_files = argc - first_file;
+    if (num_files <= 0 || ticks <= 0) {
+        usage();
+        return -1;
+    }
+    signal(SIGSEGV, handler);
+
+    if (!game_pre_init()) {
+        printf("Unable to run Game_preInit\n");
+        return 1;
+    }
+    if (!game_init()) {
+        printf("Unable to run Game_init\n");
+        return 2;
+    }
+
+    benchmark_result *results = (benchmark_result *) calloc(num_files, sizeof(benchmark_result));
+    int num_results = 0;
+    for (int i = 0; i < num_files; i++) {
+        const char *saved_game = argv[first_file + i];
+        fprintf(stderr, "Benchmarking %s for %d ticks\n", saved_game, ticks);
+        if (run_benchmark(saved_game, ticks, &results[num_results])) {
+            num_results++;
+        }
+    }
+    game_exit();
+
+    FILE *fp = output ? file_open(output, "w") : stdout;
+    if (!fp) {
+        printf("Unable to write to %s\n", output);
+        free(results);
+        return 4;
+    }
+    if (format == FORMAT_JSON) {
+        write_json(fp, results, num_results);
+    } else {
+        write_csv(fp, results, num_results);
+    }
+    if (output) {
+        file_close(fp);
+    }
+    free(results);
+
+    return num_results == num_files ? 0 : 3;
+}
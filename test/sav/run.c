@@ -1,8 +1,7 @@
 #include "core/backtrace.h"
-#include "core/time.h"
 #include "game/file.h"
 #include "game/game.h"
-#include "game/settings.h"
+#include "game/snapshot.h"
 
 #ifdef _MSC_VER
 #include <direct.h>
@@ -15,6 +14,7 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include "run_ticks.h"
 #include "sav_compare.h"
 
 static void handler(int sig)
@@ -24,17 +24,8 @@ static void handler(int sig)
     exit(1);
 }
 
-static void run_ticks(int ticks)
-{
-    setting_reset_speeds(100, setting_scroll_speed());
-    time_set_millis(0);
-    for (int i = 1; i <= ticks; i++) {
-        time_set_millis(2 * i);
-        game_run();
-    }
-}
-
-static int run_autopilot(const char *input_saved_game, const char *output_saved_game, int ticks_to_run)
+static int run_autopilot(const char *input_saved_game, const char *output_saved_game, int ticks_to_run,
+                         int ticks_to_rewind)
 {
     printf("Running autopilot: %s --> %s in %d ticks\n", input_saved_game, output_saved_game, ticks_to_run);
     signal(SIGSEGV, handler);
@@ -58,6 +49,16 @@ static int run_autopilot(const char *input_saved_game, const char *output_saved_
         }
         return 3;
     }
+    if (ticks_to_rewind) {
+        // The game has to end up exactly the same after running some ticks and rewinding them
+        printf("Running %d ticks and rewinding them\n", ticks_to_rewind);
+        if (!game_snapshot_take()) {
+            printf("Unable to take snapshot\n");
+            return 4;
+        }
+        run_ticks(ticks_to_rewind);
+        game_snapshot_restore(0);
+    }
     run_ticks(ticks_to_run);
     printf("Saving game to %s\n", output_saved_game);
     game_file_write_saved_game(output_saved_game);
@@ -70,7 +71,7 @@ static int run_autopilot(const char *input_saved_game, const char *output_saved_
 
 int main(int argc, char **argv)
 {
-    if (argc != 5) {
+    if (argc != 5 && argc != 6) {
         printf("Incorrect number of arguments (%d)\n", argc);
         return -1;
     }
@@ -78,7 +79,8 @@ int main(int argc, char **argv)
     const char *output = argv[2];
     const char *expected = argv[3];
     int ticks = atoi(argv[4]);
-    if (run_autopilot(input, output, ticks) == 0) {
+    int ticks_to_rewind = argc == 6 ? atoi(argv[5]) : 0;
+    if (run_autopilot(input, output, ticks, ticks_to_rewind) == 0) {
         return compare_files(expected, output);
     } else {
         return 1;
@@ -0,0 +1,15 @@
+#include "run_ticks.h"
+
+#include "core/time.h"
+#include "game/game.h"
+#include "game/settings.h"
+
+void run_ticks(int ticks)
+{
+    setting_reset_speeds(100, setting_scroll_speed());
+    time_set_millis(0);
+    for (int i = 1; i <= ticks; i++) {
+        time_set_millis(2 * i);
+        game_run();
+    }
+}
@@ -0,0 +1,10 @@
+#ifndef RUN_TICKS_H
+#define RUN_TICKS_H
+
+/**
+ * Runs the game for a number of ticks at 100% speed, with a fake clock
+ * @param ticks Number of ticks to run
+ */
+void run_ticks(int ticks);
+
+#endif // RUN_TICKS_H
@@ -0,0 +1,4 @@
+#include "widget/city_without_overlay.h"
+
+void city_without_overlay_invalidate_cache(void)
+{}
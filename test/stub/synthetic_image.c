@@ -0,0 +1,183 @@
+#include "core/image.h"
+
+#include <stdlib.h>
+
+// Generated images, so that the city can be drawn without the game data.
+// Even ids are one-tile isometric images with a top of varying height: the footprint followed by
+// the compressed top. Odd ids are uncompressed sprites with transparent pixels.
+
+#define NUM_IMAGES 10001
+#define FOOTPRINT_PIXELS 900
+#define MIN_HEIGHT 46
+#define MAX_EXTRA_HEIGHT 120
+#define MAX_SPRITE_OFFSET 3
+
+static image main_images[NUM_IMAGES];
+static color_t *main_data[NUM_IMAGES];
+static image enemy_images[NUM_IMAGES];
+static color_t *enemy_data[NUM_IMAGES];
+
+static color_t pixel_color(int id, int x, int y)
+{
+    return 0xff000000 | (((id * 2654435761u) ^ (x * 40503u) ^ (y * 69069u)) & 0xffffff);
+}
+
+static int is_isometric(int id)
+{
+    return id % 2 == 0;
+}
+
+static void init_image(image *img, int id)
+{
+    img->width = 58;
+    img->height = MIN_HEIGHT + (id * 37) % MAX_EXTRA_HEIGHT;
+    img->num_animation_sprites = id % 11 == 0 ? 4 : 0;
+    img->sprite_offset_x = id % 5 - 2;
+    img->sprite_offset_y = id % (2 * MAX_SPRITE_OFFSET + 1) - MAX_SPRITE_OFFSET;
+    img->animation_speed_id = 1;
+    if (is_isometric(id)) {
+        img->draw.type = IMAGE_TYPE_ISOMETRIC;
+        img->draw.has_compressed_part = 1;
+        img->draw.uncompressed_length = FOOTPRINT_PIXELS;
+    } else {
+        img->draw.type = IMAGE_TYPE_WITH_TRANSPARENCY;
+    }
+}
+
+// Rows of the top start with a transparent run of varying length
+static color_t *create_compressed_rows(color_t *dst, int id, int width, int rows)
+{
+    for (int y = 0; y < rows; y++) {
+        int skip = (y + id) % 20;
+        *dst++ = 255;
+        *dst++ = skip;
+        *dst++ = width - skip;
+        for (int x = skip; x < width; x++) {
+            *dst++ = pixel_color(id, x, y);
+        }
+    }
+    return dst;
+}
+
+static const color_t *create_main_data(int id)
+{
+    const image *img = image_get(id);
+    color_t *data;
+    if (is_isometric(id)) {
+        data = (color_t *) malloc((FOOTPRINT_PIXELS + (img->width + 3) * img->height) * sizeof(color_t));
+        if (!data) {
+            return 0;
+        }
+        for (int i = 0; i < FOOTPRINT_PIXELS; i++) {
+            data[i] = pixel_color(id, i, -1);
+        }
+        create_compressed_rows(&data[FOOTPRINT_PIXELS], id, img->width, img->height - 16);
+    } else {
+        data = (color_t *) malloc(img->width * img->height * sizeof(color_t));
+        if (!data) {
+            return 0;
+        }
+        for (int y = 0; y < img->height; y++) {
+            for (int x = 0; x < img->width; x++) {
+                data[y * img->width + x] = (x + y + id) % 7 ? pixel_color(id, x, y) : COLOR_SG2_TRANSPARENT;
+            }
+        }
+    }
+    main_data[id] = data;
+    return data;
+}
+
+static const color_t *create_enemy_data(int id)
+{
+    const image *img = image_get_enemy(id);
+    color_t *data = (color_t *) malloc((img->width + 3) * img->height * sizeof(color_t));
+    if (!data) {
+        return 0;
+    }
+    create_compressed_rows(data, id, img->width, img->height);
+    enemy_data[id] = data;
+    return data;
+}
+
+int image_init(void)
+{
+    for (int i = 0; i < NUM_IMAGES; i++) {
+        init_image(&main_images[i], i);
+        init_image(&enemy_images[i], 2 * i + 1);
+        enemy_images[i].draw.is_fully_compressed = 1;
+    }
+    return 1;
+}
+
+int image_load_climate(int climate_id, int is_editor, int force_reload)
+{
+    return 1;
+}
+
+int image_load_fonts(encoding_type encoding)
+{
+    return 1;
+}
+
+int image_load_enemy(int enemy_id)
+{
+    return 1;
+}
+
+int image_group(int group)
+{
+    return group * 30;
+}
+
+const image *image_get(int id)
+{
+    return id >= 0 && id < NUM_IMAGES ? &main_images[id] : 0;
+}
+
+const image *image_letter(int letter_id)
+{
+    return 0;
+}
+
+const image *image_get_enemy(int id)
+{
+    return id >= 0 && id < NUM_IMAGES ? &enemy_images[id] : 0;
+}
+
+const color_t *image_data(int id)
+{
+    if (id < 0 || id >= NUM_IMAGES) {
+        return 0;
+    }
+    return main_data[id] ? main_data[id] : create_main_data(id);
+}
+
+void image_begin_parallel_use(void)
+{}
+
+void image_end_parallel_use(void)
+{}
+
+int image_max_city_sprite_extent(void)
+{
+    return MIN_HEIGHT + MAX_EXTRA_HEIGHT + MAX_SPRITE_OFFSET;
+}
+
+void image_get_external_cache_stats(int *hits, int *misses)
+{
+    *hits = 0;
+    *misses = 0;
+}
+
+const color_t *image_data_letter(int letter_id)
+{
+    return 0;
+}
+
+const color_t *image_data_enemy(int id)
+{
+    if (id < 0 || id >= NUM_IMAGES) {
+        return 0;
+    }
+    return enemy_data[id] ? enemy_data[id] : create_enemy_data(id);
+}
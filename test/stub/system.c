@@ -0,0 +1,35 @@
+#include "game/system.h"
+
+int system_parallel_worker_count(void)
+{
+    return 1;
+}
+
+void system_run_parallel(system_parallel_job job, void *userdata, int num_jobs)
+{
+    for (int i = 0; i < num_jobs; i++) {
+        job(userdata, i, 0);
+    }
+}
+
+int system_start_background_job(system_background_job job, void *userdata)
+{
+    job(userdata);
+    return 0;
+}
+
+int system_background_job_done(int id)
+{
+    return 1;
+}
+
+system_mutex *system_mutex_create(void)
+{
+    return 0;
+}
+
+void system_mutex_lock(system_mutex *mutex)
+{}
+
+void system_mutex_unlock(system_mutex *mutex)
+{}
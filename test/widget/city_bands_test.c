@@ -0,0 +1,147 @@
+#include "city/view.h"
+#include "core/config.h"
+#include "game/file.h"
+#include "game/game.h"
+#include "game/system.h"
+#include "graphics/graphics.h"
+#include "graphics/text.h"
+#include "map/grid.h"
+#include "map/point.h"
+#include "widget/city_without_overlay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCREEN_WIDTH 1024
+#define SCREEN_HEIGHT 768
+#define NUM_WORKERS 4
+
+// Jobs run one after another with the last band first, so a band that depends on an earlier one fails
+int system_parallel_worker_count(void)
+{
+    return NUM_WORKERS;
+}
+
+void system_run_parallel(system_parallel_job job, void *userdata, int num_jobs)
+{
+    for (int i = num_jobs - 1; i >= 0; i--) {
+        job(userdata, i, i % NUM_WORKERS);
+    }
+}
+
+int system_start_background_job(system_background_job job, void *userdata)
+{
+    job(userdata);
+    return 0;
+}
+
+int system_background_job_done(int id)
+{
+    return 1;
+}
+
+system_mutex *system_mutex_create(void)
+{
+    return 0;
+}
+
+void system_mutex_lock(system_mutex *mutex)
+{}
+
+void system_mutex_unlock(system_mutex *mutex)
+{}
+
+// Used by the parts of the drawing code that do not draw the city
+int screen_width(void)
+{
+    return SCREEN_WIDTH;
+}
+
+int screen_height(void)
+{
+    return SCREEN_HEIGHT;
+}
+
+int screen_dialog_offset_x(void)
+{
+    return 0;
+}
+
+int screen_dialog_offset_y(void)
+{
+    return 0;
+}
+
+int text_draw_number_colored(int value, char prefix, const char *postfix, int x_offset, int y_offset, font_t font, color_t color)
+{
+    return 0;
+}
+
+static void draw_city(int num_bands, color_t *pixels)
+{
+    map_tile tile = {0, 0, 0};
+    int x, y, width, height;
+    city_view_get_scaled_viewport(&x, &y, &width, &height);
+    config_set(CONFIG_UI_CITY_RENDER_THREADS, num_bands);
+    graphics_clear_screens();
+    graphics_set_clip_rectangle(x, y, width, height);
+    city_without_overlay_draw(0, 0, &tile);
+    memcpy(pixels, graphics_canvas(CANVAS_UI), SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(color_t));
+}
+
+static int compare_view(int x, int y, color_t *expected, color_t *actual)
+{
+    city_view_go_to_grid_offset(map_grid_offset(x, y));
+    draw_city(1, expected);
+    int errors = 0;
+    for (int num_bands = 2; num_bands <= NUM_WORKERS; num_bands++) {
+        draw_city(num_bands, actual);
+        int different_pixels = 0;
+        for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
+            if (expected[i] != actual[i]) {
+                different_pixels++;
+            }
+        }
+        if (different_pixels) {
+            printf("FAILED view at (%d, %d) in %d bands: %d pixels differ\n", x, y, num_bands, different_pixels);
+            errors++;
+        } else {
+            printf("ok view at (%d, %d) in %d bands\n", x, y, num_bands);
+        }
+    }
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        printf("Usage: city_bands_test <saved game>\n");
+        return 1;
+    }
+    if (!game_pre_init() || !game_init() || !game_file_load_saved_game(argv[1])) {
+        printf("Unable to load %s\n", argv[1]);
+        return 1;
+    }
+    color_t *expected = (color_t *) malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(color_t));
+    color_t *actual = (color_t *) malloc(SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(color_t));
+    if (!expected || !actual) {
+        printf("Out of memory\n");
+        return 1;
+    }
+    config_set(CONFIG_UI_ZOOM, 0);
+    graphics_init_canvas(SCREEN_WIDTH, SCREEN_HEIGHT);
+    city_view_set_viewport(SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    int width, height;
+    map_grid_size(&width, &height);
+    int errors = 0;
+    errors += compare_view(width / 2, height / 2, expected, actual);
+    errors += compare_view(width / 4, height / 4, expected, actual);
+    errors += compare_view(3 * width / 4, 3 * height / 4, expected, actual);
+
+    free(expected);
+    free(actual);
+    game_exit();
+    return errors ? 1 : 0;
+}